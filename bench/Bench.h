@@ -0,0 +1,55 @@
+#pragma once
+#include "core/Random.h"  // SplitMix64, for the suites' random streams
+
+#include <chrono>
+
+namespace world
+{
+    class TileVolume;
+    struct TilePoint;
+}
+
+// Headless benchmarks for the SDL-free engine code (world generation etc.).
+// Built only with -DDUNGEONCORE_BUILD_BENCH=ON; run `DungeonBench [name...]`.
+namespace bench
+{
+    // Best wall time of `reps` runs of fn(), in milliseconds
+    template <class Fn>
+    double BestMs(int reps, Fn&& fn)
+    {
+        double best = 1e300;
+        for (int i = 0; i < reps; ++i)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            fn();
+            const auto t1 = std::chrono::steady_clock::now();
+            const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+
+    // Rooms on a 32-tile grid joined by corridors, dug into `level` of an
+    // n x n volume; returns the Core tile in the middle room. Shared by the
+    // paths and flow suites (BenchPaths.cpp).
+    world::TilePoint DigDungeon(world::TileVolume& volume, int n, int level);
+
+    void Noise();
+    void World();
+    void Erosion();
+    void Climate();
+    void Hydrology();
+    void NoiseGraph();
+    void History();
+    void HistoryData();
+    void Templates();
+    void Tags();
+    void Sites();
+    void Territory();
+    void Tiles();
+    void Paths();
+    void Flow();
+    void Spatial();
+    void Clock();
+}
@@ -0,0 +1,225 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/Biome.h"
+#include "world/Noise.h"
+#include "world/NoiseKernels.h"
+#include "world/WorldGen.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+    constexpr int CHANNELS = 4;
+
+    // The four fields GenerateWorld evaluates together
+    void WorldChannels(world::NoiseParams (&p)[CHANNELS])
+    {
+        p[0] = world::ElevationParams(SEED);
+        p[1] = world::TemperatureParams(SEED);
+        p[2] = world::MoistureParams(SEED);
+        p[3] = world::VolatilityParams(SEED);
+    }
+
+    // One row-kernel pass per field against one multi-channel pass, per kernel
+    void FusedKernels()
+    {
+        using namespace world::detail;
+
+        world::NoiseParams params[CHANNELS];
+        WorldChannels(params);
+
+        std::vector<std::vector<int>> perms;
+        FbmSetup setups[CHANNELS];
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            std::vector<int> perm(512);
+            for (int i = 0; i < 512; ++i)
+                perm[i] = ((i & 255) * (2 * c + 167) + 13 * c) & 255;
+            perms.push_back(perm);
+
+            FbmSetup& s = setups[c];
+            s.perm = perms.back().data();
+            s.baseScale = params[c].scale;
+            s.octaves = params[c].octaves;
+            s.persistence = params[c].persistence;
+            s.lacunarity = params[c].lacunarity;
+            PrepareOctaves(s);
+        }
+
+        MultiFbmSetup m;
+        PrepareMultiFbm(setups, CHANNELS, m);
+
+        const int n = 768;
+        const size_t cells = static_cast<size_t>(n) * n;
+        std::vector<float> separate(cells * CHANNELS), fused(cells * CHANNELS);
+
+        std::printf("Fused fBm, %dx%d, %d fields, %d octaves on %d lattice layers (1 thread)\n",
+            n, n, CHANNELS, m.terms, m.layers);
+
+        for (const FbmKernel* kernel : { &ScalarFbmKernel(), &ActiveFbmKernel() })
+        {
+            const FbmKernel& k = *kernel;
+
+            const double separateMs = bench::BestMs(3, [&]
+            {
+                for (int c = 0; c < CHANNELS; ++c)
+                {
+                    for (int y = 0; y < n; ++y)
+                        k.row(setups[c], 0, y, n, separate.data() + c * cells + static_cast<size_t>(y) * n);
+                }
+            });
+
+            const double fusedMs = bench::BestMs(3, [&]
+            {
+                float* out[CHANNELS];
+                for (int y = 0; y < n; ++y)
+                {
+                    for (int c = 0; c < CHANNELS; ++c)
+                        out[c] = fused.data() + c * cells + static_cast<size_t>(y) * n;
+
+                    k.multiRow(m, 0, y, n, out);
+                }
+            });
+
+            std::printf("  %-8s separate %7.2f ms, fused %7.2f ms  x%.2f%s\n", k.name, separateMs, fusedMs,
+                separateMs / fusedMs, (separate == fused) ? "  bit-identical" : "  [OUTPUT DIFFERS]");
+        }
+    }
+
+    // The public entry points on the whole pool, as world generation calls them
+    void FusedWorldFields(ThreadPool& pool)
+    {
+        world::NoiseParams params[CHANNELS];
+        WorldChannels(params);
+
+        std::printf("World fields through the pool (%d threads)\n", pool.ThreadCount());
+        for (int n : { 768, 2048 })
+        {
+            const size_t cells = static_cast<size_t>(n) * n;
+            std::vector<float> separate(cells * CHANNELS), fused(cells * CHANNELS);
+
+            const double separateMs = bench::BestMs(3, [&]
+            {
+                for (int c = 0; c < CHANNELS; ++c)
+                    world::PerlinFbm2DRegion(separate.data() + c * cells, n, 0, 0, n, n, params[c], pool);
+            });
+
+            const double fusedMs = bench::BestMs(3, [&]
+            {
+                float* const out[CHANNELS] = {
+                    fused.data(), fused.data() + cells, fused.data() + 2 * cells, fused.data() + 3 * cells };
+                world::PerlinFbm2DMulti(out, params, CHANNELS, n, n, pool);
+            });
+
+            std::printf("  %4dx%-4d PerlinFbm2D x%d %7.2f ms, PerlinFbm2DMulti %7.2f ms  x%.2f%s\n", n, n, CHANNELS,
+                separateMs, fusedMs, separateMs / fusedMs, (separate == fused) ? "  bit-identical" : "  [OUTPUT DIFFERS]");
+        }
+    }
+
+    // The table alternative to the per-pixel rule: bands x bins x bins
+    // biomes sampled from BiomeRule at bin centres, one read per pixel
+    void ClassifyTable(const float* elevation, const float* temperature, const float* moisture, size_t count,
+        const world::BiomeClimate& c, uint8_t* out)
+    {
+        constexpr int BINS = world::BiomeClimateBins;
+        static const std::vector<uint8_t> table = []
+        {
+            std::vector<uint8_t> t(static_cast<size_t>(world::BiomeElevationBands) * BINS * BINS);
+            for (int band = 0; band < world::BiomeElevationBands; ++band)
+            {
+                for (int ti = 0; ti < BINS; ++ti)
+                {
+                    for (int mi = 0; mi < BINS; ++mi)
+                    {
+                        t[(static_cast<size_t>(band) * BINS + ti) * BINS + mi] = static_cast<uint8_t>(world::BiomeRule(
+                            band, (static_cast<float>(ti) + 0.5f) / BINS, (static_cast<float>(mi) + 0.5f) / BINS));
+                    }
+                }
+            }
+            return t;
+        }();
+
+        // Values at or above 1 land in the last bin: BINS - 0.5 truncates to BINS - 1
+        const auto bin = [](float v) { return static_cast<int>(std::clamp(v * BINS, 0.0f, BINS - 0.5f)); };
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float e = elevation[i];
+            const int band = static_cast<int>(e >= c.shelfLevel) + static_cast<int>(e >= c.seaLevel)
+                + static_cast<int>(e >= c.mountainLevel);
+
+            const float above = std::max(e - c.seaLevel, 0.0f);
+            const float t = 0.5f + temperature[i] * c.contrast - above * c.lapseRate;
+            const float m = 0.5f + moisture[i] * c.contrast;
+
+            out[i] = table[(static_cast<size_t>(band) * BINS + bin(t)) * BINS + bin(m)];
+        }
+    }
+
+    void Biomes(ThreadPool& pool)
+    {
+        const int n = 2048;
+        const size_t cells = static_cast<size_t>(n) * n;
+
+        world::NoiseParams params[CHANNELS];
+        WorldChannels(params);
+
+        std::vector<float> fields(cells * CHANNELS);
+        float* const out[CHANNELS] = {
+            fields.data(), fields.data() + cells, fields.data() + 2 * cells, fields.data() + 3 * cells };
+        world::PerlinFbm2DMulti(out, params, CHANNELS, n, n, pool);
+
+        const std::vector<float> elevation(fields.begin(), fields.begin() + static_cast<std::ptrdiff_t>(cells));
+        const world::BiomeClimate climate = world::WorldClimate(elevation);
+
+        std::vector<uint8_t> rule(cells), lut(cells);
+        const double ruleMs = bench::BestMs(3, [&]
+        {
+            world::ClassifyBiomes(out[0], out[1], out[2], cells, climate, rule.data());
+        });
+        const double lutMs = bench::BestMs(3, [&]
+        {
+            ClassifyTable(out[0], out[1], out[2], cells, climate, lut.data());
+        });
+        const double poolMs = bench::BestMs(3, [&]
+        {
+            world::ClassifyBiomes(out[0], out[1], out[2], cells, climate, rule.data(), pool);
+        });
+
+        std::printf("Biome classification, %dx%d\n", n, n);
+        size_t mismatched = 0;
+        for (size_t i = 0; i < cells; ++i)
+            mismatched += lut[i] != rule[i];
+
+        std::printf("  rule %7.2f ms, lookup table %7.2f ms  x%.2f, pool (%d threads) %7.2f ms, %s (%.4f%% of "
+            "pixels differ from the rule)\n", ruleMs, lutMs, ruleMs / lutMs, pool.ThreadCount(), poolMs,
+            mismatched == 0 ? "table is exact" : "[TABLE DIFFERS]", 100.0 * mismatched / cells);
+
+        size_t counts[static_cast<size_t>(world::Biome::Count)] = {};
+        for (uint8_t b : rule)
+            ++counts[b];
+
+        std::printf("  share:");
+        for (size_t b = 0; b < static_cast<size_t>(world::Biome::Count); ++b)
+        {
+            if (counts[b] > 0)
+                std::printf(" %s %.1f%%,", world::BiomeName(static_cast<world::Biome>(b)), 100.0 * counts[b] / cells);
+        }
+        std::printf("\n");
+    }
+}
+
+namespace bench
+{
+    void Climate()
+    {
+        FusedKernels();
+
+        ThreadPool pool(0);
+        FusedWorldFields(pool);
+        Biomes(pool);
+    }
+}
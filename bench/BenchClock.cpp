@@ -0,0 +1,63 @@
+#include "Bench.h"
+#include "core/Config.h"
+#include "core/SimClock.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr double FRAME_SECONDS = 1.0 / 60.0;  // vsync
+    constexpr int FRAMES = 120;
+
+    // Stands in for a sim tick of a given cost
+    void Spin(double ms)
+    {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(ms);
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+    }
+
+    void Run(const char* name, int speed, double tickMs)
+    {
+        SimClock clock(1.0 / cfg::SimTickHz, cfg::SimTickBudgetMs / 1000.0, cfg::SimMaxFrameMs / 1000.0);
+        clock.SetSpeed(speed);
+
+        double worstMs = 0.0;
+        double minAlpha = 1.0;
+        double maxAlpha = 0.0;
+        for (int f = 0; f < FRAMES; ++f)
+        {
+            const SimClock::Frame frame = clock.Advance(FRAME_SECONDS, [&] { Spin(tickMs); });
+            worstMs = std::max(worstMs, frame.simMs);
+            minAlpha = std::min(minAlpha, frame.alpha);
+            maxAlpha = std::max(maxAlpha, frame.alpha);
+        }
+
+        std::printf("  %-20s %5.2f ms ticks: %6.1f ticks/frame, %6.1f shed/frame, worst frame %5.2f ms sim, "
+            "alpha %.2f..%.2f\n", name, tickMs, static_cast<double>(clock.TickCount()) / FRAMES,
+            static_cast<double>(clock.ShedCount()) / FRAMES, worstMs, minAlpha, maxAlpha);
+    }
+}
+
+namespace bench
+{
+    void Clock()
+    {
+        std::printf("Fixed-step sim clock, %d Hz ticks, %.0f ms budget per 60 Hz frame\n", cfg::SimTickHz,
+            cfg::SimTickBudgetMs);
+        Run("paused", SimClock::Paused, 0.05);
+        Run("1x", 1, 0.05);
+        Run("10x", 10, 0.05);
+        Run("100x", 100, 0.05);
+        Run("100x, heavy ticks", 100, 0.5);
+        Run("as fast as possible", SimClock::Unlimited, 0.05);
+
+        // A stall (a world being forged) must not come back as a catch-up burst
+        SimClock clock(1.0 / cfg::SimTickHz, cfg::SimTickBudgetMs / 1000.0, cfg::SimMaxFrameMs / 1000.0);
+        const SimClock::Frame frame = clock.Advance(5.0, [] {});
+        std::printf("  5 s stall at 1x: %d ticks, %d shed (clamped to %.0f ms)\n", frame.ticks, frame.shed,
+            cfg::SimMaxFrameMs);
+    }
+}
@@ -0,0 +1,92 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/Erosion.h"
+#include "world/WorldGen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+
+    void Throughput()
+    {
+        const int n = 768;
+        const std::vector<float> base = world::PerlinFbm2D(n, n, world::ElevationParams(SEED));
+
+        world::ErosionParams p;
+        p.droplets = 1000000;
+        p.seed = SEED;
+
+        const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        std::printf("Hydraulic erosion, %dx%d, %d droplets (%u hardware threads)\n", n, n, p.droplets, hw);
+
+        std::vector<float> reference;
+        for (unsigned threads = 1; threads <= hw; threads *= 2)
+        {
+            ThreadPool pool(static_cast<int>(threads));
+            std::vector<float> field;
+            const double ms = bench::BestMs(3, [&]
+            {
+                field = base;
+                world::ErodeHydraulic(field.data(), n, n, p, pool);
+            });
+
+            if (reference.empty())
+                reference = field;
+
+            std::printf("  %2u threads: %8.2f ms  %6.2f M droplets/s%s\n", threads, ms,
+                p.droplets / (ms * 1000.0), (field == reference) ? "" : "  [DIFFERS FROM 1 THREAD]");
+
+            if (threads * 2 > hw && threads != hw)
+                threads = hw / 2; // make the last step the full machine
+        }
+
+        // How much the terrain moved; the net change is material still carried
+        // by droplets when they stopped
+        double moved = 0.0, net = 0.0;
+        for (size_t i = 0; i < base.size(); ++i)
+        {
+            moved += std::abs(reference[i] - base[i]);
+            net += reference[i] - base[i];
+        }
+        std::printf("  mean |dh| %.5f, mean dh %.5f\n", moved / base.size(), net / base.size());
+    }
+
+    void VolatilityBudget()
+    {
+        ThreadPool pool(0);
+        const int n = world::WorldResolution(4);
+        const std::vector<float> base = world::PerlinFbm2D(n, n, world::ElevationParams(SEED), pool);
+
+        std::printf("World volatility budget, %dx%d, %d threads\n", n, n, pool.ThreadCount());
+        const char* names[5] = { "stable", "low", "middling", "turbulent", "chaotic" };
+        for (int v = 0; v < 5; ++v)
+        {
+            WorldGenSettings s;
+            s.worldVolatility = v;
+            const world::ErosionParams p = world::WorldErosionParams(s, SEED, n, n);
+
+            std::vector<float> field;
+            const double ms = bench::BestMs(1, [&]
+            {
+                field = base;
+                world::ErodeHydraulic(field.data(), n, n, p, pool);
+            });
+            std::printf("  %-9s %8d droplets  %8.2f ms\n", names[v], p.droplets, ms);
+        }
+    }
+}
+
+namespace bench
+{
+    void Erosion()
+    {
+        Throughput();
+        VolatilityBudget();
+    }
+}
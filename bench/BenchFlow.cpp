@@ -0,0 +1,183 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/FlowField.h"
+#include "world/TileVolume.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t SEED = 0xC0FFEEu;
+    constexpr int LEVEL = 8;
+    constexpr int AGENTS = 100000;
+    constexpr int TICKS = 600;
+    constexpr int EDITS_PER_TICK = 4;
+    constexpr int AGENT_BLOCK = 4096;
+
+    // Invaders as plain arrays: tile position and the field they follow
+    struct Agents
+    {
+        std::vector<int32_t> x;
+        std::vector<int32_t> y;
+        std::vector<uint8_t> field;
+    };
+
+    void Crowd(ThreadPool& pool)
+    {
+        const int n = 1024;
+        world::TileVolume volume(n, n, 16);
+        const world::TilePoint core = bench::DigDungeon(volume, n, LEVEL);
+
+        world::FlowFields flow(n, n);
+        flow.LoadLevel(volume, LEVEL, pool);
+
+        std::vector<world::TilePoint> open;
+        std::vector<world::TilePoint> exits;
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                if (!flow.IsWalkable(x, y))
+                    continue;
+                open.push_back({ x, y });
+                if (std::min(std::min(x, y), std::min(n - 1 - x, n - 1 - y)) < 8)
+                    exits.push_back({ x, y });
+            }
+        }
+        std::vector<world::TilePoint> spawners;
+        for (int i = 0; i < 16; ++i)
+            spawners.push_back(open[SplitMix64(SEED + 100 + i) % open.size()]);
+
+        const std::vector<world::TilePoint> goals[3] = { { core }, spawners, exits };
+        const char* NAMES[3] = { "core", "spawners", "exits" };
+        for (const std::vector<world::TilePoint>& g : goals)
+            flow.AddField(g);
+        const double computeMs = bench::BestMs(3, [&] { flow.Recompute(pool); });
+
+        // Most invaders head for the Core, some for the spawners or out
+        Agents agents;
+        agents.x.resize(AGENTS);
+        agents.y.resize(AGENTS);
+        agents.field.resize(AGENTS);
+        const auto place = [&](int i, uint64_t key)
+        {
+            for (uint64_t k = key;; ++k)
+            {
+                const world::TilePoint p = open[SplitMix64(k) % open.size()];
+                const uint8_t f = agents.field[static_cast<size_t>(i)];
+                if (flow.IsWalkable(p.x, p.y) && flow.Distance(f, p.x, p.y) != world::FlowFields::Unreached)
+                {
+                    agents.x[static_cast<size_t>(i)] = p.x;
+                    agents.y[static_cast<size_t>(i)] = p.y;
+                    return;
+                }
+            }
+        };
+        for (int i = 0; i < AGENTS; ++i)
+        {
+            const uint64_t r = SplitMix64(SEED ^ static_cast<uint64_t>(i));
+            agents.field[static_cast<size_t>(i)] = (r % 10 < 8) ? 0 : (r % 10 == 8) ? 1 : 2;
+            place(i, r);
+        }
+
+        const int blocks = (AGENTS + AGENT_BLOCK - 1) / AGENT_BLOCK;
+        std::vector<int> arrivals(static_cast<size_t>(blocks), 0);
+        uint64_t rng = SEED ^ 0xD16u;
+        double moveMs = 0.0;
+        double worstMoveMs = 0.0;
+        double updateMs = 0.0;
+        double worstUpdateMs = 0.0;
+        size_t relabelled = 0;
+
+        for (int tick = 0; tick < TICKS; ++tick)
+        {
+            // The core digs new tunnels and walls some off
+            for (int e = 0; e < EDITS_PER_TICK;)
+            {
+                rng = SplitMix64(rng);
+                const int x = 1 + static_cast<int>(rng % (n - 2));
+                const int y = 1 + static_cast<int>((rng >> 32) % (n - 2));
+                const bool walkable = flow.IsWalkable(x, y);
+                const bool nearOpen = flow.IsWalkable(x + 1, y) || flow.IsWalkable(x - 1, y)
+                    || flow.IsWalkable(x, y + 1) || flow.IsWalkable(x, y - 1);
+                if ((!walkable && !nearOpen) || (x == core.x && y == core.y))
+                    continue;
+
+                const TileType type = walkable ? TileType::Wall : TileType::Floor;
+                volume.Set(x, y, LEVEL, type);
+                flow.SetWalkable(x, y, world::Walkable(type));
+                ++e;
+            }
+            const double u = bench::BestMs(1, [&] { relabelled += flow.Update(pool); });
+            updateMs += u;
+            worstUpdateMs = std::max(worstUpdateMs, u);
+
+            // Every invader reads one direction byte and steps; arrivals (and
+            // the few walled in) start over elsewhere
+            const double m = bench::BestMs(1, [&]
+            {
+                pool.ParallelFor(blocks, [&](int b)
+                {
+                    const int end = std::min((b + 1) * AGENT_BLOCK, AGENTS);
+                    for (int i = b * AGENT_BLOCK; i < end; ++i)
+                    {
+                        int32_t& x = agents.x[static_cast<size_t>(i)];
+                        int32_t& y = agents.y[static_cast<size_t>(i)];
+                        const uint8_t d = flow.Directions(agents.field[static_cast<size_t>(i)])[static_cast<size_t>(y) * n + x];
+                        if (d < 4)
+                        {
+                            const int DX[4] = { 1, -1, 0, 0 };
+                            const int DY[4] = { 0, 0, 1, -1 };
+                            x += DX[d];
+                            y += DY[d];
+                            continue;
+                        }
+                        arrivals[static_cast<size_t>(b)] += (d == world::FlowFields::DirGoal);
+                        place(i, SplitMix64(static_cast<uint64_t>(tick) << 32 | static_cast<uint32_t>(i)));
+                    }
+                });
+            });
+            moveMs += m;
+            worstMoveMs = std::max(worstMoveMs, m);
+        }
+
+        // The repaired fields have to match fresh ones
+        world::FlowFields fresh(n, n);
+        fresh.LoadLevel(volume, LEVEL, pool);
+        bool same = true;
+        for (const std::vector<world::TilePoint>& g : goals)
+            fresh.AddField(g);
+        const size_t tiles = static_cast<size_t>(n) * n;
+        for (int f = 0; f < flow.FieldCount(); ++f)
+        {
+            same = same && std::equal(flow.Distances(f), flow.Distances(f) + tiles, fresh.Distances(f))
+                && std::equal(flow.Directions(f), flow.Directions(f) + tiles, fresh.Directions(f));
+        }
+
+        int arrived = 0;
+        for (const int a : arrivals)
+            arrived += a;
+
+        std::printf("Flow fields, %dx%d level, %d invaders, %d ticks, %d tiles dug or filled per tick (%d threads)\n",
+            n, n, AGENTS, TICKS, EDITS_PER_TICK, pool.ThreadCount());
+        std::printf("  full compute of 3 fields (%s: 1 goal, %s: %zu, %s: %zu): %.1f ms\n", NAMES[0], NAMES[1],
+            spawners.size(), NAMES[2], exits.size(), computeMs);
+        std::printf("  move:   %.3f ms per tick (worst %.3f), %.1f ns per invader\n", moveMs / TICKS, worstMoveMs,
+            moveMs * 1e6 / (static_cast<double>(TICKS) * AGENTS));
+        std::printf("  update: %.3f ms per tick (worst %.3f), %.0f tiles relabelled per tick\n", updateMs / TICKS,
+            worstUpdateMs, static_cast<double>(relabelled) / TICKS);
+        std::printf("  %.0f ticks/s sustainable (60 needed), %d arrivals, fields %s\n",
+            1000.0 * TICKS / (moveMs + updateMs), arrived, same ? "same as a full recompute" : "[DIFFER FROM FULL RECOMPUTE]");
+    }
+}
+
+namespace bench
+{
+    void Flow()
+    {
+        ThreadPool pool(0);
+        Crowd(pool);
+    }
+}
@@ -0,0 +1,62 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/History.h"
+#include "world/WorldGen.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+
+    bool SameHistory(const world::History& a, const world::History& b)
+    {
+        return a.events.year == b.events.year && a.events.kind == b.events.kind && a.events.actor == b.events.actor
+            && a.events.target == b.events.target && a.events.site == b.events.site
+            && a.sites.population == b.sites.population && a.civs.fell == b.civs.fell;
+    }
+
+    void Simulate(ThreadPool& pool, ThreadPool& serial)
+    {
+        const char* LENGTH[] = { "primal", "short", "middling", "long", "ancient" };
+        const char* SATURATION[] = { "scarce", "low", "middling", "dense", "excessive" };
+
+        std::printf("History simulation (%d threads)\n", pool.ThreadCount());
+        for (const auto& [length, saturation] : { std::pair{ 2, 2 }, std::pair{ 4, 2 }, std::pair{ 4, 4 } })
+        {
+            WorldGenSettings settings;
+            settings.historyLength = length;
+            settings.civilizationSaturation = saturation;
+
+            const int n = world::WorldResolution(settings.worldSize);
+            const world::HistoryParams p = world::WorldHistoryParams(settings, SEED, n, n);
+
+            world::History history, reference;
+            const double ms = bench::BestMs(2, [&] { history = world::SimulateHistory(p, pool); });
+            reference = world::SimulateHistory(p, serial);
+
+            size_t alive = 0, standing = 0;
+            for (int32_t fell : history.civs.fell)
+                alive += fell == world::HistoryNone;
+            for (int32_t owner : history.sites.owner)
+                standing += owner != world::HistoryNone;
+
+            std::printf("  %-8s / %-9s %5d years %8.1f ms  %9.0f years/s  civs %zu (%zu alive), sites %zu "
+                "(%zu standing), events %zu, %s\n",
+                LENGTH[length], SATURATION[saturation], p.years, ms, p.years / (ms / 1000.0), history.civs.Count(),
+                alive, history.sites.Count(), standing, history.events.Count(),
+                SameHistory(history, reference) ? "same as 1 thread" : "[DIFFERS FROM 1 THREAD]");
+        }
+    }
+}
+
+namespace bench
+{
+    void History()
+    {
+        ThreadPool pool(0);
+        ThreadPool serial(1);
+        Simulate(pool, serial);
+    }
+}
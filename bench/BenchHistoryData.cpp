@@ -0,0 +1,130 @@
+#include "Bench.h"
+#include "core/Config.h"
+#include "world/HistoryData.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string ReadAll(const char* path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // The obvious loader: getline into std::string, a string per name and tag
+    size_t NaiveParse(const std::string& text)
+    {
+        std::istringstream in(text);
+        std::vector<std::string> names, tags;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty() || line[0] == '#' || line[0] == '[')
+                continue;
+
+            const size_t bar = line.find('|');
+            names.push_back(line.substr(0, bar));
+            if (bar == std::string::npos)
+                continue;
+
+            std::istringstream list(line.substr(line.find(':', bar) + 1));
+            std::string tag;
+            while (std::getline(list, tag, ','))
+                tags.push_back(tag);
+        }
+        return names.size() + tags.size();
+    }
+
+    void AssetFiles()
+    {
+        world::HistoryData data;
+        std::string error;
+
+        std::printf("Asset files\n");
+        for (const char* path : cfg::HistoryDataPaths)
+        {
+            const double ms = bench::BestMs(1, [&]
+            {
+                if (!data.Load(path, error))
+                    std::printf("  %s\n", error.c_str());
+            });
+            std::printf("  %-32s %7.3f ms\n", path, ms);
+        }
+
+        std::printf("  %zu names, %zu tags, %zu pools (%zu entries), %zu template groups (%zu templates)\n",
+            data.Names().size(), data.Tags().Count(), data.Pools().size(), data.PoolEntries().size(),
+            data.TemplateGroups().size(), data.Templates().size());
+    }
+
+    void Throughput()
+    {
+        const std::string one = ReadAll(cfg::HistoryDataPaths[0]);
+        if (one.empty())
+        {
+            std::printf("Throughput: %s not found (run from the repository root)\n", cfg::HistoryDataPaths[0]);
+            return;
+        }
+
+        // The asset file repeated to 32 MB, so sections merge thousands of times over
+        std::string big;
+        while (big.size() < (32u << 20))
+            big += one;
+        const double mb = static_cast<double>(big.size()) / (1 << 20);
+
+        std::string error;
+        size_t names = 0;
+        const double ms = bench::BestMs(3, [&]
+        {
+            world::HistoryData data;
+            if (!data.Parse(big, "big", error))
+                std::printf("  %s\n", error.c_str());
+            names = data.Names().size();
+        });
+        size_t naiveItems = 0;
+        const double naiveMs = bench::BestMs(3, [&] { naiveItems = NaiveParse(big); });
+
+        std::printf("Throughput, %.1f MB (%zu names)\n", mb, names);
+        std::printf("  zero-copy %7.1f ms  %6.2f ms/MB  %7.1f MB/s\n", ms, ms / mb, mb / (ms / 1000.0));
+        std::printf("  getline   %7.1f ms  %6.2f ms/MB  %7.1f MB/s  (%zu strings)\n", naiveMs, naiveMs / mb,
+            mb / (naiveMs / 1000.0), naiveItems);
+    }
+
+    void Errors()
+    {
+        const char* BAD[] = {
+            "# no header yet\nBren | tags:human\n",
+            "[NAME]\nBren | tags:human,,male\n",
+            "[name]\nBren | human\n",
+            "[POOL:CONCEPTS]\nFire\n[RIVERS]\n",
+            "[TEMPLATE:WARS]\nweight=x | The {descriptor} War\n",
+            "[TEMPLATE:WARS\n",
+        };
+
+        std::printf("Errors\n");
+        for (const char* text : BAD)
+        {
+            world::HistoryData data;
+            std::string error;
+            if (data.Parse(text, "sample.txt", error))
+                std::printf("  [ACCEPTED]\n");
+            else
+                std::printf("  %s\n", error.c_str());
+        }
+    }
+}
+
+namespace bench
+{
+    void HistoryData()
+    {
+        AssetFiles();
+        Throughput();
+        Errors();
+    }
+}
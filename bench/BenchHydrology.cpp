@@ -0,0 +1,168 @@
+#include "Bench.h"
+#include "core/Config.h"
+#include "core/ThreadPool.h"
+#include "world/Hydrology.h"
+#include "world/WorldGen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+
+    // Textbook priority-flood on std::priority_queue with exact float order
+    void NaiveFill(const std::vector<float>& height, int w, int h, float seaLevel, std::vector<float>& filled)
+    {
+        using Entry = std::pair<float, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        std::vector<uint8_t> queued(height.size(), 0);
+        filled.assign(height.size(), 0.0f);
+
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                const int i = y * w + x;
+                if (x == 0 || y == 0 || x == w - 1 || y == h - 1 || height[i] < seaLevel)
+                {
+                    filled[i] = height[i];
+                    queued[i] = 1;
+                    open.push({ height[i], i });
+                }
+            }
+        }
+
+        while (!open.empty())
+        {
+            const int c = open.top().second;
+            open.pop();
+
+            for (int k = 0; k < 8; ++k)
+            {
+                const int nx = c % w + world::FlowDX[k];
+                const int ny = c / w + world::FlowDY[k];
+                if (nx < 0 || ny < 0 || nx >= w || ny >= h)
+                    continue;
+
+                const int i = ny * w + nx;
+                if (queued[i])
+                    continue;
+
+                queued[i] = 1;
+                filled[i] = std::max(height[i], filled[c]);
+                open.push({ filled[i], i });
+            }
+        }
+    }
+
+    // Serial accumulation over the whole map in Kahn's order
+    void NaiveAccumulate(const std::vector<uint8_t>& dir, int w, std::vector<float>& flow)
+    {
+        const size_t n = dir.size();
+        std::vector<uint8_t> donors(n, 0);
+        std::vector<int> receiver(n, -1);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (dir[i] == world::FlowNone)
+                continue;
+            receiver[i] = static_cast<int>(i) + world::FlowDY[dir[i]] * w + world::FlowDX[dir[i]];
+            ++donors[static_cast<size_t>(receiver[i])];
+        }
+
+        flow.assign(n, 1.0f);
+        std::vector<int> order;
+        order.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (donors[i] == 0)
+                order.push_back(static_cast<int>(i));
+        }
+
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            const int r = receiver[static_cast<size_t>(order[k])];
+            if (r < 0)
+                continue;
+
+            flow[static_cast<size_t>(r)] += flow[static_cast<size_t>(order[k])];
+            if (--donors[static_cast<size_t>(r)] == 0)
+                order.push_back(r);
+        }
+    }
+
+    void Rivers(ThreadPool& pool, ThreadPool& tiledPool)
+    {
+        std::printf("Hydrology (%d threads): bucket-queue fill + D8 + tiled accumulation vs priority_queue + serial\n",
+            pool.ThreadCount());
+
+        for (int n : { 1024, 2048, 4096 })
+        {
+            const size_t cells = static_cast<size_t>(n) * n;
+            const std::vector<float> height = world::PerlinFbm2D(n, n, world::ElevationParams(SEED), pool);
+            const float sea = world::WorldClimate(height).seaLevel;
+
+            std::vector<float> filled(cells), naiveFilled;
+            std::vector<uint8_t> floodDir(cells), dir(cells);
+            std::vector<float> flow(cells), naiveFlow;
+
+            const double fillMs = bench::BestMs(1, [&]
+            {
+                world::FillDepressions(height.data(), n, n, sea, 1 << 16, filled.data(), floodDir.data());
+            });
+            const double dirMs = bench::BestMs(1, [&]
+            {
+                world::FlowDirections(filled.data(), floodDir.data(), n, n, sea, dir.data(), pool);
+            });
+            const double accMs = bench::BestMs(3, [&] { world::FlowAccumulation(dir.data(), n, n, flow.data(), pool); });
+
+            // The tiled path (taken with more than one thread) has to agree
+            std::vector<float> tiledFlow(cells);
+            const double tiledMs = bench::BestMs(3, [&]
+            {
+                world::FlowAccumulation(dir.data(), n, n, tiledFlow.data(), tiledPool);
+            });
+
+            const double naiveFillMs = bench::BestMs(1, [&] { NaiveFill(height, n, n, sea, naiveFilled); });
+            const double naiveAccMs = bench::BestMs(3, [&] { NaiveAccumulate(dir, n, naiveFlow); });
+
+            // The bucket fill may overshoot an exact fill by one quantum
+            const auto [mn, mx] = std::minmax_element(height.begin(), height.end());
+            const float quantum = (*mx - *mn) / ((1 << 16) - 1);
+            float worst = 0.0f;
+            size_t raised = 0;
+            for (size_t i = 0; i < cells; ++i)
+            {
+                worst = std::max(worst, std::abs(filled[i] - naiveFilled[i]));
+                raised += filled[i] > height[i];
+            }
+
+            size_t river = 0;
+            for (float f : flow)
+                river += f >= cfg::RiverMinCatchment;
+
+            std::printf("  %4dx%-4d fill %8.1f ms (naive %8.1f), D8 %6.1f ms, accumulate %7.1f ms (naive %7.1f, "
+                "tiled on %d threads %7.1f)\n", n, n, fillMs, naiveFillMs, dirMs, accMs, naiveAccMs,
+                tiledPool.ThreadCount(), tiledMs);
+            std::printf("            total %.2f s, %.1f%% cells filled, max |fill - exact| %.2g (quantum %.2g), "
+                "accumulation %s, %.2f%% river cells\n",
+                (fillMs + dirMs + accMs) / 1000.0, 100.0 * raised / cells, worst, quantum,
+                (flow == naiveFlow && tiledFlow == naiveFlow) ? "matches" : "DIFFERS", 100.0 * river / cells);
+        }
+    }
+}
+
+namespace bench
+{
+    void Hydrology()
+    {
+        ThreadPool pool(0);
+        ThreadPool tiledPool(4);
+        Rivers(pool, tiledPool);
+    }
+}
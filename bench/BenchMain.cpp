@@ -0,0 +1,64 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    struct Entry
+    {
+        const char* name;
+        void (*run)();
+    };
+
+    const Entry BENCHES[] = {
+        { "noise", &bench::Noise },
+        { "world", &bench::World },
+        { "erosion", &bench::Erosion },
+        { "climate", &bench::Climate },
+        { "hydrology", &bench::Hydrology },
+        { "noisegraph", &bench::NoiseGraph },
+        { "history", &bench::History },
+        { "historydata", &bench::HistoryData },
+        { "templates", &bench::Templates },
+        { "tags", &bench::Tags },
+        { "sites", &bench::Sites },
+        { "territory", &bench::Territory },
+        { "tiles", &bench::Tiles },
+        { "paths", &bench::Paths },
+        { "flow", &bench::Flow },
+        { "spatial", &bench::Spatial },
+        { "clock", &bench::Clock },
+    };
+}
+
+int main(int argc, char** argv)
+{
+    int ran = 0;
+
+    for (const Entry& e : BENCHES)
+    {
+        bool wanted = (argc <= 1);
+        for (int i = 1; i < argc; ++i)
+            wanted = wanted || std::strcmp(argv[i], e.name) == 0;
+
+        if (!wanted)
+            continue;
+
+        std::printf("== %s ==\n", e.name);
+        e.run();
+        std::printf("\n");
+        ++ran;
+    }
+
+    if (ran == 0)
+    {
+        std::printf("usage: DungeonBench [name...]\navailable:");
+        for (const Entry& e : BENCHES)
+            std::printf(" %s", e.name);
+        std::printf("\n");
+        return 1;
+    }
+
+    return 0;
+}
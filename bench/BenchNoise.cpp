@@ -0,0 +1,316 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/Noise.h"
+#include "world/NoiseCache.h"
+#include "world/NoiseKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Same parameters Ui::GenerateMapPreview uses
+    world::NoiseParams PreviewParams()
+    {
+        world::NoiseParams p;
+        p.scale = 128.0f;
+        p.octaves = 5;
+        p.persistence = 0.5f;
+        p.lacunarity = 2.0f;
+        p.seed = 1337;
+        p.offsetX = -211.0f;
+        p.offsetY = 97.0f;
+        return p;
+    }
+
+    void Kernels()
+    {
+        using namespace world::detail;
+
+        std::vector<int> perm(512);
+        std::iota(perm.begin(), perm.begin() + 256, 0);
+        std::reverse(perm.begin(), perm.begin() + 256);
+        std::copy(perm.begin(), perm.begin() + 256, perm.begin() + 256);
+
+        FbmSetup s;
+        s.perm = perm.data();
+        s.baseScale = 128.0f;
+        s.offsetX = -211.0f;
+        s.offsetY = 97.0f;
+        s.octaves = 5;
+        s.persistence = 0.5f;
+        s.lacunarity = 2.0f;
+        PrepareOctaves(s);
+
+        const int n = 768;
+        std::vector<float> ref(static_cast<size_t>(n) * n), got(ref.size());
+
+        auto run = [&](const FbmKernel& k, std::vector<float>& out)
+        {
+            for (int y = 0; y < n; ++y)
+                k.row(s, 0, y, n, out.data() + static_cast<size_t>(y) * n);
+        };
+
+        const double scalarMs = bench::BestMs(3, [&] { run(ScalarFbmKernel(), ref); });
+        std::printf("fBm kernels, %dx%d, %d octaves (tolerance %g)\n", n, n, s.octaves, SimdKernelTolerance);
+        std::printf("  %-8s %8.2f ms\n", "scalar", scalarMs);
+
+        for (const FbmKernel* k : SupportedSimdFbmKernels())
+        {
+            const double ms = bench::BestMs(3, [&] { run(*k, got); });
+
+            float maxErr = 0.0f;
+            for (size_t i = 0; i < ref.size(); ++i)
+                maxErr = std::max(maxErr, std::abs(ref[i] - got[i]));
+
+            std::printf("  %-8s %8.2f ms  x%.2f  max err %g\n", k->name, ms, scalarMs / ms, maxErr);
+        }
+    }
+
+    // Unrolled octave kernels against the runtime octave loop (tables cleared)
+    void OctaveUnrolling()
+    {
+        using namespace world::detail;
+
+        const world::NoiseParams p = PreviewParams();
+        const int n = 512;
+        std::vector<int> perm(512);
+        for (int i = 0; i < 512; ++i)
+            perm[i] = ((i & 255) * 167 + 13) & 255;
+
+        std::vector<float> loop(static_cast<size_t>(n) * n), unrolled(loop.size());
+
+        std::printf("Octave unrolling, %dx%d (ms)\n", n, n);
+        for (const FbmKernel* kernel : { &ScalarFbmKernel(), &ActiveFbmKernel() })
+        {
+            for (int octaves = MinUnrolledOctaves; octaves <= MaxUnrolledOctaves; ++octaves)
+            {
+                const FbmKernel& k = *kernel;
+
+                FbmSetup s;
+                s.perm = perm.data();
+                s.baseScale = p.scale;
+                s.offsetX = p.offsetX;
+                s.offsetY = p.offsetY;
+                s.octaves = octaves;
+                s.persistence = p.persistence;
+                s.lacunarity = p.lacunarity;
+
+                FbmSetup generic = s;
+                PrepareOctaves(s);
+
+                const double loopMs = bench::BestMs(3, [&]
+                {
+                    for (int y = 0; y < n; ++y)
+                        k.row(generic, 0, y, n, loop.data() + static_cast<size_t>(y) * n);
+                });
+                const double unrolledMs = bench::BestMs(3, [&]
+                {
+                    for (int y = 0; y < n; ++y)
+                        k.row(s, 0, y, n, unrolled.data() + static_cast<size_t>(y) * n);
+                });
+
+                std::printf("  %-8s %d octaves: loop %7.2f, unrolled %7.2f  x%.2f%s\n", k.name, octaves, loopMs, unrolledMs,
+                    loopMs / unrolledMs, (loop == unrolled) ? "" : "  [OUTPUT DIFFERS]");
+            }
+        }
+    }
+
+    // Many small fields with distinct seeds, as batch world generation does;
+    // the second round finds every permutation table in the per-seed cache
+    void SeedBatch()
+    {
+        const int seeds = 48;
+        const int n = 64;
+        world::NoiseParams p = PreviewParams();
+
+        std::vector<float> out(static_cast<size_t>(n) * n);
+        const auto batch = [&](uint32_t firstSeed)
+        {
+            for (int i = 0; i < seeds; ++i)
+            {
+                p.seed = firstSeed + i;
+                world::PerlinFbm2DRegion(out.data(), n, 0, 0, n, n, p);
+            }
+        };
+
+        uint32_t fresh = 1000;
+        const double coldMs = bench::BestMs(3, [&] { batch(fresh); fresh += seeds; });
+        const double warmMs = bench::BestMs(3, [&] { batch(1000); });
+
+        std::printf("Seed batch, %d seeds x %dx%d: new seeds %.2f ms, cached permutations %.2f ms\n",
+            seeds, n, n, coldMs, warmMs);
+    }
+
+    void ThreadScaling()
+    {
+        const world::NoiseParams p = PreviewParams();
+        const int sizes[] = { 256, 384, 512, 640, 768 };
+        const int threads[] = { 1, 2, 4, 8, 16 };
+
+        std::printf("PerlinFbm2D thread scaling (ms, speedup vs 1 thread; %u hardware threads)\n",
+            std::thread::hardware_concurrency());
+        std::printf("  %5s", "size");
+        for (int t : threads)
+            std::printf(" %15d", t);
+        std::printf("\n");
+
+        for (int n : sizes)
+        {
+            const std::vector<float> reference = world::PerlinFbm2D(n, n, p);
+
+            std::printf("  %5d", n);
+            double base = 0.0;
+            for (int t : threads)
+            {
+                ThreadPool pool(t);
+                std::vector<float> out;
+                const double ms = bench::BestMs(5, [&] { out = world::PerlinFbm2D(n, n, p, pool); });
+                if (t == 1)
+                    base = ms;
+
+                const bool identical = (out == reference);
+                std::printf(" %7.2f (x%4.1f)%s", ms, base / ms, identical ? "" : "!");
+            }
+            std::printf("\n");
+        }
+        std::printf("  ('!' marks output that differs from the single-threaded field)\n");
+    }
+
+    void ChunkCache()
+    {
+        const world::NoiseParams p = PreviewParams();
+        const int n = 768;
+        ThreadPool pool(0);
+        world::NoiseChunkCache cache;
+        std::vector<float> out(static_cast<size_t>(n) * n);
+
+        const double cold = bench::BestMs(1, [&] { cache.Read(out.data(), n, 0, 0, n, n, p, 0, pool); });
+        const double warm = bench::BestMs(5, [&] { cache.Read(out.data(), n, 0, 0, n, n, p, 0, pool); });
+
+        const world::NoiseCacheStats& s = cache.Stats();
+        std::printf("Chunk cache, %dx%d read: cold %.2f ms, warm %.2f ms (hits %llu, misses %llu, %zu KB)\n",
+            n, n, cold, warm, static_cast<unsigned long long>(s.hits), static_cast<unsigned long long>(s.misses),
+            s.bytes / 1024);
+    }
+
+    // Preview upload path: float samples -> RGBA texture bytes. `texture`
+    // stands in for the SDL texture memory (SDL_UpdateTexture copies into it,
+    // SDL_LockTexture hands it out).
+    void Upload()
+    {
+        const world::NoiseParams p = PreviewParams();
+        const int n = 768;
+        const std::vector<float> field = world::PerlinFbm2D(n, n, p);
+        const auto [mn, mx] = std::minmax_element(field.begin(), field.end());
+        const size_t px = static_cast<size_t>(n) * n;
+
+        std::vector<uint8_t> texture(px * 4), fused(px * 4);
+
+        // strip copy, NormalizeToU8, GrayToRGBA, then the SDL_UpdateTexture copy
+        const double stagedMs = bench::BestMs(10, [&]
+        {
+            std::vector<float> strip(field.begin(), field.end());
+            auto gray = world::NormalizeToU8(strip, *mn, *mx);
+            auto rgba = world::GrayToRGBA(gray);
+            std::memcpy(texture.data(), rgba.data(), rgba.size());
+        });
+
+        const double fusedMs = bench::BestMs(10, [&]
+        {
+            world::FloatToGrayRGBA(field.data(), n, n, n, *mn, *mx, fused.data(), n * 4);
+        });
+
+        // Bytes read + written per pixel by each pass
+        const size_t stagedBytes = px * ((4 + 4) + (4 + 1) + (1 + 4) + (4 + 4));
+        const size_t fusedBytes = px * (4 + 4);
+
+        std::printf("Preview upload, %dx%d: staged %.2f ms (%zu KB, 3 allocations), fused %.2f ms (%zu KB, none)"
+            " -> %.1fx less traffic%s\n",
+            n, n, stagedMs, stagedBytes / 1024, fusedMs, fusedBytes / 1024,
+            static_cast<double>(stagedBytes) / fusedBytes, (texture == fused) ? "" : "  [OUTPUT DIFFERS]");
+    }
+
+    // NormalizeTerrainToU8 as it was before the histogram version: two sorted
+    // copies for the percentiles and std::pow per pixel. Kept as the reference.
+    std::vector<uint8_t> NormalizeTerrainBySorting(const std::vector<float>& src,
+        float clipLow, float clipHigh, float seaLevel, float gamma)
+    {
+        const auto percentile = [&](float p01)
+        {
+            std::vector<float> data = src;
+            const size_t k = static_cast<size_t>(std::round(p01 * float(data.size() - 1)));
+            std::nth_element(data.begin(), data.begin() + k, data.end());
+            return data[k];
+        };
+
+        const float lo = percentile(clipLow);
+        const float hi = percentile(clipHigh);
+        const float denom = std::max(hi - lo, 1e-8f);
+        const float seaBias = seaLevel - 0.5f;
+
+        std::vector<uint8_t> out(src.size());
+        for (size_t i = 0; i < src.size(); ++i)
+        {
+            float t = std::clamp((src[i] - lo) / denom, 0.0f, 1.0f);
+            t = std::clamp(t - seaBias, 0.0f, 1.0f);
+            if (gamma > 0.0001f)
+                t = std::pow(t, gamma);
+            out[i] = static_cast<uint8_t>(t * 255.0f + 0.5f);
+        }
+        return out;
+    }
+
+    void TerrainNormalize()
+    {
+        ThreadPool pool(0);
+        std::printf("Terrain normalize (sorted percentiles + pow vs histogram + LUT, %d threads)\n", pool.ThreadCount());
+
+        for (int n : { 768, 4096 })
+        {
+            const std::vector<float> field = world::PerlinFbm2D(n, n, PreviewParams(), pool);
+
+            for (float gamma : { 1.45f, 0.5f, 0.25f })
+            {
+                std::vector<uint8_t> ref, serial, parallel;
+                const double refMs = bench::BestMs(3, [&] { ref = NormalizeTerrainBySorting(field, 0.02f, 0.98f, 0.55f, gamma); });
+                const double serialMs = bench::BestMs(3, [&] { serial = world::NormalizeTerrainToU8(field, 0.02f, 0.98f, 0.55f, gamma); });
+                const double parallelMs = bench::BestMs(3, [&] { parallel = world::NormalizeTerrainToU8(field, pool, 0.02f, 0.98f, 0.55f, gamma); });
+
+                int maxDiff = 0;
+                size_t differing = 0;
+                for (size_t i = 0; i < ref.size(); ++i)
+                {
+                    const int d = std::abs(int(ref[i]) - int(serial[i]));
+                    maxDiff = std::max(maxDiff, d);
+                    differing += (d != 0);
+                }
+
+                std::printf("  %4dx%-4d gamma %.2f: sorted %8.2f ms, histogram %7.2f ms, parallel %7.2f ms"
+                    "  max diff %d LSB (%.3f%% of pixels)%s\n",
+                    n, n, gamma, refMs, serialMs, parallelMs, maxDiff, 100.0 * differing / ref.size(),
+                    (serial == parallel) ? "" : "  [PARALLEL DIFFERS]");
+            }
+        }
+    }
+}
+
+namespace bench
+{
+    void Noise()
+    {
+        world::detail::ActiveFbmKernel(); // log the dispatch decision up front
+        Kernels();
+        OctaveUnrolling();
+        SeedBatch();
+        ThreadScaling();
+        ChunkCache();
+        Upload();
+        TerrainNormalize();
+    }
+}
@@ -0,0 +1,162 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/NoiseGraph.h"
+#include "world/NoiseKernels.h"
+#include "world/WorldGen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+    constexpr int N = 1024;
+
+    world::NoiseParams Params(uint32_t seed, float scale, int octaves)
+    {
+        world::NoiseParams p;
+        p.scale = scale;
+        p.octaves = octaves;
+        p.seed = seed;
+        return p;
+    }
+
+    // A warped, ridged continent field: the shape of the Continents preset
+    // with its parameters spelled out, so it can be written by hand too
+    struct WarpedRidges
+    {
+        world::NoiseParams base = Params(SEED, 256.0f, 5);
+        world::NoiseParams warpX = Params(SEED ^ 1u, 128.0f, 3);
+        world::NoiseParams warpY = Params(SEED ^ 2u, 128.0f, 3);
+        world::NoiseParams ridges = Params(SEED ^ 3u, 64.0f, 5);
+        float strength = 40.0f;
+        float weight = 0.25f;
+
+        world::NoiseGraph::Node Build(world::NoiseGraph& g) const
+        {
+            const auto land = g.Warp(g.Fbm(base), g.Fbm(warpX), g.Fbm(warpY), strength);
+            const auto inland = g.Clamp(g.Mul(land, g.Constant(4.0f)), 0.0f, 1.0f);
+            const auto ranges = g.Mul(g.Mul(g.Add(g.Ridged(ridges), g.Constant(1.0f)), inland), g.Constant(weight));
+            return g.Add(land, ranges);
+        }
+
+        // Whole-map passes over full-size intermediates, no interpreter
+        void ByHand(float* out, int n, ThreadPool& pool) const
+        {
+            using namespace world::detail;
+            const size_t cells = static_cast<size_t>(n) * n;
+
+            const std::vector<float> dx = world::PerlinFbm2D(n, n, warpX, pool);
+            const std::vector<float> dy = world::PerlinFbm2D(n, n, warpY, pool);
+
+            const auto basePerm = SeedPermutation(base.seed);
+            const auto ridgePerm = SeedPermutation(ridges.seed);
+            const FbmSetup baseSetup = MakeFbmSetup(base, *basePerm);
+            const FbmSetup ridgeSetup = MakeFbmSetup(ridges, *ridgePerm);
+
+            std::vector<float> wx(cells), wy(cells), px(cells), py(cells), land(cells), ridge(cells);
+            pool.ParallelFor(n, [&](int y)
+            {
+                const size_t row = static_cast<size_t>(y) * n;
+                for (int x = 0; x < n; ++x)
+                {
+                    px[row + x] = static_cast<float>(x);
+                    py[row + x] = static_cast<float>(y);
+                    wx[row + x] = px[row + x] + strength * dx[row + x];
+                    wy[row + x] = py[row + x] + strength * dy[row + x];
+                }
+
+                ScalarFbmPoints(baseSetup, FbmShape::Plain, &wx[row], &wy[row], n, &land[row]);
+                ScalarFbmPoints(ridgeSetup, FbmShape::Ridged, &px[row], &py[row], n, &ridge[row]);
+
+                for (int x = 0; x < n; ++x)
+                {
+                    const float inland = std::clamp(land[row + x] * 4.0f, 0.0f, 1.0f);
+                    out[row + x] = land[row + x] + (ridge[row + x] + 1.0f) * inland * weight;
+                }
+            });
+        }
+    };
+
+    // A lone fBm node against the direct call: the interpreter's overhead
+    void PlainFbm(ThreadPool& pool)
+    {
+        const world::NoiseParams p = world::ElevationParams(SEED);
+        world::NoiseGraph g;
+        const world::NoiseProgram program = world::NoiseProgram::Compile(g, g.Fbm(p));
+
+        std::vector<float> direct(static_cast<size_t>(N) * N), graph(direct.size());
+        const double directMs = bench::BestMs(3, [&] { world::PerlinFbm2DRegion(direct.data(), N, 0, 0, N, N, p, pool); });
+        const double graphMs = bench::BestMs(3, [&] { program.Evaluate(graph.data(), N, 0, 0, N, N, pool); });
+
+        std::printf("  fbm            PerlinFbm2D %7.2f ms, graph %7.2f ms  x%.2f%s\n", directMs, graphMs,
+            directMs / graphMs, (direct == graph) ? "  bit-identical" : "  [OUTPUT DIFFERS]");
+    }
+
+    void Composite(ThreadPool& pool)
+    {
+        const WarpedRidges field;
+        world::NoiseGraph g;
+        const world::NoiseProgram program = world::NoiseProgram::Compile(g, field.Build(g));
+
+        std::vector<float> hand(static_cast<size_t>(N) * N), graph(hand.size());
+        const double handMs = bench::BestMs(3, [&] { field.ByHand(hand.data(), N, pool); });
+        const double graphMs = bench::BestMs(3, [&] { program.Evaluate(graph.data(), N, 0, 0, N, N, pool); });
+
+        float worst = 0.0f;
+        for (size_t i = 0; i < hand.size(); ++i)
+            worst = std::max(worst, std::abs(hand[i] - graph[i]));
+
+        std::printf("  warp+ridges    by hand     %7.2f ms, graph %7.2f ms  x%.2f, max |diff| %.2g "
+            "(%d instructions, %d registers)\n", handMs, graphMs, handMs / graphMs, worst,
+            program.InstructionCount(), program.RegisterCount());
+
+        // Block size only changes how often the interpreter dispatches
+        std::printf("  block size    ");
+        for (int block : { 1, 16, 64, 256 })
+        {
+            const world::NoiseProgram sized = world::NoiseProgram::Compile(g, field.Build(g), block);
+            const double ms = bench::BestMs(2, [&] { sized.Evaluate(graph.data(), N, 0, 0, N, N, pool); });
+            std::printf(" %d: %.1f ms,", block, ms);
+        }
+        std::printf("\n");
+    }
+
+    void Presets(ThreadPool& pool)
+    {
+        WorldGenSettings settings;
+        settings.worldSize = 4;
+        const int n = world::WorldResolution(settings.worldSize);
+
+        for (const auto& [preset, name] : { std::pair{ world::TerrainPreset::Continents, "continents" },
+                 std::pair{ world::TerrainPreset::Archipelago, "archipelago" } })
+        {
+            const world::TerrainGraph t = world::BuildTerrainGraph(preset, settings, SEED);
+            const world::NoiseProgram program = world::NoiseProgram::Compile(t.graph, t.output);
+
+            std::vector<float> out(static_cast<size_t>(n) * n);
+            const double ms = bench::BestMs(3, [&] { program.Evaluate(out.data(), n, 0, 0, n, n, pool); });
+
+            size_t land = 0;
+            for (float v : out)
+                land += v > 0.0f;
+
+            std::printf("  %-13s  %dx%d %7.2f ms (%d instructions), %.0f%% above zero\n", name, n, n, ms,
+                program.InstructionCount(), 100.0 * land / out.size());
+        }
+    }
+}
+
+namespace bench
+{
+    void NoiseGraph()
+    {
+        ThreadPool pool(0);
+        std::printf("Noise graph programs, %dx%d (%d threads)\n", N, N, pool.ThreadCount());
+        PlainFbm(pool);
+        Composite(pool);
+        Presets(pool);
+    }
+}
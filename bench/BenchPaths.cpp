@@ -0,0 +1,232 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/PathGraph.h"
+#include "world/TileVolume.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t SEED = 0xC0FFEEu;
+    constexpr int LEVEL = 8;
+    constexpr int QUERIES = 10000;
+    constexpr int EDITS = 200;
+
+    // Exact distances from `from` over the whole level
+    std::vector<int> FullBfs(const world::PathGraph& graph, world::TilePoint from)
+    {
+        const int w = graph.Width();
+        const int h = graph.Height();
+        std::vector<int> dist(static_cast<size_t>(w) * h, -1);
+        std::vector<int> queue{ from.y * w + from.x };
+        dist[static_cast<size_t>(queue[0])] = 0;
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const int cur = queue[head];
+            const int x = cur % w;
+            const int y = cur / w;
+            const int nx[4] = { x + 1, x - 1, x, x };
+            const int ny[4] = { y, y, y + 1, y - 1 };
+            for (int k = 0; k < 4; ++k)
+            {
+                if (nx[k] < 0 || ny[k] < 0 || nx[k] >= w || ny[k] >= h || !graph.IsWalkable(nx[k], ny[k]))
+                    continue;
+                const int i = ny[k] * w + nx[k];
+                if (dist[static_cast<size_t>(i)] >= 0)
+                    continue;
+                dist[static_cast<size_t>(i)] = dist[static_cast<size_t>(cur)] + 1;
+                queue.push_back(i);
+            }
+        }
+        return dist;
+    }
+
+    bool ValidPath(const world::PathGraph& graph, const std::vector<world::TilePoint>& path, world::TilePoint from,
+        world::TilePoint to, int cost)
+    {
+        if (path.empty() || static_cast<int>(path.size()) != cost + 1)
+            return false;
+        if (path.front().x != from.x || path.front().y != from.y || path.back().x != to.x || path.back().y != to.y)
+            return false;
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            if (!graph.IsWalkable(path[i].x, path[i].y))
+                return false;
+            if (i > 0 && std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1)
+                return false;
+        }
+        return true;
+    }
+
+    void Hierarchical(ThreadPool& pool, int clusterSize)
+    {
+        const int n = 1024;
+        world::TileVolume volume(n, n, 16);
+        const world::TilePoint core = bench::DigDungeon(volume, n, LEVEL);
+
+        world::PathGraph graph(n, n, clusterSize);
+        const double buildMs = bench::BestMs(3, [&] { graph.LoadLevel(volume, LEVEL, pool); });
+
+        // Invaders start on open tiles near the map edge that can reach the Core
+        const std::vector<int> exact = FullBfs(graph, core);
+        std::vector<world::TilePoint> edge;
+        std::vector<world::TilePoint> open;
+        for (int y = 0; y < n; ++y)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                if (exact[static_cast<size_t>(y) * n + x] < 0)
+                    continue;
+                open.push_back({ x, y });
+                if (std::min(std::min(x, y), std::min(n - 1 - x, n - 1 - y)) < 32)
+                    edge.push_back({ x, y });
+            }
+        }
+
+        std::vector<world::TilePoint> from(QUERIES);
+        for (int q = 0; q < QUERIES; ++q)
+            from[static_cast<size_t>(q)] = edge[SplitMix64(SEED + q) % edge.size()];
+
+        world::PathScratch scratch;
+        std::vector<world::TilePoint> path;
+        long long abstractCost = 0;
+        const double abstractMs = bench::BestMs(1, [&]
+        {
+            for (const world::TilePoint& f : from)
+                abstractCost += graph.FindAbstractPath(f, core, scratch, scratch.waypoints);
+        });
+
+        long long refinedCost = 0;
+        long long exactCost = 0;
+        int invalid = 0;
+        const double refinedMs = bench::BestMs(1, [&]
+        {
+            for (const world::TilePoint& f : from)
+                refinedCost += graph.FindPath(f, core, scratch, path);
+        });
+        for (const world::TilePoint& f : from)
+        {
+            const int cost = graph.FindPath(f, core, scratch, path);
+            invalid += !ValidPath(graph, path, f, core, cost);
+            exactCost += exact[static_cast<size_t>(f.y) * n + f.x];
+        }
+
+        std::printf("  cluster %2d: build %6.1f ms, %zu nodes, %zu edges\n", clusterSize, buildMs, graph.NodeCount(),
+            graph.EdgeCount());
+        std::printf("    edge -> Core: %7.0f queries/s abstract, %7.0f queries/s with tile paths, "
+            "%.1f%% longer than shortest, %s\n", QUERIES / (abstractMs / 1000.0), QUERIES / (refinedMs / 1000.0),
+            100.0 * (static_cast<double>(refinedCost) / exactCost - 1.0), invalid ? "[INVALID PATHS]" : "paths valid");
+
+        // The core digs: open rock next to the dungeon, or wall off floor
+        uint64_t rng = SEED ^ 0xD16u;
+        double repairMs = 0.0;
+        size_t rebuilt = 0;
+        for (int e = 0; e < EDITS;)
+        {
+            rng = SplitMix64(rng);
+            const int x = 1 + static_cast<int>(rng % (n - 2));
+            const int y = 1 + static_cast<int>((rng >> 32) % (n - 2));
+            const bool walkable = graph.IsWalkable(x, y);
+            const bool nearOpen = graph.IsWalkable(x + 1, y) || graph.IsWalkable(x - 1, y) || graph.IsWalkable(x, y + 1)
+                || graph.IsWalkable(x, y - 1);
+            if (!walkable && !nearOpen)
+                continue;
+            if (x == core.x && y == core.y)
+                continue;
+
+            const TileType type = walkable ? TileType::Wall : TileType::Floor;
+            volume.Set(x, y, LEVEL, type);
+            repairMs += bench::BestMs(1, [&]
+            {
+                graph.SetWalkable(x, y, world::Walkable(type));
+                rebuilt += graph.Repair();
+            });
+            ++e;
+        }
+
+        // The repaired graph has to answer exactly like a fresh one
+        world::PathGraph fresh(n, n, clusterSize);
+        fresh.LoadLevel(volume, LEVEL, pool);
+        world::PathScratch freshScratch;
+        int differ = 0;
+        for (int q = 0; q < 2000; ++q)
+        {
+            const world::TilePoint a = open[SplitMix64(SEED * 3 + q) % open.size()];
+            const world::TilePoint b = open[SplitMix64(SEED * 5 + q) % open.size()];
+            differ += graph.FindPath(a, b, scratch, path) != fresh.FindPath(a, b, freshScratch, path);
+        }
+
+        const double repairEach = repairMs / EDITS;
+        std::printf("    dig/fill:   %.3f ms per tile (%.1f clusters rebuilt), %.0fx cheaper than a rebuild, %s\n",
+            repairEach, static_cast<double>(rebuilt) / EDITS, buildMs / repairEach,
+            differ ? "[DIFFERS FROM REBUILD]" : "same answers as a rebuild");
+    }
+}
+
+namespace bench
+{
+    world::TilePoint DigDungeon(world::TileVolume& volume, int n, int level)
+    {
+        const int block = 32;
+        const int blocks = n / block;
+        std::vector<world::TilePoint> centers(static_cast<size_t>(blocks) * blocks);
+
+        uint64_t rng = SEED;
+        const auto next = [&](int below)
+        {
+            rng = SplitMix64(rng);
+            return static_cast<int>(rng % static_cast<uint64_t>(below));
+        };
+
+        for (int by = 0; by < blocks; ++by)
+        {
+            for (int bx = 0; bx < blocks; ++bx)
+            {
+                const int rw = 6 + next(20);
+                const int rh = 6 + next(20);
+                const int x0 = bx * block + 1 + next(block - rw - 1);
+                const int y0 = by * block + 1 + next(block - rh - 1);
+                for (int y = y0; y < y0 + rh; ++y)
+                {
+                    for (int x = x0; x < x0 + rw; ++x)
+                        volume.Set(x, y, level, TileType::Floor);
+                }
+                centers[static_cast<size_t>(by) * blocks + bx] = { x0 + rw / 2, y0 + rh / 2 };
+            }
+        }
+
+        const auto corridor = [&](world::TilePoint a, world::TilePoint b)
+        {
+            for (int x = std::min(a.x, b.x); x <= std::max(a.x, b.x); ++x)
+                volume.Set(x, a.y, level, TileType::Floor);
+            for (int y = std::min(a.y, b.y); y <= std::max(a.y, b.y); ++y)
+                volume.Set(b.x, y, level, TileType::Floor);
+        };
+        for (int by = 0; by < blocks; ++by)
+        {
+            for (int bx = 0; bx < blocks; ++bx)
+            {
+                const world::TilePoint c = centers[static_cast<size_t>(by) * blocks + bx];
+                if (bx + 1 < blocks && next(100) < 85)
+                    corridor(c, centers[static_cast<size_t>(by) * blocks + bx + 1]);
+                if (by + 1 < blocks && next(100) < 85)
+                    corridor(c, centers[static_cast<size_t>(by + 1) * blocks + bx]);
+            }
+        }
+
+        const world::TilePoint core = centers[static_cast<size_t>(blocks / 2) * blocks + blocks / 2];
+        volume.Set(core.x, core.y, level, TileType::Core);
+        return core;
+    }
+
+    void Paths()
+    {
+        ThreadPool pool(0);
+        std::printf("HPA* on a 1024x1024 rooms-and-corridors level (%d threads)\n", pool.ThreadCount());
+        for (const int clusterSize : { 16, 32 })
+            Hierarchical(pool, clusterSize);
+    }
+}
@@ -0,0 +1,113 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/SitePlacement.h"
+#include "world/WorldGen.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+
+    // Closest pair measured against the larger radius, via a coarse bucket
+    // grid: 1.0 or more means no two sites violate their spacing
+    float WorstSpacing(const std::vector<world::SitePoint>& sites, int w, int h, float maxRadius)
+    {
+        const int bw = static_cast<int>(std::ceil(w / maxRadius));
+        const int bh = static_cast<int>(std::ceil(h / maxRadius));
+        std::vector<std::vector<int>> buckets(static_cast<size_t>(bw) * bh);
+        for (size_t i = 0; i < sites.size(); ++i)
+        {
+            const int bx = static_cast<int>(sites[i].x / maxRadius);
+            const int by = static_cast<int>(sites[i].y / maxRadius);
+            buckets[static_cast<size_t>(by) * bw + bx].push_back(static_cast<int>(i));
+        }
+
+        float worst = 1e30f;
+        for (size_t i = 0; i < sites.size(); ++i)
+        {
+            const int bx = static_cast<int>(sites[i].x / maxRadius);
+            const int by = static_cast<int>(sites[i].y / maxRadius);
+            for (int y = std::max(by - 1, 0); y <= std::min(by + 1, bh - 1); ++y)
+            {
+                for (int x = std::max(bx - 1, 0); x <= std::min(bx + 1, bw - 1); ++x)
+                {
+                    for (int j : buckets[static_cast<size_t>(y) * bw + x])
+                    {
+                        if (j == static_cast<int>(i))
+                            continue;
+                        const float dx = sites[i].x - sites[static_cast<size_t>(j)].x;
+                        const float dy = sites[i].y - sites[static_cast<size_t>(j)].y;
+                        const float need = std::max(sites[i].radius, sites[static_cast<size_t>(j)].radius);
+                        worst = std::min(worst, std::sqrt(dx * dx + dy * dy) / need);
+                    }
+                }
+            }
+        }
+        return worst;
+    }
+
+    void Placement(ThreadPool& pool, ThreadPool& serial)
+    {
+        const int n = 4096;
+        const size_t cells = static_cast<size_t>(n) * n;
+
+        world::NoiseParams params = world::ElevationParams(SEED);
+        params.scale = 1024.0f;
+        params.octaves = 7;
+        const std::vector<float> height = world::PerlinFbm2D(n, n, params, pool);
+        const world::BiomeClimate climate = world::WorldClimate(height);
+
+        std::vector<float> suitability(cells);
+        const double suitMs = bench::BestMs(1, [&]
+        {
+            world::SiteSuitability(height.data(), n, n, climate, suitability.data(), pool);
+        });
+
+        const char* DENSITY[] = { "scarce", "low", "middling", "dense", "excessive" };
+        std::printf("Poisson-disk sites, %dx%d (%d threads), suitability %.1f ms\n", n, n, pool.ThreadCount(), suitMs);
+        // The five siteDensity settings, then a spacing that yields ~100k sites
+        for (int density = 0; density <= 5; ++density)
+        {
+            WorldGenSettings settings;
+            settings.siteDensity = density;
+            world::SitePlacementParams p = world::WorldSiteParams(settings, SEED);
+            if (density == 5)
+            {
+                p.minRadius = 4.0f;
+                p.maxRadius = 10.0f;
+            }
+
+            std::vector<world::SitePoint> sites;
+            const double ms = bench::BestMs(1, [&] { sites = world::PlaceSites(suitability.data(), n, n, p, pool); });
+            const std::vector<world::SitePoint> reference = world::PlaceSites(suitability.data(), n, n, p, serial);
+
+            bool same = sites.size() == reference.size();
+            for (size_t i = 0; same && i < sites.size(); ++i)
+                same = sites[i].x == reference[i].x && sites[i].y == reference[i].y;
+
+            size_t kinds[3] = {};
+            for (const world::SitePoint& s : sites)
+                ++kinds[static_cast<int>(s.kind)];
+
+            std::printf("  %-9s radius %4.1f..%4.1f  %7zu sites in %7.1f ms (%4.1f M sites/s)  "
+                "%zu cities, %zu lairs, %zu dungeons, closest %.3f x radius, %s\n",
+                (density < 5) ? DENSITY[density] : "(100k)", p.minRadius, p.maxRadius, sites.size(), ms, sites.size() / (ms * 1000.0),
+                kinds[0], kinds[1], kinds[2], WorstSpacing(sites, n, n, p.maxRadius),
+                same ? "same as 1 thread" : "[DIFFERS FROM 1 THREAD]");
+        }
+    }
+}
+
+namespace bench
+{
+    void Sites()
+    {
+        ThreadPool pool(0);
+        ThreadPool serial(1);
+        Placement(pool, serial);
+    }
+}
@@ -0,0 +1,169 @@
+#include "Bench.h"
+#include "world/SpatialGrid.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t SEED = 0xC0FFEEu;
+    constexpr float WORLD = 1024.0f;
+    constexpr float RADIUS = 16.0f;
+    constexpr int NEAREST = 8;
+    constexpr int QUERIES = 1000;
+
+    float Unit(uint64_t h)
+    {
+        return static_cast<float>(h >> 40) / static_cast<float>(1ull << 24);
+    }
+
+    // Half the entities in clumps (squads, swarms around the Core), half spread out
+    void Scatter(size_t count, std::vector<float>& x, std::vector<float>& y)
+    {
+        x.resize(count);
+        y.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t h = SplitMix64(SEED + i);
+            if (i % 2 == 0)
+            {
+                x[i] = Unit(h) * WORLD;
+                y[i] = Unit(SplitMix64(h)) * WORLD;
+            }
+            else
+            {
+                const uint64_t clump = SplitMix64(SEED ^ (i % 64));
+                x[i] = std::clamp(Unit(clump) * WORLD + (Unit(h) - 0.5f) * 48.0f, 0.0f, WORLD - 1.0f);
+                y[i] = std::clamp(Unit(SplitMix64(clump)) * WORLD + (Unit(SplitMix64(h)) - 0.5f) * 48.0f, 0.0f,
+                    WORLD - 1.0f);
+            }
+        }
+    }
+
+    void BruteRadius(const std::vector<float>& x, const std::vector<float>& y, float qx, float qy,
+        std::vector<uint32_t>& out)
+    {
+        out.clear();
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const float dx = x[i] - qx;
+            const float dy = y[i] - qy;
+            if (dx * dx + dy * dy <= RADIUS * RADIUS)
+                out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    void BruteNearest(const std::vector<float>& x, const std::vector<float>& y, float qx, float qy,
+        std::vector<std::pair<float, uint32_t>>& all, std::vector<uint32_t>& out)
+    {
+        all.clear();
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            const float dx = x[i] - qx;
+            const float dy = y[i] - qy;
+            all.push_back({ dx * dx + dy * dy, static_cast<uint32_t>(i) });
+        }
+        const size_t k = std::min<size_t>(NEAREST, all.size());
+        std::partial_sort(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(k), all.end());
+        out.clear();
+        for (size_t i = 0; i < k; ++i)
+            out.push_back(all[i].second);
+    }
+
+    void Population(size_t count)
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        Scatter(count, x, y);
+
+        world::SpatialGrid grid(WORLD, WORLD, RADIUS);
+        const double buildMs = bench::BestMs(5, [&] { grid.Build(x.data(), y.data(), count); });
+
+        // Queries centred on entities, like aggro and separation checks
+        std::vector<uint32_t> queries(QUERIES);
+        for (int q = 0; q < QUERIES; ++q)
+            queries[static_cast<size_t>(q)] = static_cast<uint32_t>(SplitMix64(SEED * 7 + q) % count);
+
+        std::vector<uint32_t> out;
+        std::vector<std::pair<float, uint32_t>> scratch;
+        size_t found = 0;
+        const double radiusMs = bench::BestMs(3, [&]
+        {
+            found = 0;
+            for (const uint32_t e : queries)
+            {
+                grid.QueryRadius(x[e], y[e], RADIUS, out);
+                found += out.size();
+            }
+        });
+        const double nearestMs = bench::BestMs(3, [&]
+        {
+            for (const uint32_t e : queries)
+                grid.Nearest(x[e], y[e], NEAREST, out, scratch);
+        });
+
+        std::vector<uint32_t> expected;
+        const double bruteRadiusMs = bench::BestMs(1, [&]
+        {
+            for (const uint32_t e : queries)
+                BruteRadius(x, y, x[e], y[e], expected);
+        });
+        const double bruteNearestMs = bench::BestMs(1, [&]
+        {
+            for (const uint32_t e : queries)
+                BruteNearest(x, y, x[e], y[e], scratch, expected);
+        });
+
+        // Same sets as brute force; nearest compared by distance, as ties may
+        // pick different ids
+        int differ = 0;
+        for (const uint32_t e : queries)
+        {
+            grid.QueryRadius(x[e], y[e], RADIUS, out);
+            BruteRadius(x, y, x[e], y[e], expected);
+            std::sort(out.begin(), out.end());
+            differ += out != expected;
+
+            grid.Nearest(x[e], y[e], NEAREST, out, scratch);
+            BruteNearest(x, y, x[e], y[e], scratch, expected);
+            if (out.size() != expected.size())
+            {
+                ++differ;
+                continue;
+            }
+            for (size_t i = 0; i < out.size(); ++i)
+            {
+                const auto d2 = [&](uint32_t id)
+                {
+                    const float dx = x[id] - x[e];
+                    const float dy = y[id] - y[e];
+                    return dx * dx + dy * dy;
+                };
+                if (d2(out[i]) != d2(expected[i]))
+                {
+                    ++differ;
+                    break;
+                }
+            }
+        }
+
+        const auto perQuery = [](double ms) { return ms * 1000.0 / QUERIES; };
+        std::printf("  %6zu entities: rebuild %6.3f ms, %.1f within radius on average\n", count, buildMs,
+            static_cast<double>(found) / QUERIES);
+        std::printf("    radius %5.2f us/query (brute force %7.2f us), %d-nearest %5.2f us/query (brute force %7.2f us), "
+            "%s\n", perQuery(radiusMs), perQuery(bruteRadiusMs), NEAREST, perQuery(nearestMs),
+            perQuery(bruteNearestMs), differ ? "[DIFFERS FROM BRUTE FORCE]" : "same results as brute force");
+    }
+}
+
+namespace bench
+{
+    void Spatial()
+    {
+        std::printf("Uniform grid, %.0fx%.0f world, %.0f-tile cells, radius %.0f\n", WORLD, WORLD, RADIUS, RADIUS);
+        for (const size_t count : { 1000, 10000, 100000 })
+            Population(count);
+    }
+}
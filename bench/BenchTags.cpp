@@ -0,0 +1,142 @@
+#include "Bench.h"
+#include "core/Config.h"
+#include "world/HistoryData.h"
+#include "world/TagIndex.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int ENTRIES = 200000;
+    constexpr int TAGS = 40;
+    constexpr int QUERIES = 64;
+
+    uint64_t Next(uint64_t& s)
+    {
+        s = s * 6364136223846793005ull + 1442695040888963407ull;
+        return s >> 33;
+    }
+
+    // What the index replaces: scan every entry per sample, pick the k-th match
+    int64_t ScanSample(const world::TagIndex& index, const world::TagSet& q, uint64_t key)
+    {
+        size_t matches = 0;
+        for (size_t e = 0; e < index.EntryCount(); ++e)
+            matches += index.Tags(static_cast<uint32_t>(e)).Contains(q);
+        if (matches == 0)
+            return -1;
+
+        size_t k = static_cast<size_t>(key % matches);
+        for (size_t e = 0; e < index.EntryCount(); ++e)
+        {
+            if (index.Tags(static_cast<uint32_t>(e)).Contains(q) && k-- == 0)
+                return static_cast<int64_t>(e);
+        }
+        return -1;
+    }
+
+    void AssetNames()
+    {
+        world::HistoryData data;
+        std::string error;
+        for (const char* path : cfg::HistoryDataPaths)
+        {
+            if (!data.Load(path, error))
+            {
+                std::printf("Asset names: %s (run from the repository root)\n", error.c_str());
+                return;
+            }
+        }
+
+        world::TagIndex index = world::TagIndex::FromNames(data);
+        std::printf("Asset names: %zu entries, %zu tags\n", index.EntryCount(), data.Tags().Count());
+
+        const std::initializer_list<std::string_view> queries[] = {
+            { "elf", "female", "firstname" }, { "human", "male", "firstname" }, { "city", "elf" }, { "LegendaryItem" },
+            { "dwarf", "firstname" } };
+        for (const auto& q : queries)
+        {
+            const world::TagIndex::QueryId id = index.Prepare(data.Tags(), q);
+            std::printf("  %zu match", index.Matches(id).size());
+            for (std::string_view t : q)
+                std::printf(" %.*s", static_cast<int>(t.size()), t.data());
+            const int64_t e = index.Sample(id, 42);
+            if (e >= 0)
+            {
+                const std::string_view name = data.Names()[static_cast<size_t>(e)].text;
+                std::printf(", e.g. %.*s", static_cast<int>(name.size()), name.data());
+            }
+            std::printf("\n");
+        }
+    }
+
+    void Synthetic()
+    {
+        // Entries carry 2-6 tags, low tag ids far more common than high ones
+        world::TagIndex index;
+        uint64_t rng = 7;
+        for (int e = 0; e < ENTRIES; ++e)
+        {
+            world::TagId tags[6];
+            const int count = 2 + static_cast<int>(Next(rng) % 5);
+            for (int t = 0; t < count; ++t)
+            {
+                const uint64_t r = Next(rng) % (TAGS * TAGS);
+                tags[t] = static_cast<world::TagId>(TAGS - 1 - static_cast<int>(r / TAGS) * static_cast<int>(r % TAGS) / TAGS);
+            }
+            index.Add(tags, static_cast<size_t>(count));
+        }
+
+        std::vector<world::TagSet> queries(QUERIES);
+        for (world::TagSet& q : queries)
+        {
+            const int count = 1 + static_cast<int>(Next(rng) % 3);
+            for (int t = 0; t < count; ++t)
+                q.Set(static_cast<world::TagId>(Next(rng) % 12 + TAGS - 12));
+        }
+
+        std::vector<world::TagIndex::QueryId> ids(QUERIES);
+        const double prepareMs = bench::BestMs(1, [&]
+        {
+            for (int q = 0; q < QUERIES; ++q)
+                ids[q] = index.Prepare(queries[q]);
+        });
+
+        size_t matches = 0;
+        for (world::TagIndex::QueryId id : ids)
+            matches += index.Matches(id).size();
+
+        const int samples = 4000000;
+        int64_t sink = 0;
+        const double sampleMs = bench::BestMs(3, [&]
+        {
+            for (int i = 0; i < samples; ++i)
+                sink += index.Sample(ids[i % QUERIES], static_cast<uint64_t>(i));
+        });
+
+        const int scans = 2000;
+        const double scanMs = bench::BestMs(1, [&]
+        {
+            for (int i = 0; i < scans; ++i)
+                sink += ScanSample(index, queries[i % QUERIES], static_cast<uint64_t>(i));
+        });
+
+        const double sampleNs = sampleMs * 1e6 / samples;
+        const double scanNs = scanMs * 1e6 / scans;
+        std::printf("Synthetic: %d entries, %d tags, %d conjunctions (%.0f matches on average)\n", ENTRIES, TAGS,
+            QUERIES, static_cast<double>(matches) / QUERIES);
+        std::printf("  prepare %.2f ms for all, then %.1f ns per sample; linear scan %.0f ns per sample (x%.0f), "
+            "checksum %lld\n", prepareMs, sampleNs, scanNs, scanNs / sampleNs, static_cast<long long>(sink));
+    }
+}
+
+namespace bench
+{
+    void Tags()
+    {
+        AssetNames();
+        Synthetic();
+    }
+}
@@ -0,0 +1,145 @@
+#include "Bench.h"
+#include "core/Config.h"
+#include "world/HistoryData.h"
+#include "world/HistoryTemplates.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int EXPANSIONS = 2000000;
+
+    uint64_t Fnv(std::string_view s, uint64_t h)
+    {
+        for (char c : s)
+        {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001B3ull;
+        }
+        return h;
+    }
+
+    // Find/replace on std::string, drawing from the same lists per slot
+    struct NaiveTemplates
+    {
+        std::vector<std::string> templates;
+        std::vector<std::pair<std::string, std::vector<std::string>>> slots;
+
+        std::string Expand(uint64_t key) const
+        {
+            std::string s = templates[key % templates.size()];
+            for (const auto& [name, values] : slots)
+            {
+                const std::string placeholder = "{" + name + "}";
+                for (size_t at = s.find(placeholder); at != std::string::npos; at = s.find(placeholder))
+                {
+                    key = key * 6364136223846793005ull + 1442695040888963407ull;
+                    s.replace(at, placeholder.size(), values[(key >> 33) % values.size()]);
+                }
+            }
+            return s;
+        }
+    };
+
+    void Expansion()
+    {
+        world::HistoryData data;
+        std::string error;
+        for (const char* path : cfg::HistoryDataPaths)
+        {
+            if (!data.Load(path, error))
+            {
+                std::printf("  %s (run from the repository root)\n", error.c_str());
+                return;
+            }
+        }
+
+        world::TemplateSet set;
+        if (!set.Compile(data, error))
+        {
+            std::printf("  %s\n", error.c_str());
+            return;
+        }
+
+        const int groups = set.GroupCount();
+        std::printf("Template expansion: %d groups, %d slots, %d expansions\n", groups, set.SlotCount(), EXPANSIONS);
+
+        world::TextArena arena;
+        const double ms = bench::BestMs(3, [&]
+        {
+            arena.Clear();
+            for (int i = 0; i < EXPANSIONS; ++i)
+                set.Expand(i % groups, static_cast<uint64_t>(i), arena);
+        });
+        const size_t bytes = arena.BytesUsed();
+
+        // Reproducibility: two passes over the same keys hash the same
+        uint64_t hashes[2] = {};
+        for (uint64_t& hash : hashes)
+        {
+            arena.Clear();
+            hash = 0xCBF29CE484222325ull;
+            for (int i = 0; i < EXPANSIONS; ++i)
+                hash = Fnv(set.Expand(i % groups, static_cast<uint64_t>(i), arena), hash);
+        }
+
+        std::printf("  compiled  %7.1f ms  %6.2f M expansions/s  %.1f MB of text, %s\n", ms,
+            EXPANSIONS / (ms * 1000.0), bytes / double(1 << 20),
+            (hashes[0] == hashes[1]) ? "same text on rerun" : "[TEXT DIFFERS ON RERUN]");
+
+        // The same templates and slot lists as strings
+        NaiveTemplates naive;
+        for (const world::HistoryTemplate& t : data.Templates())
+            naive.templates.emplace_back(t.text);
+        for (const char* slot : { "concept", "descriptor", "group", "kingdom", "city" })
+        {
+            std::vector<std::string> values;
+            const world::HistoryList* pool = data.FindPool(std::string(slot) + "s");
+            if (!pool)
+                pool = data.FindPool("cities");
+            if (pool)
+            {
+                for (uint32_t i = 0; i < pool->count; ++i)
+                    values.emplace_back(data.PoolEntries()[pool->first + i]);
+            }
+            if (values.empty())
+                values.emplace_back(slot);
+            naive.slots.emplace_back(slot, values);
+        }
+
+        size_t naiveBytes = 0;
+        const double naiveMs = bench::BestMs(3, [&]
+        {
+            naiveBytes = 0;
+            for (int i = 0; i < EXPANSIONS; ++i)
+                naiveBytes += naive.Expand(static_cast<uint64_t>(i)).size();
+        });
+        std::printf("  find/replace %7.1f ms  %6.2f M expansions/s  x%.1f slower\n", naiveMs,
+            EXPANSIONS / (naiveMs * 1000.0), naiveMs / ms);
+
+        // Bound slots: an event names its actual city
+        const int falls = set.FindGroup("FALLS");
+        const int city = set.FindSlot("city");
+        std::vector<std::string_view> bound(static_cast<size_t>(set.SlotCount()));
+        if (city >= 0)
+            bound[static_cast<size_t>(city)] = "Fourdock";
+
+        std::printf("  samples (seeded):");
+        for (uint64_t key = 0; key < 4; ++key)
+        {
+            const std::string_view text = set.Expand(falls, key, arena, bound.data());
+            std::printf(" \"%.*s\"", static_cast<int>(text.size()), text.data());
+        }
+        std::printf("\n");
+    }
+}
+
+namespace bench
+{
+    void Templates()
+    {
+        Expansion();
+    }
+}
@@ -0,0 +1,107 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/SitePlacement.h"
+#include "world/Territory.h"
+#include "world/WorldGen.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SEED = 0xC0FFEEu;
+    constexpr int UPDATES = 200;
+
+    void Incremental(ThreadPool& pool)
+    {
+        const int n = 2048;
+        const size_t cells = static_cast<size_t>(n) * n;
+
+        world::NoiseParams params = world::ElevationParams(SEED);
+        params.scale = 512.0f;
+        params.octaves = 7;
+        const std::vector<float> height = world::PerlinFbm2D(n, n, params, pool);
+        const world::BiomeClimate climate = world::WorldClimate(height);
+
+        std::vector<float> suitability(cells);
+        world::SiteSuitability(height.data(), n, n, climate, suitability.data(), pool);
+        const std::vector<world::SitePoint> sites =
+            world::PlaceSites(suitability.data(), n, n, world::WorldSiteParams(WorldGenSettings{}, SEED), pool);
+
+        std::vector<uint8_t> cost(cells);
+        world::TerritoryCost(height.data(), n, n, climate, cost.data(), pool);
+
+        world::Territory territory(cost.data(), n, n);
+        for (const world::SitePoint& s : sites)
+            territory.AddSite(static_cast<int>(s.x), static_cast<int>(s.y));
+
+        const double fullMs = bench::BestMs(3, [&] { territory.Compute(); });
+        const size_t fullSettled = territory.LastSettled();
+
+        size_t claimed = 0;
+        for (const int32_t s : territory.Sites())
+            claimed += (s >= 0);
+
+        std::printf("Territory, %dx%d, %zu sites: full recompute %.1f ms (%zu cells claimed)\n",
+            n, n, sites.size(), fullMs, claimed);
+
+        // Sites fall at random...
+        std::vector<int> alive(sites.size());
+        for (size_t i = 0; i < alive.size(); ++i)
+            alive[i] = static_cast<int>(i);
+
+        uint64_t rng = SEED;
+        size_t removedSettled = 0;
+        const double removeMs = bench::BestMs(1, [&]
+        {
+            for (int u = 0; u < UPDATES; ++u)
+            {
+                rng = SplitMix64(rng);
+                const size_t k = static_cast<size_t>(rng % alive.size());
+                territory.RemoveSite(alive[k]);
+                removedSettled += territory.LastSettled();
+                alive[k] = alive.back();
+                alive.pop_back();
+            }
+        });
+
+        // ...and new ones are founded on land
+        size_t addedSettled = 0;
+        const double addMs = bench::BestMs(1, [&]
+        {
+            for (int u = 0; u < UPDATES;)
+            {
+                rng = SplitMix64(rng);
+                const int x = static_cast<int>(rng % n);
+                const int y = static_cast<int>((rng >> 32) % n);
+                if (cost[static_cast<size_t>(y) * n + x] == 0)
+                    continue;
+                territory.AddSite(x, y);
+                addedSettled += territory.LastSettled();
+                ++u;
+            }
+        });
+
+        world::Territory reference = territory;
+        reference.Compute();
+        const bool same = reference.Sites() == territory.Sites() && reference.Distances() == territory.Distances();
+
+        const double removeEach = removeMs / UPDATES;
+        const double addEach = addMs / UPDATES;
+        std::printf("  fall:    %8.3f ms each (%7zu cells settled on average)  %6.0fx cheaper than a recompute\n",
+            removeEach, removedSettled / UPDATES, fullMs / removeEach);
+        std::printf("  found:   %8.3f ms each (%7zu cells settled on average)  %6.0fx cheaper than a recompute\n",
+            addEach, addedSettled / UPDATES, fullMs / addEach);
+        std::printf("  full recompute settles %zu cells; after %d falls and %d foundings: %s\n",
+            fullSettled, UPDATES, UPDATES, same ? "same as a full recompute" : "[DIFFERS FROM FULL RECOMPUTE]");
+    }
+}
+
+namespace bench
+{
+    void Territory()
+    {
+        ThreadPool pool(0);
+        Incremental(pool);
+    }
+}
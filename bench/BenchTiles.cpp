@@ -0,0 +1,167 @@
+#include "Bench.h"
+#include "world/TileVolume.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t SEED = 0xC0FFEEu;
+    constexpr int LOOKUPS = 1 << 22;
+
+    uint64_t Hash(int x, int y, int z)
+    {
+        return SplitMix64(SEED ^ (static_cast<uint64_t>(x) << 40) ^ (static_cast<uint64_t>(y) << 20) ^ static_cast<uint64_t>(z));
+    }
+
+    // A fortress dug into solid rock: one level in every 32 z, corridors on
+    // a 128-tile lattice, walled rooms at some crossings
+    TileType Fortress(int x, int y, int z)
+    {
+        if (z % 32 != 8)
+            return TileType::Rock;
+
+        const int lx = x % 128 - 64;
+        const int ly = y % 128 - 64;
+        const int ax = std::abs(lx);
+        const int ay = std::abs(ly);
+        const uint64_t room = Hash(x / 128, y / 128, z);
+
+        if ((room & 3) != 0 && ax <= 12 && ay <= 12)
+        {
+            if (ax == 12 || ay == 12)
+                return (ax <= 1 || ay <= 1) ? TileType::Floor : TileType::Wall;
+            if (lx == -8 && ly == -8)
+                return TileType::Spawner;
+            if (lx == 0 && ly == 0 && (room >> 8) % 64 == 0)
+                return TileType::Core;
+            return TileType::Floor;
+        }
+
+        if (ax <= 1 || ay <= 1)
+            return TileType::Floor;
+        if (ax == 2 || ay == 2)
+            return TileType::Wall;
+        return TileType::Rock;
+    }
+
+    // Caverns everywhere: about half the volume is open
+    TileType Caverns(int x, int y, int z)
+    {
+        const float s = std::sin(x * 0.031f + 1.7f * std::sin(z * 0.05f)) + std::sin(y * 0.027f + x * 0.011f)
+            + std::sin(z * 0.09f + y * 0.013f);
+        if (s > 0.15f)
+            return (Hash(x, y, z) % 4096 == 0) ? TileType::Spawner : TileType::Floor;
+        return (s > 0.0f) ? TileType::Wall : TileType::Rock;
+    }
+
+    template <class Gen>
+    void Scenario(const char* name, int w, int h, int d, int levelStep, int levelOffset, Gen&& gen)
+    {
+        world::TileVolume volume(w, h, d);
+        const double tiles = static_cast<double>(w) * h * d;
+
+        // Levels are generated untimed, then written tile by tile
+        size_t dug = 0;
+        double buildMs = 0.0;
+        std::vector<TileType> layer(static_cast<size_t>(w) * h);
+        for (int z = levelOffset; z < d; z += levelStep)
+        {
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                    layer[static_cast<size_t>(y) * w + x] = gen(x, y, z);
+            }
+
+            buildMs += bench::BestMs(1, [&]
+            {
+                for (int y = 0; y < h; ++y)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        const TileType t = layer[static_cast<size_t>(y) * w + x];
+                        if (t != TileType::Rock)
+                        {
+                            volume.Set(x, y, z, t);
+                            ++dug;
+                        }
+                    }
+                }
+            });
+        }
+        const size_t grownBytes = volume.MemoryBytes();
+        const double compactMs = bench::BestMs(1, [&] { volume.Compact(); });
+        const size_t bytes = volume.MemoryBytes();
+        const size_t allocated = volume.AllocatedChunks();
+
+        std::vector<int> coords(static_cast<size_t>(LOOKUPS) * 3);
+        for (size_t i = 0; i < static_cast<size_t>(LOOKUPS); ++i)
+        {
+            const uint64_t r = SplitMix64(SEED + i);
+            coords[i * 3 + 0] = static_cast<int>(r % w);
+            coords[i * 3 + 1] = static_cast<int>((r >> 20) % h);
+            coords[i * 3 + 2] = static_cast<int>((r >> 40) % d);
+        }
+
+        size_t wrong = 0;
+        for (size_t i = 0; i < static_cast<size_t>(LOOKUPS); ++i)
+        {
+            const int x = coords[i * 3 + 0], y = coords[i * 3 + 1], z = coords[i * 3 + 2];
+            wrong += volume.Get(x, y, z) != gen(x, y, z);
+        }
+
+        uint64_t sum = 0;
+        const double randomMs = bench::BestMs(3, [&]
+        {
+            for (size_t i = 0; i < static_cast<size_t>(LOOKUPS); ++i)
+                sum += static_cast<uint64_t>(volume.Get(coords[i * 3 + 0], coords[i * 3 + 1], coords[i * 3 + 2]));
+        });
+
+        // Row-order scan of one dug level
+        const int level = levelOffset;
+        const double scanMs = bench::BestMs(3, [&]
+        {
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                    sum += static_cast<uint64_t>(volume.Get(x, y, level));
+            }
+        });
+
+        // Filling everything back in has to release every chunk
+        for (int z = levelOffset; z < d; z += levelStep)
+        {
+            for (int y = 0; y < h; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    if (gen(x, y, z) != TileType::Rock)
+                        volume.Set(x, y, z, TileType::Rock);
+                }
+            }
+        }
+        const size_t leftover = volume.AllocatedChunks();
+
+        std::printf("  %-9s %dx%dx%d, %5.1f%% dug: %zu of %zu chunks allocated\n", name, w, h, d, 100.0 * dug / tiles,
+            allocated, volume.ChunkSlots());
+        std::printf("            %8.1f MB (%.3f bytes/tile, %.2f bytes/dug tile) vs %.0f MB dense; %.1f MB before Compact\n",
+            bytes / 1048576.0, bytes / tiles, dug ? static_cast<double>(bytes) / dug : 0.0, tiles / 1048576.0,
+            grownBytes / 1048576.0);
+        std::printf("            build %.0f ms (%.1f ns/Set), compact %.0f ms, Get %.2f ns random / %.2f ns scanning, "
+            "%s (checksum %llx)\n"
+            "            refilled with rock: %zu chunks left allocated\n", buildMs, buildMs * 1e6 / (dug ? dug : 1), compactMs, randomMs * 1e6 / LOOKUPS,
+            scanMs * 1e6 / (static_cast<double>(w) * h), wrong ? "[MISMATCH]" : "matches the generator",
+            static_cast<unsigned long long>(sum), leftover);
+    }
+}
+
+namespace bench
+{
+    void Tiles()
+    {
+        std::printf("Chunked tile volume (%d^3 chunks, 1 byte per tile when dense)\n", world::TileVolume::ChunkEdge);
+        Scenario("fortress", 1024, 1024, 256, 32, 8, Fortress);
+        Scenario("caverns", 1024, 1024, 64, 1, 0, Caverns);
+    }
+}
@@ -0,0 +1,167 @@
+#include "Bench.h"
+#include "core/ThreadPool.h"
+#include "world/Hydrology.h"
+#include "world/WorldFile.h"
+#include "world/WorldGen.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string ScratchPath(const char* name)
+    {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // A world of any size with every layer (GenerateWorld() stops at the
+    // largest world setting); erosion is left out to keep big sizes quick
+    world::WorldMap MakeWorld(int n, ThreadPool& pool)
+    {
+        world::WorldMap map;
+        map.settings.worldSize = 4;
+        map.settings.worldVolatility = 3;
+        map.seed = 0xC0FFEEu;
+        map.width = n;
+        map.height = n;
+
+        const size_t cells = static_cast<size_t>(n) * n;
+        map.elevation.resize(cells);
+        map.temperature.resize(cells);
+        map.moisture.resize(cells);
+        map.volatility.resize(cells);
+        map.biome.resize(cells);
+
+        const world::NoiseParams params[] = { world::ElevationParams(map.seed), world::TemperatureParams(map.seed),
+            world::MoistureParams(map.seed), world::VolatilityParams(map.seed) };
+        float* const fields[] = { map.elevation.data(), map.temperature.data(), map.moisture.data(), map.volatility.data() };
+        world::PerlinFbm2DMulti(fields, params, 4, n, n, pool);
+        const world::BiomeClimate climate = world::WorldClimate(map.elevation);
+        world::ClassifyBiomes(map.elevation.data(), map.temperature.data(), map.moisture.data(), cells,
+            climate, map.biome.data(), pool);
+        map.flow = world::ComputeHydrology(map.elevation.data(), n, n, climate.seaLevel, pool).flow;
+        return map;
+    }
+
+    bool SameWorld(const world::WorldMap& a, const world::WorldMap& b)
+    {
+        return a.seed == b.seed && a.width == b.width && a.height == b.height
+            && a.settings.worldSize == b.settings.worldSize
+            && a.settings.historyLength == b.settings.historyLength
+            && a.settings.civilizationSaturation == b.settings.civilizationSaturation
+            && a.settings.siteDensity == b.settings.siteDensity
+            && a.settings.worldVolatility == b.settings.worldVolatility
+            && a.settings.resourceAbundance == b.settings.resourceAbundance
+            && a.settings.monstrousPopulation == b.settings.monstrousPopulation
+            && a.elevation == b.elevation && a.temperature == b.temperature && a.moisture == b.moisture
+            && a.volatility == b.volatility && a.biome == b.biome && a.flow == b.flow;
+    }
+
+    void RoundTrip(ThreadPool& pool)
+    {
+        std::printf("World file round trip (save, mmap open, verify, copy load)\n");
+
+        for (int n : { 257, 768, 2048, 4096 })
+        {
+            const world::WorldMap map = MakeWorld(n, pool);
+            const std::string path = ScratchPath("dd_bench_world.ddw");
+
+            std::string error;
+            bool ok = true;
+            const double saveMs = bench::BestMs(1, [&] { ok = world::SaveWorldFile(path, map, error); });
+            if (!ok)
+            {
+                std::printf("  %4dx%-4d save FAILED: %s\n", n, n, error.c_str());
+                continue;
+            }
+
+            world::WorldFile file;
+            const double openMs = bench::BestMs(5, [&] { ok = file.Open(path, error); });
+            if (!ok)
+            {
+                std::printf("  %4dx%-4d open FAILED: %s\n", n, n, error.c_str());
+                continue;
+            }
+
+            const double verifyMs = bench::BestMs(3, [&] { ok = file.VerifyAll(error); });
+
+            world::WorldMap loaded;
+            const double loadMs = bench::BestMs(3, [&] { ok = ok && file.Load(loaded, error); });
+
+            // Zero-copy point reads must agree with the source grid as well
+            const world::GridView view = file.Grid(world::section::Elevation);
+            bool pointsMatch = view.Valid();
+            for (int i = 0; pointsMatch && i < 4096; ++i)
+            {
+                const int x = (i * 7919) % n;
+                const int y = (i * 104729) % n;
+                pointsMatch = view.At(x, y) == map.elevation[static_cast<size_t>(y) * n + x];
+            }
+
+            const world::ByteGridView biomes = file.ByteGrid(world::section::Biome);
+            for (int i = 0; pointsMatch && i < 4096; ++i)
+            {
+                const int x = (i * 6007) % n;
+                const int y = (i * 7561) % n;
+                pointsMatch = biomes.Valid() && biomes.At(x, y) == map.biome[static_cast<size_t>(y) * n + x];
+            }
+
+            const bool same = ok && pointsMatch && SameWorld(map, loaded);
+            std::printf("  %4dx%-4d %7.1f MB: save %7.2f ms, open %6.3f ms, verify %7.2f ms, load %7.2f ms  %s\n",
+                n, n, std::filesystem::file_size(path) / (1024.0 * 1024.0),
+                saveMs, openMs, verifyMs, loadMs, same ? "round trip OK" : "ROUND TRIP MISMATCH");
+
+            file.Close();
+            std::filesystem::remove(path);
+        }
+    }
+
+    void Corruption(ThreadPool& pool)
+    {
+        const world::WorldMap map = MakeWorld(512, pool);
+        const std::string path = ScratchPath("dd_bench_corrupt.ddw");
+
+        std::string error;
+        world::SaveWorldFile(path, map, error);
+
+        // One flipped bit in the middle of the elevation chunks
+        {
+            std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+            const auto at = static_cast<std::streamoff>(std::filesystem::file_size(path) / 2);
+            char c = 0;
+            f.seekg(at);
+            f.get(c);
+            f.seekp(at);
+            f.put(static_cast<char>(c ^ 0x10));
+        }
+
+        world::WorldFile file;
+        const bool opened = file.Open(path, error);
+        const bool caught = opened && !file.VerifyAll(error);
+        std::printf("Corrupted chunk: opens lazily %s, detected by VerifyAll %s (%s)\n",
+            opened ? "yes" : "NO", caught ? "yes" : "NO", error.c_str());
+        file.Close();
+
+        // Truncation has to be caught by Open() itself
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4096);
+        error.clear();
+        const bool rejected = !file.Open(path, error);
+        std::printf("Truncated file: rejected by Open %s (%s)\n", rejected ? "yes" : "NO", error.c_str());
+
+        file.Close();
+        std::filesystem::remove(path);
+    }
+}
+
+namespace bench
+{
+    void World()
+    {
+        ThreadPool pool(0);
+        RoundTrip(pool);
+        Corruption(pool);
+    }
+}
@@ -3,12 +3,17 @@
 #include "core/Config.h"
 #include "core/Log.h"
 #include "core/GameState.h"
+#include "core/ThreadPool.h"
 #include "input/Input.h"
 #include "gfx/Renderer.h"
 #include "gfx/Font.h"
 #include "ui/Ui.h"
+#include "world/WorldFile.h"
+#include "world/WorldForgeWorker.h"
+#include "world/WorldGen.h"
 
 #include <SDL.h>
+#include <algorithm>
 #include <string>
 
 static uint64_t NowCounter() { return static_cast<uint64_t>(SDL_GetPerformanceCounter()); }
@@ -18,7 +23,26 @@ static double CounterToSeconds(uint64_t delta)
     return static_cast<double>(delta) / freq;
 }
 
-App::App() = default;
+namespace
+{
+    // Speed steps for the faster / slower keys
+    const int SIM_SPEEDS[] = { 1, 2, 5, 10, 25, 50, SimClock::MaxSpeed, SimClock::Unlimited };
+    const int SIM_SPEED_COUNT = static_cast<int>(sizeof(SIM_SPEEDS) / sizeof(SIM_SPEEDS[0]));
+
+    std::string SpeedName(int speed)
+    {
+        if (speed == SimClock::Paused)
+            return "paused";
+        if (speed == SimClock::Unlimited)
+            return "as fast as possible";
+        return std::to_string(speed) + "x";
+    }
+}
+
+App::App()
+    : m_simClock(1.0 / cfg::SimTickHz, cfg::SimTickBudgetMs / 1000.0, cfg::SimMaxFrameMs / 1000.0)
+{
+}
 
 App::~App()
 {
@@ -64,7 +88,12 @@ bool App::Init()
         logx::Warn("Font atlas load failed; text will not render.");
     }
 
-    m_ui = new Ui(*m_font);
+    m_threadPool = new ThreadPool(cfg::WorkerThreads);
+    logx::Info("World-gen threads: " + std::to_string(m_threadPool->ThreadCount()));
+
+    m_ui = new Ui(*m_font, *m_threadPool);
+    m_forge = new world::WorldForgeWorker(*m_threadPool);
+    m_world = new world::WorldFile();
 
     m_statusMessage = "Forge a new realm beneath a celestial sky.";
     m_ui->SetStatusMessage(m_statusMessage);
@@ -76,7 +105,10 @@ bool App::Init()
 
 void App::Shutdown()
 {
+    delete m_world; m_world = nullptr;
+    delete m_forge; m_forge = nullptr;
     delete m_ui; m_ui = nullptr;
+    delete m_threadPool; m_threadPool = nullptr;
     delete m_font; m_font = nullptr;
     delete m_renderer; m_renderer = nullptr;
     delete m_input; m_input = nullptr;
@@ -101,7 +133,6 @@ int App::Run()
         last = now;
 
         const double dt = CounterToSeconds(delta);
-        (void)dt;
 
         m_input->BeginFrame();
         SDL_Event e;
@@ -142,9 +173,17 @@ int App::Run()
                 }
                 else if (sel == 1)
                 {
-                    m_state = GameState::Settings;
+                    // Mid-forge the file is being rewritten (and can't be
+                    // renamed over while mapped on Windows); the forge opens
+                    // it when done, and its progress stays on the status line
+                    if (!m_forge->Busy())
+                        OpenWorld(cfg::WorldSavePath);
                 }
                 else if (sel == 2)
+                {
+                    m_state = GameState::Settings;
+                }
+                else if (sel == 3)
                 {
                     m_running = false;
                 }
@@ -189,6 +228,7 @@ int App::Run()
             {
                 m_pendingSettings = m_ui->GetWorldGenSettings();
                 m_ui->ClearWorldGenRequests();
+                m_ui->SetStatusMessage("Survey the land, then forge it.");
                 m_state = GameState::MapGenSelection;
             }
         }
@@ -200,7 +240,34 @@ int App::Run()
             const bool left = m_input->Down(SDLK_a) || m_input->Down(SDLK_LEFT);
             const bool right = m_input->Down(SDLK_d) || m_input->Down(SDLK_RIGHT);
 
-            m_ui->MapGenTick(up, down, left, right, m_input->WheelY());
+            const bool select = m_input->PressedOnce(SDLK_RETURN) || m_input->PressedOnce(SDLK_KP_ENTER);
+            const bool back = m_input->PressedOnce(SDLK_ESCAPE);
+
+            m_ui->MapGenTick(up, down, left, right, m_input->WheelY(), select, back);
+
+            if (m_ui->MapGenBackRequested())
+            {
+                m_ui->ClearMapGenRequests();
+                m_ui->SetStatusMessage(m_statusMessage);
+                m_state = GameState::WorldGen;
+            }
+            else if (m_ui->MapGenAcceptRequested())
+            {
+                m_ui->ClearMapGenRequests();
+                ForgeWorld();
+            }
+        }
+
+        PollForge();
+
+        // Fixed-step simulation, as many ticks as the frame time (and the
+        // budget) allows. Only runs once there is a dungeon to simulate:
+        // the menus would just burn the tick budget on empty ticks.
+        SimSpeedInput();
+        if (m_simulating)
+        {
+            const SimClock::Frame frame = m_simClock.Advance(dt, [this] { SimTick(); });
+            ReportShedTicks(frame, dt);
         }
 
         Render();
@@ -209,6 +276,124 @@ int App::Run()
     return 0;
 }
 
+void App::SimSpeedInput()
+{
+    const int speed = m_simClock.Speed();
+    int next = speed;
+
+    if (m_input->PressedOnce(SDLK_SPACE))
+    {
+        if (speed == SimClock::Paused)
+            next = m_speedBeforePause;
+        else
+        {
+            m_speedBeforePause = speed;
+            next = SimClock::Paused;
+        }
+    }
+    else if (m_input->PressedOnce(SDLK_EQUALS) || m_input->PressedOnce(SDLK_KP_PLUS)
+        || m_input->PressedOnce(SDLK_MINUS) || m_input->PressedOnce(SDLK_KP_MINUS))
+    {
+        const bool faster = m_input->PressedOnce(SDLK_EQUALS) || m_input->PressedOnce(SDLK_KP_PLUS);
+        const int current = speed == SimClock::Paused ? m_speedBeforePause : speed;
+        int step = 0;
+        while (step + 1 < SIM_SPEED_COUNT && SIM_SPEEDS[step] != current)
+            ++step;
+        step = faster ? std::min(step + 1, SIM_SPEED_COUNT - 1) : std::max(step - 1, 0);
+        next = SIM_SPEEDS[step];
+    }
+
+    if (next != speed)
+    {
+        m_simClock.SetSpeed(next);
+        logx::Info("Simulation speed: " + SpeedName(next));
+    }
+}
+
+void App::SimTick()
+{
+    // The dungeon simulation steps here, once per fixed tick. Nothing sets
+    // m_simulating yet: the menus and world screens have no sim state.
+}
+
+void App::ReportShedTicks(const SimClock::Frame& frame, double dt)
+{
+    m_shedInWindow += static_cast<uint64_t>(frame.shed);
+    m_shedWindowSeconds += dt;
+    if (m_shedWindowSeconds < 1.0)
+        return;
+
+    if (m_shedInWindow > 0)
+    {
+        logx::Warn("Simulation behind at " + SpeedName(m_simClock.Speed()) + ": "
+            + std::to_string(m_shedInWindow) + " ticks shed in the last "
+            + std::to_string(static_cast<int>(m_shedWindowSeconds * 1000.0)) + " ms");
+    }
+    m_shedInWindow = 0;
+    m_shedWindowSeconds = 0.0;
+}
+
+void App::ForgeWorld()
+{
+    if (m_forge->Busy())
+        return;  // still forging the last one
+
+    // The save replaces the file; Windows can't rename over a mapped one
+    m_world->Close();
+    if (!m_forge->Start(m_pendingSettings, m_ui->MapSeed(), cfg::WorldSavePath))
+        return;
+
+    logx::Info("Forging world, seed " + std::to_string(m_ui->MapSeed()));
+    m_ui->SetStatusMessage("Forging the world...");
+}
+
+void App::PollForge()
+{
+    world::ForgeResult result;
+    if (!m_forge->TakeResult(result))
+    {
+        if (m_forge->Busy())
+        {
+            const world::ForgeProgress progress = m_forge->Progress();
+            m_ui->SetStatusMessage("Forging the world: " + progress.stage + "... "
+                + std::to_string(static_cast<int>(progress.done * 100.0f)) + "%");
+        }
+        return;
+    }
+
+    if (!result.saved)
+    {
+        logx::Error("World save failed: " + result.error);
+        m_ui->SetStatusMessage("The world could not be saved.");
+        return;
+    }
+
+    logx::Info("World " + std::to_string(result.width) + "x" + std::to_string(result.height)
+        + " generated in " + std::to_string(static_cast<int>(result.generateMs)) + " ms, saved to " + result.path);
+    if (OpenWorld(result.path))
+        m_ui->SetStatusMessage("World forged and saved to " + result.path + ".");
+}
+
+bool App::OpenWorld(const std::string& path)
+{
+    const uint64_t start = NowCounter();
+    std::string error;
+    if (!m_world->Open(path, error))
+    {
+        logx::Warn("Could not open world " + path + ": " + error);
+        m_ui->SetStatusMessage("No saved world could be opened at " + path + ".");
+        return false;
+    }
+
+    const double openMs = CounterToSeconds(NowCounter() - start) * 1000.0;
+    logx::Info("Opened world " + path + " (" + std::to_string(m_world->Width()) + "x"
+        + std::to_string(m_world->Height()) + ", seed " + std::to_string(m_world->Seed()) + ") in "
+        + std::to_string(openMs) + " ms");
+    m_ui->SetStatusMessage("Opened the " + std::to_string(m_world->Width()) + "x" + std::to_string(m_world->Height())
+        + " world of seed " + std::to_string(m_world->Seed()) + ".");
+    return true;
+}
+
 void App::Render()
 {
     m_renderer->Clear();
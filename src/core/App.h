@@ -2,6 +2,7 @@
 #pragma once
 #include <cstdint>
 #include "core/GameState.h"
+#include "core/SimClock.h"
 #include <string>
 #include "world/WorldGenSettings.h"
 
@@ -12,6 +13,13 @@ class Input;
 class Renderer;
 class Font;
 class Ui;
+class ThreadPool;
+
+namespace world
+{
+    class WorldFile;
+    class WorldForgeWorker;
+}
 
 class App
 {
@@ -27,6 +35,19 @@ private:
 
     void Render();
 
+    // Pause / speed keys, and one fixed simulation step
+    void SimSpeedInput();
+    void SimTick();
+    void ReportShedTicks(const SimClock::Frame& frame, double dt);
+
+    // Starts generating the world chosen on the map screen in the background;
+    // PollForge() reports progress and saves it to cfg::WorldSavePath
+    void ForgeWorld();
+    void PollForge();
+
+    // Maps a saved world file and makes it the current world
+    bool OpenWorld(const std::string& path);
+
 private:
     SDL_Window* m_window = nullptr;
     SDL_Renderer* m_sdlRenderer = nullptr;
@@ -35,12 +56,21 @@ private:
     Renderer* m_renderer = nullptr;
     Font* m_font = nullptr;
     Ui* m_ui = nullptr;
+    ThreadPool* m_threadPool = nullptr;
+    world::WorldForgeWorker* m_forge = nullptr;
+    world::WorldFile* m_world = nullptr;  // the current world, mapped from its file
 
     GameState m_state = GameState::MainMenu;
 
     WorldGenSettings m_pendingSettings{};
     std::string m_statusMessage;
 
+    SimClock m_simClock;
+    int m_speedBeforePause = 1;
+    bool m_simulating = false;        // a dungeon is loaded and ticking
+    double m_shedWindowSeconds = 0.0; // shed ticks are reported once per second
+    uint64_t m_shedInWindow = 0;
+
     bool m_running = false;
 };
 
@@ -0,0 +1,66 @@
+#include "core/Checksum.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace
+{
+    // Slicing-by-8: table[k][b] is the CRC of byte b followed by k zero bytes,
+    // so eight input bytes fold in with eight lookups and no carried dependency.
+    using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+    CrcTables BuildTables()
+    {
+        CrcTables t{};
+        for (uint32_t b = 0; b < 256; ++b)
+        {
+            uint32_t c = b;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            t[0][b] = c;
+        }
+
+        for (uint32_t b = 0; b < 256; ++b)
+        {
+            for (int k = 1; k < 8; ++k)
+                t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+
+        return t;
+    }
+
+    const CrcTables& Tables()
+    {
+        static const CrcTables tables = BuildTables();
+        return tables;
+    }
+}
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc)
+{
+    const CrcTables& t = Tables();
+    const auto* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+
+    // The word loop assumes little-endian loads; the byte loop below is the portable fallback
+    while (std::endian::native == std::endian::little && size >= 8)
+    {
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= crc;
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+        p += 8;
+        size -= 8;
+    }
+
+    while (size-- > 0)
+        crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return ~crc;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace cfg
@@ -10,4 +11,25 @@ namespace cfg
     // Rendering
     constexpr int FontGlyphPx = 16;          // font cell size (16x16)
     constexpr const char* FontAtlasPath = "assets/fonts/font16x16.bmp";
+
+    // Simulation
+    constexpr int SimTickHz = 30;            // fixed sim ticks per second at 1x
+    constexpr double SimTickBudgetMs = 10.0; // sim time per rendered frame before ticks are shed
+    constexpr double SimMaxFrameMs = 250.0;  // longer frames (stalls) count as this long
+
+    // Threading
+    constexpr int WorkerThreads = 0;         // world-gen thread pool size (0 = one per hardware thread)
+
+    // World generation
+    constexpr int NoiseTilePx = 64;          // parallel noise tile edge (64x64 floats = 16 KB per tile)
+    constexpr int NoiseChunkPx = 64;         // noise cache chunk edge, in samples
+    constexpr size_t NoiseCacheBudgetBytes = 64u * 1024u * 1024u;
+    constexpr float RiverMinCatchment = 250.0f; // upstream cells (world::Hydrology flow) where a river starts
+
+    // History data files (world::HistoryData), loaded in this order
+    constexpr const char* HistoryDataPaths[] = { "assets/data/history_data.txt", "assets/data/history_data2.txt" };
+
+    // Saved worlds
+    constexpr int WorldFileChunkPx = 64;     // grid layer chunk edge in the world file (16 KB per chunk)
+    constexpr const char* WorldSavePath = "saves/world.ddw";
 }
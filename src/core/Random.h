@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+
+// SplitMix64 finalizer: a well-mixed 64-bit hash of x. Feeding it a counter
+// (seed + index) gives random streams that need no state, so parallel work
+// draws the same numbers whatever the thread count.
+inline uint64_t SplitMix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
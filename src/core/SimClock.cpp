@@ -0,0 +1,64 @@
+#include "core/SimClock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+SimClock::SimClock(double tickSeconds, double budgetSeconds, double maxFrameSeconds)
+    : m_tickSeconds(std::max(tickSeconds, 1e-6)),
+      m_budgetSeconds(std::max(budgetSeconds, 0.0)),
+      m_maxFrameSeconds(std::max(maxFrameSeconds, 0.0))
+{
+}
+
+void SimClock::SetSpeed(int speed)
+{
+    if (speed == Unlimited || m_speed == Unlimited)
+        m_accumulator = 0.0;
+    m_speed = speed == Unlimited ? Unlimited : std::clamp(speed, Paused, MaxSpeed);
+}
+
+SimClock::Frame SimClock::Advance(double frameSeconds, const std::function<void()>& tick)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Frame frame;
+    int due = 0;
+    if (m_speed == Unlimited)
+    {
+        due = INT_MAX;
+    }
+    else if (m_speed != Paused)
+    {
+        m_accumulator += std::clamp(frameSeconds, 0.0, m_maxFrameSeconds) * m_speed;
+        due = static_cast<int>(m_accumulator / m_tickSeconds);
+    }
+
+    // At least one tick per frame whenever one is due, so the sim always moves
+    const auto start = Clock::now();
+    const auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_budgetSeconds));
+    Clock::time_point now = start;
+    while (frame.ticks < due)
+    {
+        tick();
+        ++frame.ticks;
+        now = Clock::now();
+        if (now >= deadline)
+            break;
+    }
+    frame.simMs = std::chrono::duration<double, std::milli>(now - start).count();
+    m_tickCount += static_cast<uint64_t>(frame.ticks);
+
+    if (m_speed == Unlimited)
+    {
+        frame.alpha = 1.0;
+        return frame;
+    }
+
+    frame.shed = due - frame.ticks;
+    m_shedCount += static_cast<uint64_t>(frame.shed);
+    m_accumulator = std::max(0.0, m_accumulator - static_cast<double>(due) * m_tickSeconds);
+    frame.alpha = std::min(m_accumulator / m_tickSeconds, 1.0);
+    return frame;
+}
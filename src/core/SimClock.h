@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Fixed-timestep simulation clock, decoupled from the vsynced render rate.
+//
+// Each rendered frame hands Advance() the real time it took. That time,
+// scaled by the speed, goes into an accumulator that is drained in fixed
+// ticks; what is left over is the interpolation alpha for render state,
+// between the previous and the current tick. Frame time is clamped so a
+// stall (a world being forged, a dragged window) does not come back as a
+// burst of catch-up ticks.
+//
+// Ticks stop once the frame's budget is spent, so input and rendering keep
+// their share even at 100x. Ticks still due then are shed rather than
+// carried over, otherwise a sim that cannot keep up would fall further
+// behind every frame. At Unlimited the budget alone decides the tick count.
+class SimClock
+{
+public:
+    static constexpr int Paused = 0;
+    static constexpr int MaxSpeed = 100;
+    static constexpr int Unlimited = -1;  // as many ticks as the budget allows
+
+    struct Frame
+    {
+        int ticks = 0;       // ticks run
+        int shed = 0;        // ticks due but dropped to stay within the budget
+        double alpha = 0.0;  // render blend from the previous to the current tick, [0, 1]
+        double simMs = 0.0;  // time spent in ticks
+    };
+
+    SimClock(double tickSeconds, double budgetSeconds, double maxFrameSeconds);
+
+    // Paused, 1..MaxSpeed or Unlimited
+    void SetSpeed(int speed);
+    int Speed() const { return m_speed; }
+
+    // Runs the ticks due after a frame of `frameSeconds` real time
+    Frame Advance(double frameSeconds, const std::function<void()>& tick);
+
+    double TickSeconds() const { return m_tickSeconds; }
+    uint64_t TickCount() const { return m_tickCount; }
+    uint64_t ShedCount() const { return m_shedCount; }
+
+private:
+    double m_tickSeconds;
+    double m_budgetSeconds;
+    double m_maxFrameSeconds;
+    int m_speed = 1;
+
+    double m_accumulator = 0.0;  // sim seconds not yet ticked, below one tick between frames
+    uint64_t m_tickCount = 0;
+    uint64_t m_shedCount = 0;
+};
@@ -0,0 +1,167 @@
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    int ResolveThreadCount(int requested)
+    {
+        if (requested > 0)
+            return requested;
+
+        const unsigned hw = std::thread::hardware_concurrency();
+        return hw > 0 ? static_cast<int>(hw) : 1;
+    }
+}
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    Start(ResolveThreadCount(threadCount));
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Resize(int threadCount)
+{
+    const int n = ResolveThreadCount(threadCount);
+    if (n == ThreadCount())
+        return;
+
+    Stop();
+    Start(n);
+}
+
+void ThreadPool::Start(int threadCount)
+{
+    m_stop = false;
+
+    const int workers = std::max(0, threadCount - 1);
+    m_queues.clear();
+    for (int i = 0; i < workers; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    for (int i = 0; i < workers; ++i)
+        m_workers.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+void ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& t : m_workers)
+        t.join();
+
+    m_workers.clear();
+    m_queues.clear();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn)
+{
+    if (count <= 0)
+        return;
+
+    // Nothing to share the work with
+    if (m_queues.empty() || count == 1)
+    {
+        for (int i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    Batch batch;
+    batch.fn = &fn;
+    batch.remaining.store(count, std::memory_order_relaxed);
+
+    const int queues = static_cast<int>(m_queues.size());
+    for (int q = 0; q < queues; ++q)
+    {
+        std::lock_guard<std::mutex> lock(m_queues[q]->mutex);
+        for (int i = q; i < count; i += queues)
+            m_queues[q]->tasks.push_back(Task{ &batch, i });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queued.fetch_add(count, std::memory_order_relaxed);
+    }
+    m_wake.notify_all();
+
+    // Help out until our batch is drained (this may also run other batches' tasks)
+    while (batch.remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (!RunOne(-1))
+            std::this_thread::yield();
+    }
+}
+
+void ThreadPool::WorkerLoop(int self)
+{
+    for (;;)
+    {
+        if (RunOne(self))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_relaxed) > 0; });
+        if (m_stop)
+            return;
+    }
+}
+
+bool ThreadPool::PopTask(int self, Task& out)
+{
+    const int queues = static_cast<int>(m_queues.size());
+
+    // Own deque first, newest task (still warm in cache)
+    if (self >= 0)
+    {
+        Queue& q = *m_queues[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty())
+        {
+            out = q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task from someone else
+    const int start = (self >= 0) ? self + 1 : 0;
+    for (int k = 0; k < queues; ++k)
+    {
+        const int victim = (start + k) % queues;
+        if (victim == self)
+            continue;
+
+        Queue& q = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty())
+        {
+            out = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::RunOne(int self)
+{
+    Task task;
+    if (!PopTask(self, task))
+        return false;
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    (*task.batch->fn)(task.index);
+    task.batch->remaining.fetch_sub(1, std::memory_order_release);
+    return true;
+}
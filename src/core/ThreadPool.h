@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing pool for data-parallel loops (world generation etc.).
+//
+// Each worker owns a deque; ParallelFor deals indices round-robin into them.
+// A worker pops from the back of its own deque and, when empty, steals from
+// the front of the others. The thread calling ParallelFor steals as well, so
+// a pool of N threads runs N-1 workers plus the caller.
+class ThreadPool
+{
+public:
+    // threadCount <= 0 means one thread per hardware thread
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that execute tasks, including the caller of ParallelFor
+    int ThreadCount() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Joins and restarts the workers. Must not be called while a ParallelFor is running.
+    void Resize(int threadCount);
+
+    // Calls fn(i) for every i in [0, count) and returns once all calls finished.
+    // Call order and thread are unspecified: fn must only write state owned by i.
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+private:
+    struct Batch
+    {
+        const std::function<void(int)>* fn = nullptr;
+        std::atomic<int> remaining{ 0 };
+    };
+
+    struct Task
+    {
+        Batch* batch = nullptr;
+        int index = 0;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Start(int threadCount);
+    void Stop();
+
+    void WorkerLoop(int self);
+    bool PopTask(int self, Task& out);
+    bool RunOne(int self);
+
+private:
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<Queue>> m_queues; // one per worker
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued{ 0 };
+    bool m_stop = false;
+};
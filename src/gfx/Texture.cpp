@@ -11,12 +11,15 @@ void Texture::Destroy()
 {
     if (m_tex)
     {
+        if (m_locked)
+            SDL_UnlockTexture(m_tex);
         SDL_DestroyTexture(m_tex);
         m_tex = nullptr;
     }
     m_w = 0;
     m_h = 0;
     m_streaming = false;
+    m_locked = false;
 }
 
 bool Texture::LoadBMP(SDL_Renderer* r, const std::string& path, bool colorKeyBlack)
@@ -121,3 +124,55 @@ bool Texture::UpdateRGBA(const void* pixelsRGBA8888, int pitchBytes)
 
     return true;
 }
+
+bool Texture::UpdateRGBA(const SDL_Rect& rect, const void* pixelsRGBA8888, int pitchBytes)
+{
+    if (!m_tex)
+    {
+        logx::Error("UpdateRGBA called on null texture");
+        return false;
+    }
+
+    if (SDL_UpdateTexture(m_tex, &rect, pixelsRGBA8888, pitchBytes) != 0)
+    {
+        logx::Error(std::string("SDL_UpdateTexture (rect) failed: ") + SDL_GetError());
+        return false;
+    }
+
+    return true;
+}
+
+bool Texture::LockRGBA(const SDL_Rect* rect, uint8_t*& pixels, int& pitchBytes)
+{
+    if (!m_tex || !m_streaming)
+    {
+        logx::Error("LockRGBA called on a non-streaming texture");
+        return false;
+    }
+
+    if (m_locked)
+    {
+        logx::Error("LockRGBA called on a texture that is already locked");
+        return false;
+    }
+
+    void* raw = nullptr;
+    if (SDL_LockTexture(m_tex, rect, &raw, &pitchBytes) != 0)
+    {
+        logx::Error(std::string("SDL_LockTexture failed: ") + SDL_GetError());
+        return false;
+    }
+
+    pixels = static_cast<uint8_t*>(raw);
+    m_locked = true;
+    return true;
+}
+
+void Texture::UnlockRGBA()
+{
+    if (!m_locked)
+        return;
+
+    SDL_UnlockTexture(m_tex);
+    m_locked = false;
+}
@@ -6,6 +6,7 @@
 
 struct SDL_Texture;
 struct SDL_Renderer;
+struct SDL_Rect;
 
 class Texture
 {
@@ -22,6 +23,13 @@ public:
     // Streaming (for dynamic pixel updates)
     bool CreateRGBAStreaming(SDL_Renderer* r, int w, int h);
     bool UpdateRGBA(const void* pixelsRGBA8888, int pitchBytes);
+    bool UpdateRGBA(const SDL_Rect& rect, const void* pixelsRGBA8888, int pitchBytes);
+
+    // Direct write access to a streaming texture (rect == nullptr: all of it),
+    // no staging copy. The locked pixels are write-only and start out undefined,
+    // so every byte of the rect must be written before UnlockRGBA().
+    bool LockRGBA(const SDL_Rect* rect, uint8_t*& pixels, int& pitchBytes);
+    void UnlockRGBA();
 
     void Destroy();
 
@@ -34,6 +42,7 @@ private:
     int m_w = 0;
     int m_h = 0;
     bool m_streaming = false;
+    bool m_locked = false;
 };
 
 #endif
@@ -5,6 +5,7 @@
 #include "core/Config.h"
 #include "gfx/Texture.h"
 #include "world/Noise.h"
+#include "world/WorldGen.h"
 
 #include <cstdint>
 #include <SDL.h>
@@ -50,9 +51,70 @@ namespace
         r.FillRect(460, 200, 420, 2, Ember());
         r.FillRect(cfg::WindowWidth - 500, 160, 340, 2, Ember());
     }
+
+    // Draws the part of a toroidally stored texture that starts `src` cells
+    // after ring cell (ringX, ringY), stretched onto dst: up to four blits,
+    // split where the ring wraps.
+    void BlitRing(Renderer& r, const Texture& tex, int ringX, int ringY, const SDL_Rect& src, const SDL_Rect& dst)
+    {
+        const int w = tex.Width();
+        const int h = tex.Height();
+        if (w <= 0 || h <= 0 || src.w <= 0 || src.h <= 0)
+            return;
+
+        const int startX = (ringX + src.x) % w;
+        const int startY = (ringY + src.y) % h;
+        const int firstW = std::min(src.w, w - startX);
+        const int firstH = std::min(src.h, h - startY);
+
+        const int splitX = dst.x + static_cast<int>(static_cast<int64_t>(firstW) * dst.w / src.w);
+        const int splitY = dst.y + static_cast<int>(static_cast<int64_t>(firstH) * dst.h / src.h);
+
+        const int srcX[2] = { startX, 0 };
+        const int srcW[2] = { firstW, src.w - firstW };
+        const int dstX[2] = { dst.x, splitX };
+        const int dstW[2] = { splitX - dst.x, dst.x + dst.w - splitX };
+
+        const int srcY[2] = { startY, 0 };
+        const int srcH[2] = { firstH, src.h - firstH };
+        const int dstY[2] = { dst.y, splitY };
+        const int dstH[2] = { splitY - dst.y, dst.y + dst.h - splitY };
+
+        for (int j = 0; j < 2; ++j)
+        {
+            for (int i = 0; i < 2; ++i)
+            {
+                if (srcW[i] <= 0 || srcH[j] <= 0 || dstW[i] <= 0 || dstH[j] <= 0)
+                    continue;
+
+                SDL_Rect from{ srcX[i], srcY[j], srcW[i], srcH[j] };
+                SDL_Rect to{ dstX[i], dstY[j], dstW[i], dstH[j] };
+                r.Blit(tex, from, to);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------
+    // Map preview geometry
+    // ---------------------------------------------------------------------
+
+    int MapPreviewFramePx() { return std::min(cfg::WindowHeight - 80, 680); }
+    int MapPreviewDstPx() { return MapPreviewFramePx() - 32; }
+
+    // The preview texture always holds `res` x `res` samples. Zoomed out, it
+    // samples every 2^lod world pixels (the smallest power of two that still
+    // covers res / zoom pixels), so each frame costs the same at any zoom.
+    int MapPreviewLod(float zoom)
+    {
+        if (zoom >= 1.0f)
+            return 0;
+
+        return std::clamp(static_cast<int>(std::ceil(std::log2(1.0f / zoom) - 1e-4f)), 0, 8);
+    }
 }
 
-Ui::Ui(Font& font) : m_font(font)
+Ui::Ui(Font& font, ThreadPool& pool)
+    : m_font(font), m_mapWorker(pool)
 {
     m_settingsDetail = "Refine how your realm looks, sounds, and controls.";
 }
@@ -64,7 +126,7 @@ void Ui::SetStatusMessage(const std::string& text)
 
 void Ui::MainMenuTick(bool upPressed, bool downPressed, bool selectPressed)
 {
-    static const int MENU_COUNT = 3;
+    static const int MENU_COUNT = 4;
 
     if (upPressed)
         m_mainMenuSelection = (m_mainMenuSelection + MENU_COUNT - 1) % MENU_COUNT;
@@ -118,8 +180,9 @@ void Ui::MainMenuRender(Renderer& r)
     };
 
     drawItem(0, buttonY, "CREATE NEW WORLD");
-    drawItem(1, buttonY + lineH, "SETTINGS");
-    drawItem(2, buttonY + lineH * 2, "QUIT");
+    drawItem(1, buttonY + lineH, "OPEN SAVED WORLD");
+    drawItem(2, buttonY + lineH * 2, "SETTINGS");
+    drawItem(3, buttonY + lineH * 3, "QUIT");
 
     if (!m_statusMessage.empty())
     {
@@ -255,9 +318,13 @@ void Ui::WorldGenTick(bool up, bool down, bool left, bool right, bool select, bo
         m_wgChoice[m_wgRow] = (m_wgChoice[m_wgRow] + 1) % 5;
 
     if (m_wgChoice[0] != previousWorldSize)
-        m_mapPreviewReady = false;
+        m_lastMapPreviewWorldSize = -1;
 
-    if (select) m_worldGenStartRequested = true;
+    if (select)
+    {
+        m_worldGenStartRequested = true;
+        m_hasMapPreviewSeed = false; // a new world gets a new seed
+    }
     if (back)   m_worldGenBackRequested = true;
 }
 
@@ -321,31 +388,29 @@ WorldGenSettings Ui::GetWorldGenSettings() const
     return s;
 }
 
-void Ui::MapGenTick(bool upPressed, bool downPressed, bool leftPressed, bool rightPressed, int wheelDelta)
+void Ui::MapGenTick(bool upPressed, bool downPressed, bool leftPressed, bool rightPressed, int wheelDelta,
+    bool selectPressed, bool backPressed)
 {
+    if (selectPressed) m_mapGenAcceptRequested = true;
+    if (backPressed)   m_mapGenBackRequested = true;
+
     const float moveStep = 48.0f / std::max(1.0f, m_mapPreviewZoom);
-    bool moved = false;
-    bool zoomed = false;
 
     if (leftPressed)
     {
         m_mapPreviewOffsetX -= moveStep;
-        moved = true;
     }
     if (rightPressed)
     {
         m_mapPreviewOffsetX += moveStep;
-        moved = true;
     }
     if (upPressed)
     {
         m_mapPreviewOffsetY -= moveStep;
-        moved = true;
     }
     if (downPressed)
     {
         m_mapPreviewOffsetY += moveStep;
-        moved = true;
     }
 
     if (wheelDelta != 0)
@@ -357,11 +422,9 @@ void Ui::MapGenTick(bool upPressed, bool downPressed, bool leftPressed, bool rig
             factor *= (wheelDelta > 0) ? zoomStep : (1.0f / zoomStep);
 
         m_mapPreviewZoom = std::clamp(m_mapPreviewZoom * factor, 0.25f, 6.0f);
-        zoomed = true;
     }
 
-    if (moved || zoomed)
-        m_mapPreviewReady = false;
+    // MapGenRender posts the new view to the preview worker
 }
 
 void Ui::MapGenRender(Renderer& r)
@@ -370,67 +433,191 @@ void Ui::MapGenRender(Renderer& r)
 
     if (m_lastMapPreviewWorldSize != m_wgChoice[0])
     {
-        m_mapPreviewReady = false;
-        m_mapPreviewOffsetX = 0.0f;
-        m_mapPreviewOffsetY = 0.0f;
+        // Start centred on the world
+        const int res = world::WorldResolution(m_wgChoice[0]);
+        m_mapPreviewOffsetX = res * 0.5f;
+        m_mapPreviewOffsetY = res * 0.5f;
         m_mapPreviewZoom = 1.0f;
+        m_lastMapPreviewWorldSize = m_wgChoice[0];
     }
 
-    if (!m_mapPreviewReady)
-        GenerateMapPreview(r);
+    // Post the current view and pick up whatever the worker finished; never waits
+    RequestMapPreview();
+    UploadMapPreviewPasses(r);
 
-    const int previewSize = std::min(cfg::WindowHeight - 80, 680);
+    const int previewSize = MapPreviewFramePx();
     const int previewX = (cfg::WindowWidth - previewSize) / 2;
     const int previewY = (cfg::WindowHeight - previewSize) / 2;
+    const SDL_Rect dst{ previewX + 16, previewY + 16, previewSize - 32, previewSize - 32 };
+
+    // Whichever pass arrived last is the most current one
+    const bool coarseIsNewer = m_mapPreviewCoarseLayer.valid
+        && (!m_mapPreviewLayer.valid || m_mapPreviewCoarseLayer.serial > m_mapPreviewLayer.serial);
+
+    if (coarseIsNewer)
+        DrawMapPreviewLayer(r, m_mapPreviewCoarse, m_mapPreviewCoarseLayer, dst);
+    else if (m_mapPreviewLayer.valid)
+        DrawMapPreviewLayer(r, m_mapPreview, m_mapPreviewLayer, dst);
+
+    if (m_mapWorker.Busy())
+        m_font.DrawText(r, dst.x + 8, dst.y + 8, coarseIsNewer ? "REFINING..." : "GENERATING...");
+
+    const world::NoiseCacheStats cache = m_mapWorker.CacheStats();
+    const std::string cacheLine = "NOISE CACHE  HIT " + std::to_string(cache.hits)
+        + "  MISS " + std::to_string(cache.misses)
+        + "  EVICT " + std::to_string(cache.evictions)
+        + "  " + std::to_string(cache.bytes / (1024 * 1024)) + " MB";
+    m_font.DrawText(r, 8, cfg::WindowHeight - m_font.GlyphH() - 8, cacheLine);
 
-    if (m_mapPreviewReady)
+    m_font.DrawText(r, 8, 8, "ENTER: FORGE THIS WORLD   ESC: BACK");
+    m_font.DrawText(r, 8, 8 + m_font.GlyphH() + 4, m_statusMessage);
+}
+
+void Ui::ClearMapGenRequests()
+{
+    m_mapGenAcceptRequested = false;
+    m_mapGenBackRequested = false;
+}
+
+uint32_t Ui::MapSeed()
+{
+    // One seed per world: panning, zooming and resizing the preview keep it
+    if (!m_hasMapPreviewSeed)
     {
-        SDL_Rect src{ 0, 0, m_mapPreview.Width(), m_mapPreview.Height() };
-        SDL_Rect dst{ previewX + 16, previewY + 16, previewSize - 32, previewSize - 32 };
-        r.Blit(m_mapPreview, src, dst);
+        std::random_device rd;
+        m_mapPreviewSeed = (uint32_t)rd() ^ ((uint32_t)rd() << 16);
+        m_hasMapPreviewSeed = true;
     }
+
+    return m_mapPreviewSeed;
 }
 
-void Ui::GenerateMapPreview(Renderer& r)
+void Ui::RequestMapPreview()
 {
-    static const int WORLD_SIZE_TO_RESOLUTION[5] = { 256, 384, 512, 640, 768 };
-    const int w = WORLD_SIZE_TO_RESOLUTION[m_wgChoice[0]];
-    const int h = WORLD_SIZE_TO_RESOLUTION[m_wgChoice[0]];
-
-    std::random_device rd;
-    uint32_t seed = (uint32_t)rd() ^ ((uint32_t)rd() << 16);
-
-    world::NoiseParams p;
-    p.scale = 128.0f;
-    p.octaves = 5;
-    p.persistence = 0.5f;
-    p.lacunarity = 2.0f;
-    p.seed = seed;
-    p.offsetX = m_mapPreviewOffsetX;
-    p.offsetY = m_mapPreviewOffsetY;
-
-    auto noise = world::PerlinFbm2D(w, h, p);
-    auto gray = world::NormalizeToU8(noise);
-    auto rgba = world::GrayToRGBA(gray); // size = w*h*4
-
-    // NOTE: this requires Texture + Renderer support below (Step 4).
-    if (!m_mapPreviewReady || m_mapPreview.Width() != w || m_mapPreview.Height() != h)
+    const int w = world::WorldResolution(m_wgChoice[0]);
+    const int h = world::WorldResolution(m_wgChoice[0]);
+
+    // The preview shows the same field GenerateWorld() starts from
+    world::PreviewRequest req;
+    req.w = w;
+    req.h = h;
+    req.params = world::ElevationParams(MapSeed());
+
+    // Drop octaves finer than what ends up on screen: a sample covers 2^lod
+    // world pixels, a screen pixel covers (w / zoom) / dst of them.
+    req.lod = MapPreviewLod(m_mapPreviewZoom);
+    const float screenSpacing = (static_cast<float>(w) / m_mapPreviewZoom) / MapPreviewDstPx();
+    req.params.octaves = world::NyquistOctaves(req.params, std::max(screenSpacing, std::ldexp(1.0f, req.lod)));
+
+    // The pan offset is the window position, so params.offsetX/Y stay at zero
+    MapPreviewOrigin(req.lod, w, h, req.originX, req.originY);
+    m_mapWorker.Request(req);
+}
+
+void Ui::UploadMapPreviewPasses(Renderer& r)
+{
+    if (m_mapWorker.TakeCoarse(m_mapCoarsePass))
+        UploadMapPreviewCoarse(r, m_mapCoarsePass);
+
+    if (m_mapWorker.TakeRing(m_mapRingUpdate))
+    {
+        if (UploadMapPreviewRing(r, m_mapRingUpdate) && m_mapRingUpdate.full)
+            SetStatusMessage("Map preview generated");
+    }
+}
+
+bool Ui::UploadMapPreviewCoarse(Renderer& r, const world::PreviewCoarsePass& pass)
+{
+    if (!m_mapPreviewCoarse.Get() || m_mapPreviewCoarse.Width() != pass.w || m_mapPreviewCoarse.Height() != pass.h)
     {
-        if (!m_mapPreview.CreateRGBAStreaming(r.Raw(), w, h))
+        if (!m_mapPreviewCoarse.CreateRGBAStreaming(r.Raw(), pass.w, pass.h))
         {
             SetStatusMessage("Failed to create map preview texture");
-            return;
+            m_mapPreviewCoarseLayer.valid = false;
+            return false;
         }
-        m_mapPreviewReady = true;
     }
 
-    if (!m_mapPreview.UpdateRGBA(rgba.data(), w * 4))
+    // Samples go straight to texture memory as RGBA: no staging buffers, no extra copy
+    uint8_t* pixels = nullptr;
+    int pitch = 0;
+    if (!m_mapPreviewCoarse.LockRGBA(nullptr, pixels, pitch))
     {
         SetStatusMessage("Failed to upload map preview pixels");
-        return;
+        m_mapPreviewCoarseLayer.valid = false;
+        return false;
+    }
+
+    world::FloatToGrayRGBA(pass.samples.data(), pass.w, pass.w, pass.h, pass.lo, pass.hi, pixels, pitch);
+    m_mapPreviewCoarse.UnlockRGBA();
+
+    m_mapPreviewCoarseLayer = MapPreviewLayer{ true, pass.lod, pass.originX, pass.originY, 0, 0, pass.serial };
+    return true;
+}
+
+bool Ui::UploadMapPreviewRing(Renderer& r, const world::PreviewRingUpdate& update)
+{
+    if (update.full && (!m_mapPreview.Get() || m_mapPreview.Width() != update.w || m_mapPreview.Height() != update.h))
+    {
+        if (!m_mapPreview.CreateRGBAStreaming(r.Raw(), update.w, update.h))
+        {
+            SetStatusMessage("Failed to create map preview texture");
+            m_mapPreviewLayer.valid = false;
+            return false;
+        }
+    }
+
+    // A partial update only makes sense on top of the ring it continues
+    if (!update.full && !m_mapPreviewLayer.valid)
+        return false;
+
+    const float* samples = update.samples.data();
+
+    for (const world::RingRect& rc : update.rects)
+    {
+        SDL_Rect dst{ rc.x, rc.y, rc.w, rc.h };
+        uint8_t* pixels = nullptr;
+        int pitch = 0;
+        if (!m_mapPreview.LockRGBA(&dst, pixels, pitch))
+        {
+            SetStatusMessage("Failed to upload map preview pixels");
+            m_mapPreviewLayer.valid = false;
+            return false;
+        }
+
+        world::FloatToGrayRGBA(samples, rc.w, rc.w, rc.h, update.lo, update.hi, pixels, pitch);
+        m_mapPreview.UnlockRGBA();
+        samples += static_cast<size_t>(rc.w) * rc.h;
     }
 
-    m_lastMapPreviewWorldSize = m_wgChoice[0];
-    SetStatusMessage("Map preview generated");
+    m_mapPreviewLayer = MapPreviewLayer{ true, update.lod, update.originX, update.originY,
+        update.ringX, update.ringY, update.serial };
+    return true;
+}
+
+void Ui::DrawMapPreviewLayer(Renderer& r, const Texture& tex, const MapPreviewLayer& layer, const SDL_Rect& dst) const
+{
+    // The view is res / zoom world pixels around the pan centre; the texture
+    // may lag behind it by a pan step or two while the worker catches up.
+    const float res = static_cast<float>(world::WorldResolution(m_wgChoice[0]));
+    const float view = res / m_mapPreviewZoom;
+    const float spacing = std::ldexp(1.0f, layer.lod);
+
+    SDL_Rect src;
+    src.w = std::clamp(static_cast<int>(std::lround(view / spacing)), 1, tex.Width());
+    src.h = std::clamp(static_cast<int>(std::lround(view / spacing)), 1, tex.Height());
+    src.x = std::clamp(static_cast<int>(std::lround((m_mapPreviewOffsetX - view * 0.5f) / spacing)) - layer.originX,
+        0, tex.Width() - src.w);
+    src.y = std::clamp(static_cast<int>(std::lround((m_mapPreviewOffsetY - view * 0.5f) / spacing)) - layer.originY,
+        0, tex.Height() - src.h);
+
+    BlitRing(r, tex, layer.ringX, layer.ringY, src, dst);
 }
 
+void Ui::MapPreviewOrigin(int lod, int w, int h, int& originX, int& originY) const
+{
+    // Top-left LOD sample of a w x h window centred on the pan position
+    const float spacing = std::ldexp(1.0f, lod);
+    originX = static_cast<int>(std::lround(m_mapPreviewOffsetX / spacing)) - w / 2;
+    originY = static_cast<int>(std::lround(m_mapPreviewOffsetY / spacing)) - h / 2;
+}
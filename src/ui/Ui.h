@@ -2,14 +2,19 @@
 #include <string>
 #include "world/WorldGenSettings.h"
 #include "gfx/Texture.h"
+#include "world/NoisePreviewWorker.h"
+
+#include <cstdint>
 
 class Font;
 class Renderer;
+struct SDL_Rect;
+class ThreadPool;
 
 class Ui
 {
 public:
-    explicit Ui(Font& font);
+    Ui(Font& font, ThreadPool& pool);
 
     void MainMenuTick(bool upPressed, bool downPressed, bool selectPressed);
     void MainMenuRender(Renderer& r);
@@ -26,8 +31,15 @@ public:
         bool selectPressed, bool backPressed);
     void WorldGenRender(Renderer& r);
 
-    void MapGenTick(bool upPressed, bool downPressed, bool leftPressed, bool rightPressed, int wheelDelta);
+    void MapGenTick(bool upPressed, bool downPressed, bool leftPressed, bool rightPressed, int wheelDelta,
+        bool selectPressed, bool backPressed);
     void MapGenRender(Renderer& r);
+    bool MapGenAcceptRequested() const { return m_mapGenAcceptRequested; }
+    bool MapGenBackRequested() const { return m_mapGenBackRequested; }
+    void ClearMapGenRequests();
+
+    // Seed of the world shown in the map preview
+    uint32_t MapSeed();
 
     bool WorldGenStartRequested() const { return m_worldGenStartRequested; }
     bool WorldGenBackRequested() const { return m_worldGenBackRequested; }
@@ -41,7 +53,7 @@ private:
     Font& m_font;
 
     // Main menu state
-    int  m_mainMenuSelection = 0; // 0 = New World, 1 = Settings, 2 = Quit
+    int  m_mainMenuSelection = 0; // 0 = New World, 1 = Open Saved World, 2 = Settings, 3 = Quit
     bool m_mainMenuActivated = false;
 
     // Settings menu state
@@ -56,11 +68,38 @@ private:
 
     std::string m_statusMessage;
 
-    void GenerateMapPreview(Renderer& r);
-    Texture m_mapPreview;
-    bool m_mapPreviewReady = false;
+    // Where an uploaded preview texture sits in the world
+    struct MapPreviewLayer
+    {
+        bool valid = false;
+        int lod = 0;
+        int originX = 0; // top-left sample, in samples of that LOD
+        int originY = 0;
+        int ringX = 0;   // texel holding that sample (toroidal layout)
+        int ringY = 0;
+        uint64_t serial = 0;
+    };
+
+    bool m_mapGenAcceptRequested = false;
+    bool m_mapGenBackRequested = false;
+
+    void RequestMapPreview();
+    void UploadMapPreviewPasses(Renderer& r);
+    bool UploadMapPreviewCoarse(Renderer& r, const world::PreviewCoarsePass& pass);
+    bool UploadMapPreviewRing(Renderer& r, const world::PreviewRingUpdate& update);
+    void DrawMapPreviewLayer(Renderer& r, const Texture& tex, const MapPreviewLayer& layer, const SDL_Rect& dst) const;
+    void MapPreviewOrigin(int lod, int w, int h, int& originX, int& originY) const;
+    Texture m_mapPreview;              // full resolution, mirrors the worker's ring layout
+    Texture m_mapPreviewCoarse;        // 1/8 pass, shown until the full pass lands
+    MapPreviewLayer m_mapPreviewLayer;
+    MapPreviewLayer m_mapPreviewCoarseLayer;
+    world::NoisePreviewWorker m_mapWorker;
+    world::PreviewCoarsePass m_mapCoarsePass;
+    world::PreviewRingUpdate m_mapRingUpdate;
+    uint32_t m_mapPreviewSeed = 0;
+    bool m_hasMapPreviewSeed = false;  // cleared when a new world is started
     int m_lastMapPreviewWorldSize = -1;
-    float m_mapPreviewOffsetX = 0.0f;
+    float m_mapPreviewOffsetX = 0.0f;  // world pixel at the centre of the preview
     float m_mapPreviewOffsetY = 0.0f;
     float m_mapPreviewZoom = 1.0f;
 };
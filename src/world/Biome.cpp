@@ -0,0 +1,98 @@
+#include "world/Biome.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int BINS = world::BiomeClimateBins;
+    constexpr size_t CLASSIFY_BLOCK = 64 * 1024; // pixels per parallel task
+
+    // Rule thresholds sit on bin edges (k / BINS), so a value's bin is below
+    // k exactly when the value is below the threshold: a BINS x BINS table
+    // sampled from the rule agrees with it on every input
+    constexpr float Edge(int k)
+    {
+        return static_cast<float>(k) / BINS;
+    }
+}
+
+namespace world
+{
+    const char* BiomeName(Biome b)
+    {
+        static const char* names[] = {
+            "Deep ocean", "Ocean", "Sea ice", "Tundra", "Taiga", "Cold steppe", "Grassland",
+            "Temperate forest", "Swamp", "Desert", "Savanna", "Tropical forest", "Rainforest",
+            "Mountain", "Snow peak" };
+        static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Biome::Count));
+
+        const size_t i = static_cast<size_t>(b);
+        return (i < static_cast<size_t>(Biome::Count)) ? names[i] : "?";
+    }
+
+    Biome BiomeRule(int band, float temperature, float moisture)
+    {
+        const float t = temperature;
+        const float m = moisture;
+
+        switch (band)
+        {
+        case 0:
+            return Biome::DeepOcean;
+        case 1:
+            return (t < Edge(4)) ? Biome::SeaIce : Biome::Ocean;
+        case 3:
+            return (t < Edge(10)) ? Biome::SnowPeak : Biome::Mountain;
+        default:
+            break;
+        }
+
+        if (t < Edge(5))
+            return Biome::Tundra;
+        if (t < Edge(11))
+            return (m < Edge(11)) ? Biome::ColdSteppe : Biome::Taiga;
+        if (t < Edge(21))
+        {
+            if (m < Edge(6)) return Biome::Desert;
+            if (m < Edge(14)) return Biome::Grassland;
+            if (m < Edge(26)) return Biome::TemperateForest;
+            return Biome::Swamp;
+        }
+
+        if (m < Edge(10)) return Biome::Desert;
+        if (m < Edge(16)) return Biome::Savanna;
+        if (m < Edge(24)) return Biome::TropicalForest;
+        return Biome::Rainforest;
+    }
+
+    void ClassifyBiomes(const float* elevation, const float* temperature, const float* moisture, size_t count,
+        const BiomeClimate& climate, uint8_t* out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float e = elevation[i];
+            const int band = static_cast<int>(e >= climate.shelfLevel) + static_cast<int>(e >= climate.seaLevel)
+                + static_cast<int>(e >= climate.mountainLevel);
+
+            // Colder with height above the sea
+            const float above = std::max(e - climate.seaLevel, 0.0f);
+            const float t = 0.5f + temperature[i] * climate.contrast - above * climate.lapseRate;
+            const float m = 0.5f + moisture[i] * climate.contrast;
+
+            out[i] = static_cast<uint8_t>(BiomeRule(band, t, m));
+        }
+    }
+
+    void ClassifyBiomes(const float* elevation, const float* temperature, const float* moisture, size_t count,
+        const BiomeClimate& climate, uint8_t* out, ThreadPool& pool)
+    {
+        const int blocks = static_cast<int>((count + CLASSIFY_BLOCK - 1) / CLASSIFY_BLOCK);
+        pool.ParallelFor(blocks, [&](int b)
+        {
+            const size_t begin = static_cast<size_t>(b) * CLASSIFY_BLOCK;
+            const size_t n = std::min(CLASSIFY_BLOCK, count - begin);
+            ClassifyBiomes(elevation + begin, temperature + begin, moisture + begin, n, climate, out + begin);
+        });
+    }
+}
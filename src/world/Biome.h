@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+namespace world
+{
+    enum class Biome : uint8_t
+    {
+        DeepOcean,
+        Ocean,
+        SeaIce,
+        Tundra,
+        Taiga,
+        ColdSteppe,
+        Grassland,
+        TemperateForest,
+        Swamp,
+        Desert,
+        Savanna,
+        TropicalForest,
+        Rainforest,
+        Mountain,
+        SnowPeak,
+        Count
+    };
+
+    const char* BiomeName(Biome b);
+
+    // Elevation thresholds and climate shaping for one world, in the units of
+    // the generated fields (fBm: roughly [-1, 1])
+    struct BiomeClimate
+    {
+        float shelfLevel = -0.1f;    // below: deep ocean
+        float seaLevel = 0.0f;       // below: ocean
+        float mountainLevel = 0.4f;  // at or above: mountains
+        float lapseRate = 1.5f;      // temperature lost per unit of height above sea level
+        float contrast = 1.6f;       // stretch of the temperature / moisture noise around 0.5
+    };
+
+    // Elevation bands, lowest first: deep ocean, ocean, land, mountains
+    constexpr int BiomeElevationBands = 4;
+
+    // Temperature and moisture thresholds of BiomeRule are multiples of
+    // 1 / BiomeClimateBins
+    constexpr int BiomeClimateBins = 32;
+
+    // Band, temperature and moisture (both 0..1) to a biome. Because the
+    // thresholds sit on bin edges, a bands x bins x bins table sampled from
+    // it gives exactly its answers (the climate bench checks that table).
+    Biome BiomeRule(int band, float temperature, float moisture);
+
+    // Writes one Biome per pixel to `out` from the elevation, temperature and
+    // moisture fields: a band index from three compares, then BiomeRule.
+    // Climate fields are smooth, so the rule's branches predict well; the
+    // loop runs at memory speed, a little ahead of a table read.
+    void ClassifyBiomes(const float* elevation, const float* temperature, const float* moisture, size_t count,
+        const BiomeClimate& climate, uint8_t* out);
+
+    // Same, in row-sized blocks spread across the pool
+    void ClassifyBiomes(const float* elevation, const float* temperature, const float* moisture, size_t count,
+        const BiomeClimate& climate, uint8_t* out, ThreadPool& pool);
+}
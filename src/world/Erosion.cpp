@@ -0,0 +1,347 @@
+#include "world/Erosion.h"
+#include "core/Random.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr int TILE = 64;
+    constexpr int MAX_RADIUS = 3;
+    constexpr int BATCH = 64;                     // droplets advanced in lockstep
+    constexpr int DROPLETS_PER_TILE_ROUND = 512;  // sets the number of rounds
+
+    // Brush rows are a fixed 8 columns wide, from MAX_RADIUS left of the
+    // droplet to BRUSH_REACH right of it, so every row is one short
+    // fixed-length loop the compiler turns into a couple of vector ops.
+    constexpr int BRUSH_SPAN = 8;
+    constexpr int BRUSH_REACH = BRUSH_SPAN - 1 - MAX_RADIUS;
+    static_assert(BRUSH_REACH >= MAX_RADIUS, "brush rows must cover the whole radius");
+
+    // A droplet whose position leaves its tile grown by this margin stops.
+    // Reads reach one pixel past the position and brush writes BRUSH_REACH
+    // pixels, so everything a tile touches stays under TILE / 2 from it, and
+    // the nearest tile of the same phase (TILE away) is never reached.
+    constexpr int TILE_MARGIN = TILE / 2 - BRUSH_REACH - 2;
+
+    float UnitFloat(uint64_t bits)
+    {
+        return static_cast<float>(bits >> 40) * (1.0f / 16777216.0f); // 24 bits -> [0, 1)
+    }
+
+    // Erosion brush: weights (1 - d / r), normalized. Only |dy| < r has any
+    // weight, so there is one zero-padded BRUSH_SPAN row per dy in
+    // [-(r - 1), r - 1]; column k is dx = k - MAX_RADIUS.
+    struct Brush
+    {
+        int radius = 0;
+        float rows[2 * MAX_RADIUS - 1][BRUSH_SPAN] = {};
+    };
+
+    Brush MakeBrush(int radius)
+    {
+        Brush b;
+        b.radius = radius;
+
+        float sum = 0.0f;
+        for (int y = 1 - radius; y < radius; ++y)
+        {
+            for (int x = 1 - radius; x < radius; ++x)
+            {
+                const float d = std::sqrt(static_cast<float>(x * x + y * y));
+                if (d < radius)
+                {
+                    b.rows[y + radius - 1][x + MAX_RADIUS] = 1.0f - d / radius;
+                    sum += 1.0f - d / radius;
+                }
+            }
+        }
+
+        for (auto& row : b.rows)
+        {
+            for (float& w : row)
+                w /= sum;
+        }
+
+        return b;
+    }
+
+    // State of up to BATCH droplets, one array per field
+    struct DropletBatch
+    {
+        float x[BATCH];
+        float y[BATCH];
+        float dirX[BATCH];
+        float dirY[BATCH];
+        float speed[BATCH];
+        float water[BATCH];
+        float sediment[BATCH];
+
+        // Written by MoveBatch, consumed by ErodeBatch
+        int   cell[BATCH];   // map index of the top-left corner under the old position
+        float u[BATCH];      // old position within that cell
+        float v[BATCH];
+        float dh[BATCH];     // height change of the move
+        bool  moved[BATCH];  // false: flat ground or left the tile bounds
+    };
+
+    struct Rect
+    {
+        int x0, y0, x1, y1;
+    };
+
+    struct Field
+    {
+        float* h;
+        int w;
+        int height;
+    };
+
+    // Pass 1: every droplet reads the map and takes its step. Droplets are
+    // independent here, so the long per-droplet dependency chains (loads,
+    // gradient, normalize, second bilinear read) overlap instead of running
+    // one after another.
+    void MoveBatch(const Field& f, const world::ErosionParams& p, const Rect& bounds, DropletBatch& b, int count)
+    {
+        const float lastX = static_cast<float>(bounds.x1) - 1e-3f;
+        const float lastY = static_cast<float>(bounds.y1) - 1e-3f;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const float x = b.x[i];
+            const float y = b.y[i];
+            const int ix = static_cast<int>(x);
+            const int iy = static_cast<int>(y);
+            const float u = x - ix;
+            const float v = y - iy;
+            const int cell = iy * f.w + ix;
+
+            const float* c = f.h + cell;
+            const float h00 = c[0], h10 = c[1], h01 = c[f.w], h11 = c[f.w + 1];
+            const float gx = (h10 - h00) * (1.0f - v) + (h11 - h01) * v;
+            const float gy = (h01 - h00) * (1.0f - u) + (h11 - h10) * u;
+            const float height = (h00 * (1.0f - u) + h10 * u) * (1.0f - v) + (h01 * (1.0f - u) + h11 * u) * v;
+
+            float dx = b.dirX[i] * p.inertia - gx * (1.0f - p.inertia);
+            float dy = b.dirY[i] * p.inertia - gy * (1.0f - p.inertia);
+            const float len = std::sqrt(dx * dx + dy * dy);
+            const float inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+            dx *= inv;
+            dy *= inv;
+
+            const float nx = x + dx;
+            const float ny = y + dy;
+            const bool inside = len > 0.0f && nx >= bounds.x0 && ny >= bounds.y0 && nx < bounds.x1 && ny < bounds.y1;
+
+            // Droplets that left still read in bounds; their result is dropped
+            const float rx = std::clamp(nx, static_cast<float>(bounds.x0), lastX);
+            const float ry = std::clamp(ny, static_cast<float>(bounds.y0), lastY);
+            const int jx = static_cast<int>(rx);
+            const int jy = static_cast<int>(ry);
+            const float s = rx - jx;
+            const float t = ry - jy;
+            const float* n = f.h + (jy * f.w + jx);
+            const float next = (n[0] * (1.0f - s) + n[1] * s) * (1.0f - t) + (n[f.w] * (1.0f - s) + n[f.w + 1] * s) * t;
+
+            b.cell[i] = cell;
+            b.u[i] = u;
+            b.v[i] = v;
+            b.dh[i] = next - height;
+            b.moved[i] = inside;
+            b.x[i] = nx;
+            b.y[i] = ny;
+            b.dirX[i] = dx;
+            b.dirY[i] = dy;
+        }
+    }
+
+    // Pass 2: erosion and deposition in droplet order, compacting out the
+    // droplets that stopped. Returns how many are still alive.
+    int ErodeBatch(const Field& f, const Brush& brush, const world::ErosionParams& p, DropletBatch& b, int count)
+    {
+        int kept = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (!b.moved[i])
+                continue;
+
+            const float dh = b.dh[i];
+            const float u = b.u[i];
+            const float v = b.v[i];
+            float* centre = f.h + b.cell[i];
+            float sediment = b.sediment[i];
+            const float cap = std::max(-dh * b.speed[i] * b.water[i] * p.capacity, p.minCapacity);
+
+            if (sediment > cap || dh > 0.0f)
+            {
+                // Uphill: fill the pit behind; otherwise drop part of the surplus
+                const float amount = (dh > 0.0f) ? std::min(dh, sediment) : (sediment - cap) * p.depositRate;
+                sediment -= amount;
+
+                centre[0] += amount * (1.0f - u) * (1.0f - v);
+                centre[1] += amount * u * (1.0f - v);
+                centre[f.w] += amount * (1.0f - u) * v;
+                centre[f.w + 1] += amount * u * v;
+            }
+            else
+            {
+                // Never dig below the point the droplet flows to. Droplets keep
+                // clear of the map edge, so the brush is never clipped.
+                const float amount = std::min((cap - sediment) * p.erodeRate, -dh);
+                sediment += amount;
+
+                for (int row = 0; row < 2 * brush.radius - 1; ++row)
+                {
+                    // Scaled into a local first: `d` can't alias it, so both loops vectorize
+                    float take[BRUSH_SPAN];
+                    for (int k = 0; k < BRUSH_SPAN; ++k)
+                        take[k] = brush.rows[row][k] * amount;
+
+                    float* d = centre + (row - brush.radius + 1) * f.w - MAX_RADIUS;
+                    for (int k = 0; k < BRUSH_SPAN; ++k)
+                        d[k] -= take[k];
+                }
+            }
+
+            b.x[kept] = b.x[i];
+            b.y[kept] = b.y[i];
+            b.dirX[kept] = b.dirX[i];
+            b.dirY[kept] = b.dirY[i];
+            b.speed[kept] = std::sqrt(std::max(0.0f, b.speed[i] * b.speed[i] - dh * p.gravity));
+            b.water[kept] = b.water[i] * (1.0f - p.evaporation);
+            b.sediment[kept] = sediment;
+            ++kept;
+        }
+        return kept;
+    }
+
+    struct TileJob
+    {
+        Rect spawn;          // where droplets start
+        Rect bounds;         // where they may go
+        uint64_t key;        // (seed, round, tile) hash
+        int droplets;
+    };
+
+    void RunTile(const Field& f, const Brush& brush, const world::ErosionParams& p, const TileJob& job)
+    {
+        DropletBatch b;
+        const float spanX = static_cast<float>(job.spawn.x1 - job.spawn.x0);
+        const float spanY = static_cast<float>(job.spawn.y1 - job.spawn.y0);
+
+        for (int first = 0; first < job.droplets; first += BATCH)
+        {
+            int alive = std::min(BATCH, job.droplets - first);
+
+            for (int i = 0; i < alive; ++i)
+            {
+                const uint64_t r = SplitMix64(job.key + static_cast<uint64_t>(first + i));
+                b.x[i] = job.spawn.x0 + UnitFloat(r) * spanX;
+                b.y[i] = job.spawn.y0 + UnitFloat(r << 24) * spanY;
+                b.dirX[i] = 0.0f;
+                b.dirY[i] = 0.0f;
+                b.speed[i] = p.initialSpeed;
+                b.water[i] = p.initialWater;
+                b.sediment[i] = 0.0f;
+            }
+
+            // Lockstep: all live droplets move, then erode in order. Within a
+            // step a droplet doesn't see what earlier droplets of the same
+            // step changed; the order is fixed, so results still are.
+            for (int step = 0; step < p.maxLifetime && alive > 0; ++step)
+            {
+                MoveBatch(f, p, job.bounds, b, alive);
+                alive = ErodeBatch(f, brush, p, b, alive);
+            }
+        }
+    }
+}
+
+namespace world
+{
+    void ErodeHydraulic(float* height, int w, int h, const ErosionParams& params, ThreadPool& pool,
+        const std::function<void(float)>& progress)
+    {
+        ErosionParams p = params;
+        p.radius = std::clamp(p.radius, 1, MAX_RADIUS);
+
+        if (p.droplets <= 0 || w <= MAX_RADIUS + BRUSH_REACH + 2 || h <= MAX_RADIUS + BRUSH_REACH + 2)
+            return;
+
+        const Field f{ height, w, h };
+        const Brush brush = MakeBrush(p.radius);
+
+        // Droplets stay far enough from the edges for the bilinear reads and
+        // the whole brush row to be inside the map. Clipping the brush at the
+        // edge instead leaves droplets digging pits against it.
+        const Rect area{ MAX_RADIUS, MAX_RADIUS, w - 1 - BRUSH_REACH, h - 1 - BRUSH_REACH };
+        const uint64_t spawnArea = static_cast<uint64_t>(area.x1 - area.x0) * (area.y1 - area.y0);
+
+        const int baseTiles = ((w + TILE - 1) / TILE) * ((h + TILE - 1) / TILE);
+        const int rounds = std::max(1, static_cast<int>(
+            (static_cast<int64_t>(p.droplets) + static_cast<int64_t>(baseTiles) * DROPLETS_PER_TILE_ROUND - 1)
+            / (static_cast<int64_t>(baseTiles) * DROPLETS_PER_TILE_ROUND)));
+
+        std::vector<TileJob> phases[4];
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            const int roundDroplets = p.droplets / rounds + (round < p.droplets % rounds ? 1 : 0);
+
+            // Shift the grid every round so tile borders (where long paths get cut) move around
+            const uint64_t roundKey = SplitMix64((static_cast<uint64_t>(p.seed) << 32) | static_cast<uint32_t>(round));
+            const int shiftX = static_cast<int>(roundKey % TILE);
+            const int shiftY = static_cast<int>((roundKey >> 32) % TILE);
+            const int tilesX = (area.x1 - area.x0 + shiftX + TILE - 1) / TILE;
+            const int tilesY = (area.y1 - area.y0 + shiftY + TILE - 1) / TILE;
+
+            for (std::vector<TileJob>& jobs : phases)
+                jobs.clear();
+
+            // Droplets split by spawn area; cumulative rounding keeps the total exact
+            uint64_t areaBefore = 0;
+            for (int ty = 0; ty < tilesY; ++ty)
+            {
+                for (int tx = 0; tx < tilesX; ++tx)
+                {
+                    const int x0 = area.x0 + tx * TILE - shiftX;
+                    const int y0 = area.y0 + ty * TILE - shiftY;
+                    const Rect tile{ x0, y0, x0 + TILE, y0 + TILE };
+                    const Rect spawn{ std::max(tile.x0, area.x0), std::max(tile.y0, area.y0),
+                        std::min(tile.x1, area.x1), std::min(tile.y1, area.y1) };
+                    const uint64_t tileArea = static_cast<uint64_t>(spawn.x1 - spawn.x0) * (spawn.y1 - spawn.y0);
+
+                    const uint64_t begin = static_cast<uint64_t>(roundDroplets) * areaBefore / spawnArea;
+                    areaBefore += tileArea;
+                    const uint64_t end = static_cast<uint64_t>(roundDroplets) * areaBefore / spawnArea;
+                    if (end == begin)
+                        continue;
+
+                    TileJob job;
+                    job.spawn = spawn;
+                    job.bounds = Rect{ std::max(tile.x0 - TILE_MARGIN, area.x0), std::max(tile.y0 - TILE_MARGIN, area.y0),
+                        std::min(tile.x1 + TILE_MARGIN, area.x1), std::min(tile.y1 + TILE_MARGIN, area.y1) };
+                    job.key = SplitMix64(roundKey ^ (static_cast<uint64_t>(ty * tilesX + tx) << 20));
+                    job.droplets = static_cast<int>(end - begin);
+
+                    phases[(ty & 1) * 2 + (tx & 1)].push_back(job);
+                }
+            }
+
+            // Tiles of one phase never touch the same pixels; phases run one after another
+            for (int phase = 0; phase < 4; ++phase)
+            {
+                const std::vector<TileJob>& jobs = phases[phase];
+                pool.ParallelFor(static_cast<int>(jobs.size()), [&](int i)
+                {
+                    RunTile(f, brush, p, jobs[i]);
+                });
+
+                if (progress)
+                    progress(static_cast<float>(round * 4 + phase + 1) / static_cast<float>(rounds * 4));
+            }
+        }
+    }
+}
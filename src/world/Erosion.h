@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+class ThreadPool;
+
+namespace world
+{
+    // Droplet hydraulic erosion. Heights are in the units of the input field
+    // (fBm: roughly [-1, 1]); the defaults are tuned for that range.
+    struct ErosionParams
+    {
+        int      droplets = 0;
+        uint32_t seed = 1337;
+        int      maxLifetime = 30;      // steps of one pixel each
+        int      radius = 3;            // erosion brush radius, in pixels (1..3)
+        float    inertia = 0.05f;       // 0 = follow the slope exactly, 1 = never turn
+        float    capacity = 4.0f;       // sediment a droplet carries per unit of slope * speed * water
+        float    minCapacity = 0.01f;   // keeps droplets eroding on flat ground
+        float    depositRate = 0.3f;    // share of surplus sediment dropped per step
+        float    erodeRate = 0.3f;      // share of spare capacity picked up per step
+        float    evaporation = 0.01f;   // water lost per step
+        float    gravity = 4.0f;
+        float    initialWater = 1.0f;
+        float    initialSpeed = 1.0f;
+    };
+
+    // Runs p.droplets droplets over a w x h height field in place.
+    //
+    // The map is cut into 64x64 tiles processed in four checkerboard phases:
+    // tiles of one phase are a tile apart, and a droplet is stopped before it
+    // gets close enough to another tile of its phase to touch what that tile
+    // writes, so the tiles of a phase run in parallel without locks. Droplets
+    // are spread over rounds (each all four phases, with the tile grid shifted
+    // every round) so erosion advances evenly across the map.
+    //
+    // Every droplet's start comes from (seed, round, tile, index) and a tile
+    // runs its droplets in a fixed order, so the result is bit-identical for
+    // any thread count.
+    //
+    // progress (optional) is called with the share done (0..1] after each
+    // phase, on the calling thread.
+    void ErodeHydraulic(float* height, int w, int h, const ErosionParams& p, ThreadPool& pool,
+        const std::function<void(float)>& progress = {});
+}
@@ -0,0 +1,328 @@
+#include "world/FlowField.h"
+#include "world/TileVolume.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Same order as the direction codes
+    const int STEP_DX[4] = { 1, -1, 0, 0 };
+    const int STEP_DY[4] = { 0, 0, 1, -1 };
+
+    // Level-by-level wavefront helper: tiles of the level being processed
+    // and of the next one
+    struct Levels
+    {
+        std::vector<int32_t> current;
+        std::vector<int32_t> next;
+    };
+}
+
+namespace world
+{
+    FlowFields::FlowFields(int width, int height)
+        : m_width(std::max(width, 1)), m_height(std::max(height, 1))
+    {
+        m_walk.assign(static_cast<size_t>(m_width) * m_height, 0);
+        m_isPending.assign(m_walk.size(), 0);
+    }
+
+    void FlowFields::LoadLevel(const TileVolume& volume, int z, ThreadPool& pool)
+    {
+        const int w = std::min(m_width, volume.Width());
+        const int h = std::min(m_height, volume.Height());
+        pool.ParallelFor(h, [&](int y)
+        {
+            uint8_t* row = m_walk.data() + static_cast<size_t>(y) * m_width;
+            for (int x = 0; x < w; ++x)
+                row[x] = Walkable(volume.Get(x, y, z)) ? 1 : 0;
+        });
+        Recompute(pool);
+    }
+
+    int FlowFields::AddField(const std::vector<TilePoint>& goals)
+    {
+        m_fields.emplace_back();
+        SetGoals(static_cast<int>(m_fields.size()) - 1, goals);
+        return static_cast<int>(m_fields.size()) - 1;
+    }
+
+    void FlowFields::SetGoals(int field, const std::vector<TilePoint>& goals)
+    {
+        Field& f = m_fields[static_cast<size_t>(field)];
+        f.goals.clear();
+        for (const TilePoint& g : goals)
+        {
+            if (g.x >= 0 && g.y >= 0 && g.x < m_width && g.y < m_height)
+                f.goals.push_back(g.y * m_width + g.x);
+        }
+        std::sort(f.goals.begin(), f.goals.end());
+        f.goals.erase(std::unique(f.goals.begin(), f.goals.end()), f.goals.end());
+        Compute(f);
+    }
+
+    void FlowFields::SetWalkable(int x, int y, bool walkable)
+    {
+        const size_t i = static_cast<size_t>(y) * m_width + x;
+        if ((m_walk[i] != 0) == walkable)
+            return;
+        m_walk[i] = walkable ? 1 : 0;
+        if (!m_isPending[i])
+        {
+            m_isPending[i] = 1;
+            m_pending.push_back(static_cast<int32_t>(i));
+        }
+    }
+
+    void FlowFields::Recompute(ThreadPool& pool)
+    {
+        pool.ParallelFor(FieldCount(), [&](int i) { Compute(m_fields[static_cast<size_t>(i)]); });
+        for (const int32_t t : m_pending)
+            m_isPending[static_cast<size_t>(t)] = 0;
+        m_pending.clear();
+    }
+
+    size_t FlowFields::Update(ThreadPool& pool)
+    {
+        if (m_pending.empty())
+            return 0;
+
+        std::vector<size_t> changed(m_fields.size(), 0);
+        pool.ParallelFor(FieldCount(), [&](int i)
+        {
+            changed[static_cast<size_t>(i)] = Repair(m_fields[static_cast<size_t>(i)], m_pending);
+        });
+
+        for (const int32_t t : m_pending)
+            m_isPending[static_cast<size_t>(t)] = 0;
+        m_pending.clear();
+
+        size_t total = 0;
+        for (const size_t c : changed)
+            total += c;
+        return total;
+    }
+
+    // ---------------------------------------------------------------------
+    // Wavefronts
+    // ---------------------------------------------------------------------
+
+    void FlowFields::Compute(Field& f) const
+    {
+        f.dist.assign(m_walk.size(), Unreached);
+        f.dir.assign(m_walk.size(), DirNone);
+
+        std::vector<Seed> seeds;
+        for (const int32_t g : f.goals)
+            seeds.push_back({ 0, g });
+
+        std::vector<int32_t> touched;
+        Lower(f, seeds, touched);
+        for (const int32_t t : touched)
+            Redirect(f, t);
+    }
+
+    void FlowFields::Lower(Field& f, std::vector<Seed>& seeds, std::vector<int32_t>& touched) const
+    {
+        if (seeds.empty())
+            return;
+        std::sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b) { return a.dist < b.dist; });
+
+        Levels levels;
+        size_t nextSeed = 0;
+        uint32_t level = seeds.front().dist;
+        for (;;)
+        {
+            for (; nextSeed < seeds.size() && seeds[nextSeed].dist == level; ++nextSeed)
+            {
+                const size_t t = static_cast<size_t>(seeds[nextSeed].tile);
+                if (m_walk[t] && level < f.dist[t])
+                {
+                    f.dist[t] = level;
+                    touched.push_back(seeds[nextSeed].tile);
+                    levels.current.push_back(seeds[nextSeed].tile);
+                }
+            }
+
+            for (const int32_t t : levels.current)
+            {
+                if (f.dist[static_cast<size_t>(t)] != level)
+                    continue;  // lowered again since it was queued
+
+                const int x = t % m_width;
+                const int y = t / m_width;
+                for (int k = 0; k < 4; ++k)
+                {
+                    const int nx = x + STEP_DX[k];
+                    const int ny = y + STEP_DY[k];
+                    if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height)
+                        continue;
+
+                    const int32_t n = ny * m_width + nx;
+                    if (!m_walk[static_cast<size_t>(n)] || f.dist[static_cast<size_t>(n)] <= level + 1)
+                        continue;
+                    f.dist[static_cast<size_t>(n)] = level + 1;
+                    touched.push_back(n);
+                    levels.next.push_back(n);
+                }
+            }
+
+            levels.current.swap(levels.next);
+            levels.next.clear();
+            if (!levels.current.empty())
+                ++level;
+            else if (nextSeed < seeds.size())
+                level = seeds[nextSeed].dist;
+            else
+                break;
+        }
+    }
+
+    void FlowFields::Redirect(Field& f, int32_t tile) const
+    {
+        const size_t t = static_cast<size_t>(tile);
+        const uint32_t d = f.dist[t];
+        if (!m_walk[t] || d == Unreached)
+        {
+            f.dir[t] = DirNone;
+            return;
+        }
+        if (d == 0)
+        {
+            f.dir[t] = DirGoal;
+            return;
+        }
+
+        // First neighbour, in code order, that is a step closer
+        const int x = tile % m_width;
+        const int y = tile / m_width;
+        for (int k = 0; k < 4; ++k)
+        {
+            const int nx = x + STEP_DX[k];
+            const int ny = y + STEP_DY[k];
+            if (nx < 0 || ny < 0 || nx >= m_width || ny >= m_height)
+                continue;
+            if (f.dist[static_cast<size_t>(ny) * m_width + nx] == d - 1)
+            {
+                f.dir[t] = static_cast<uint8_t>(k);
+                return;
+            }
+        }
+        f.dir[t] = DirNone;
+    }
+
+    size_t FlowFields::Repair(Field& f, const std::vector<int32_t>& changed) const
+    {
+        std::vector<int32_t> touched;
+        const auto isGoal = [&](int32_t t) { return std::binary_search(f.goals.begin(), f.goals.end(), t); };
+        const auto forNeighbours = [&](int32_t t, auto&& fn)
+        {
+            const int x = t % m_width;
+            const int y = t / m_width;
+            for (int k = 0; k < 4; ++k)
+            {
+                const int nx = x + STEP_DX[k];
+                const int ny = y + STEP_DY[k];
+                if (nx >= 0 && ny >= 0 && nx < m_width && ny < m_height)
+                    fn(ny * m_width + nx);
+            }
+        };
+
+        // Invalidate, lowest level first. A tile one level up from an
+        // invalidated one is checked once its own level comes round, when
+        // every invalidation below it is known: it survives if some
+        // neighbour still sits a level lower.
+        std::vector<Seed> closed;
+        for (const int32_t t : changed)
+        {
+            if (!m_walk[static_cast<size_t>(t)] && f.dist[static_cast<size_t>(t)] != Unreached)
+                closed.push_back({ f.dist[static_cast<size_t>(t)], t });
+        }
+        std::sort(closed.begin(), closed.end(), [](const Seed& a, const Seed& b) { return a.dist < b.dist; });
+
+        std::vector<int32_t> invalid;
+        if (!closed.empty())
+        {
+            Levels levels;
+            size_t nextSeed = 0;
+            uint32_t level = closed.front().dist;
+            for (;;)
+            {
+                for (; nextSeed < closed.size() && closed[nextSeed].dist == level; ++nextSeed)
+                    levels.current.push_back(closed[nextSeed].tile);
+
+                for (const int32_t t : levels.current)
+                {
+                    const size_t ti = static_cast<size_t>(t);
+                    if (f.dist[ti] != level)
+                        continue;  // already invalidated
+
+                    if (m_walk[ti])
+                    {
+                        bool supported = false;
+                        forNeighbours(t, [&](int32_t n) { supported |= f.dist[static_cast<size_t>(n)] == level - 1; });
+                        if (supported)
+                            continue;
+                    }
+
+                    f.dist[ti] = Unreached;
+                    invalid.push_back(t);
+                    forNeighbours(t, [&](int32_t n)
+                    {
+                        if (f.dist[static_cast<size_t>(n)] == level + 1)
+                            levels.next.push_back(n);
+                    });
+                }
+
+                levels.current.swap(levels.next);
+                levels.next.clear();
+                if (!levels.current.empty())
+                    ++level;
+                else if (nextSeed < closed.size())
+                    level = closed[nextSeed].dist;
+                else
+                    break;
+            }
+        }
+
+        // Re-seed the invalidated and the newly opened tiles from their
+        // valid neighbours (or as goals), then let the wavefront settle them
+        std::vector<Seed> seeds;
+        const auto reseed = [&](int32_t t)
+        {
+            if (!m_walk[static_cast<size_t>(t)])
+                return;
+            if (isGoal(t))
+            {
+                seeds.push_back({ 0, t });
+                return;
+            }
+            uint32_t best = Unreached;
+            forNeighbours(t, [&](int32_t n) { best = std::min(best, f.dist[static_cast<size_t>(n)]); });
+            if (best != Unreached)
+                seeds.push_back({ best + 1, t });
+        };
+        for (const int32_t t : invalid)
+            reseed(t);
+        for (const int32_t t : changed)
+            reseed(t);
+
+        Lower(f, seeds, touched);
+
+        // Directions depend on the neighbours' distances too
+        const auto redirectAround = [&](int32_t t)
+        {
+            Redirect(f, t);
+            forNeighbours(t, [&](int32_t n) { Redirect(f, n); });
+        };
+        for (const int32_t t : invalid)
+            redirectAround(t);
+        for (const int32_t t : touched)
+            redirectAround(t);
+        for (const int32_t t : changed)
+            redirectAround(t);
+
+        return invalid.size() + touched.size();
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "world/PathGraph.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // Shared flow fields over one dungeon level, one per goal set (the Core,
+    // the spawners, the exits...), for moving crowds without per-agent
+    // searches. 4-connected, unit step cost like PathGraph.
+    //
+    // Each field is an integration field (steps to the nearest goal, from a
+    // multi-source breadth-first wavefront) plus a direction field of one
+    // byte per tile, pointing at a neighbour one step closer. Agents read
+    // one byte per tick: the direction grids are all they touch, 1 MB per
+    // field on a 1024x1024 level.
+    //
+    // SetWalkable only queues the change. Update() applies the queue to every
+    // field, fields in parallel:
+    //  - closed tiles invalidate the tiles whose every shortest path ran
+    //    through them, level by level;
+    //  - invalidated and newly opened tiles are re-seeded from their valid
+    //    neighbours and a decreasing wavefront settles them;
+    //  - directions are redone only around tiles whose distance changed.
+    // Distances are unique, so this gives exactly what Recompute() would.
+    class FlowFields
+    {
+    public:
+        static constexpr uint32_t Unreached = 0xFFFFFFFFu;
+
+        // Direction field values: 0..3 step to +x, -x, +y, -y, or
+        static constexpr uint8_t DirGoal = 4;  // standing on a goal
+        static constexpr uint8_t DirNone = 5;  // blocked, or no goal reachable
+
+        FlowFields(int width, int height);
+
+        // Copies the walkability of level `z` and recomputes every field
+        void LoadLevel(const TileVolume& volume, int z, ThreadPool& pool);
+
+        // Adds a field towards `goals` (tiles that are blocked stay goals and
+        // count once they open up) and computes it; returns its id
+        int AddField(const std::vector<TilePoint>& goals);
+        void SetGoals(int field, const std::vector<TilePoint>& goals);
+
+        void SetWalkable(int x, int y, bool walkable);
+        bool IsWalkable(int x, int y) const { return m_walk[static_cast<size_t>(y) * m_width + x] != 0; }
+
+        // Applies queued walkability changes; returns the tiles whose
+        // distance changed, summed over fields
+        size_t Update(ThreadPool& pool);
+        void Recompute(ThreadPool& pool);
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+        int FieldCount() const { return static_cast<int>(m_fields.size()); }
+
+        uint32_t Distance(int field, int x, int y) const
+        {
+            return m_fields[static_cast<size_t>(field)].dist[static_cast<size_t>(y) * m_width + x];
+        }
+        uint8_t Direction(int field, int x, int y) const
+        {
+            return m_fields[static_cast<size_t>(field)].dir[static_cast<size_t>(y) * m_width + x];
+        }
+
+        // Row-major grids, width * height
+        const uint32_t* Distances(int field) const { return m_fields[static_cast<size_t>(field)].dist.data(); }
+        const uint8_t* Directions(int field) const { return m_fields[static_cast<size_t>(field)].dir.data(); }
+
+    private:
+        struct Field
+        {
+            std::vector<int32_t> goals;  // tile indices, sorted
+            std::vector<uint32_t> dist;
+            std::vector<uint8_t> dir;
+        };
+
+        struct Seed
+        {
+            uint32_t dist;
+            int32_t tile;
+        };
+
+        void Compute(Field& f) const;
+        size_t Repair(Field& f, const std::vector<int32_t>& changed) const;
+
+        // Wavefront from `seeds` (any order), only lowering distances;
+        // lowered tiles are appended to `touched`
+        void Lower(Field& f, std::vector<Seed>& seeds, std::vector<int32_t>& touched) const;
+        void Redirect(Field& f, int32_t tile) const;
+
+        int m_width;
+        int m_height;
+        std::vector<uint8_t> m_walk;
+        std::vector<Field> m_fields;
+        std::vector<int32_t> m_pending;  // tiles whose walkability changed since Update
+        std::vector<uint8_t> m_isPending;
+    };
+}
@@ -0,0 +1,444 @@
+#include "world/History.h"
+#include "core/Random.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int HISTORY_LENGTH_TO_YEARS[5] = { 100, 250, 500, 1000, 2500 };
+    const int SATURATION_TO_CIVS[5] = { 4, 12, 32, 96, 320 };
+
+    // Secession can grow the number of civilizations up to this multiple
+    constexpr int CIV_CAP_FACTOR = 4;
+
+    // Civilizations per parallel task
+    constexpr int CIV_BLOCK = 32;
+
+    constexpr float SITE_CAPACITY = 20000.0f;     // logistic growth ceiling per site
+    constexpr float SETTLER_POPULATION = 150.0f;  // moved from a site to a new one
+    constexpr float FOUNDING_POPULATION = 2500.0f;
+    constexpr int   MAX_FOUNDED_SITES = 48;       // a civ stops settling past this size
+    constexpr float SETTLE_MIN_DIST = 8.0f;
+    constexpr float SETTLE_MAX_DIST = 28.0f;
+
+    constexpr float WAR_CHANCE = 0.04f;           // per year, times aggression
+    constexpr float PEACE_CHANCE = 0.06f;
+    constexpr float SETTLE_CHANCE = 0.15f;
+    constexpr float SECESSION_CHANCE = 0.004f;    // per year, for civs of SECESSION_MIN_SITES+
+    constexpr int   SECESSION_MIN_SITES = 6;
+    constexpr int   WAR_CANDIDATES = 4;           // nearest of this many random civs becomes the enemy
+    constexpr float RAZE_CHANCE = 0.3f;           // of a won attack
+
+    // Counter-based stream: the draws of (seed, year, civ, purpose) do not
+    // depend on which thread runs the civ or what ran before it
+    struct Rng
+    {
+        uint64_t state;
+
+        Rng(uint32_t seed, int year, int civ, uint32_t purpose)
+            : state(SplitMix64((static_cast<uint64_t>(seed) << 32 | static_cast<uint32_t>(year))
+                ^ SplitMix64((static_cast<uint64_t>(static_cast<uint32_t>(civ)) << 32) | purpose)))
+        {
+        }
+
+        uint64_t Next()
+        {
+            state = SplitMix64(state);
+            return state;
+        }
+
+        float Uniform() { return static_cast<float>(Next() >> 40) * (1.0f / 16777216.0f); }
+        int Below(int n) { return static_cast<int>((Next() >> 33) % static_cast<uint64_t>(n)); }
+    };
+
+    enum PURPOSE : uint32_t
+    {
+        PURPOSE_DECIDE = 1,
+        PURPOSE_BATTLE = 2,
+        PURPOSE_SECEDE = 3,
+        PURPOSE_FOUND = 4,
+    };
+
+    enum class Intent : uint8_t
+    {
+        None, Settle, DeclareWar, MakePeace, Attack, Secede
+    };
+
+    // What a civilization decided this year; one slot per civ, written only
+    // by that civ's task
+    struct Intents
+    {
+        std::vector<Intent> kind;
+        std::vector<int32_t> target;  // civ
+        std::vector<int32_t> site;    // site attacked, seceding or settled from
+        std::vector<float> x;         // new site position
+        std::vector<float> y;
+    };
+
+    class Simulation
+    {
+    public:
+        explicit Simulation(const world::HistoryParams& p) : m_p(p) {}
+
+        world::History Run(ThreadPool& pool)
+        {
+            Rng rng(m_p.seed, -1, 0, PURPOSE_FOUND);
+            for (int c = 0; c < m_p.civilizations; ++c)
+            {
+                const float x = rng.Uniform() * static_cast<float>(m_p.width);
+                const float y = rng.Uniform() * static_cast<float>(m_p.height);
+                const int civ = AddCiv(0, world::HistoryNone, x, y, rng);
+                AddSite(0, civ, x, y, FOUNDING_POPULATION * (0.5f + rng.Uniform()));
+            }
+
+            for (int year = 1; year <= m_p.years; ++year)
+            {
+                m_alive.clear();
+                for (size_t c = 0; c < m_h.civs.Count(); ++c)
+                {
+                    if (m_h.civs.fell[c] == world::HistoryNone)
+                        m_alive.push_back(static_cast<int32_t>(c));
+                }
+
+                const int civs = static_cast<int>(m_h.civs.Count());
+                m_intents.kind.assign(static_cast<size_t>(civs), Intent::None);
+                m_intents.target.resize(static_cast<size_t>(civs));
+                m_intents.site.resize(static_cast<size_t>(civs));
+                m_intents.x.resize(static_cast<size_t>(civs));
+                m_intents.y.resize(static_cast<size_t>(civs));
+
+                const int blocks = (civs + CIV_BLOCK - 1) / CIV_BLOCK;
+                pool.ParallelFor(blocks, [&](int b)
+                {
+                    const int end = std::min(civs, (b + 1) * CIV_BLOCK);
+                    for (int c = b * CIV_BLOCK; c < end; ++c)
+                    {
+                        if (m_h.civs.fell[static_cast<size_t>(c)] == world::HistoryNone)
+                            Decide(year, c);
+                    }
+                });
+
+                for (int c = 0; c < civs; ++c)
+                    Apply(year, c);
+            }
+
+            m_h.years = m_p.years;
+            return std::move(m_h);
+        }
+
+    private:
+        int AddCiv(int year, int parent, float x, float y, Rng& rng)
+        {
+            world::Civilizations& c = m_h.civs;
+            c.founded.push_back(year);
+            c.fell.push_back(world::HistoryNone);
+            c.parent.push_back(parent);
+            c.enemy.push_back(world::HistoryNone);
+            c.aggression.push_back(0.1f + 0.9f * rng.Uniform());
+            c.fertility.push_back(0.01f + 0.03f * rng.Uniform());
+            c.population.push_back(0.0f);
+            c.homeX.push_back(x);
+            c.homeY.push_back(y);
+            m_siteList.emplace_back();
+
+            const int civ = static_cast<int>(c.Count()) - 1;
+            Event(year, world::HistoryEventKind::CivilizationFounded, civ, parent, world::HistoryNone);
+            return civ;
+        }
+
+        int AddSite(int year, int civ, float x, float y, float population)
+        {
+            world::Sites& s = m_h.sites;
+            s.x.push_back(x);
+            s.y.push_back(y);
+            s.owner.push_back(civ);
+            s.founded.push_back(year);
+            s.fell.push_back(world::HistoryNone);
+            s.population.push_back(population);
+
+            const int site = static_cast<int>(s.Count()) - 1;
+            m_siteList[static_cast<size_t>(civ)].push_back(site);
+            Event(year, world::HistoryEventKind::SiteFounded, civ, world::HistoryNone, site);
+            return site;
+        }
+
+        void Event(int year, world::HistoryEventKind kind, int actor, int target, int site)
+        {
+            world::HistoryEvents& e = m_h.events;
+            e.year.push_back(year);
+            e.kind.push_back(kind);
+            e.actor.push_back(actor);
+            e.target.push_back(target);
+            e.site.push_back(site);
+        }
+
+        void RemoveSite(int civ, int site)
+        {
+            std::vector<int32_t>& list = m_siteList[static_cast<size_t>(civ)];
+            const auto it = std::find(list.begin(), list.end(), site);
+            if (it != list.end())
+            {
+                *it = list.back();
+                list.pop_back();
+            }
+        }
+
+        // Phase 1: touches only civ `c`, its sites and its intent slot
+        void Decide(int year, int c)
+        {
+            world::Civilizations& civs = m_h.civs;
+            world::Sites& sites = m_h.sites;
+            const size_t ci = static_cast<size_t>(c);
+            const std::vector<int32_t>& own = m_siteList[ci];
+
+            const float growth = civs.fertility[ci];
+            float total = 0.0f;
+            int largest = -1;
+            for (int32_t s : own)
+            {
+                float& pop = sites.population[static_cast<size_t>(s)];
+                pop += growth * pop * (1.0f - pop / SITE_CAPACITY);
+                total += pop;
+                if (largest < 0 || pop > sites.population[static_cast<size_t>(largest)])
+                    largest = s;
+            }
+            civs.population[ci] = total;
+
+            // An enemy that fell since last year is forgotten
+            int32_t& enemy = civs.enemy[ci];
+            if (enemy != world::HistoryNone && civs.fell[static_cast<size_t>(enemy)] != world::HistoryNone)
+                enemy = world::HistoryNone;
+
+            Rng rng(m_p.seed, year, c, PURPOSE_DECIDE);
+            Intent& intent = m_intents.kind[ci];
+            const float roll = rng.Uniform();
+
+            if (enemy != world::HistoryNone)
+            {
+                const std::vector<int32_t>& theirs = m_siteList[static_cast<size_t>(enemy)];
+                if (roll < PEACE_CHANCE || theirs.empty())
+                {
+                    intent = Intent::MakePeace;
+                    m_intents.target[ci] = enemy;
+                }
+                else if (rng.Uniform() < civs.aggression[ci])
+                {
+                    intent = Intent::Attack;
+                    m_intents.target[ci] = enemy;
+                    m_intents.site[ci] = theirs[static_cast<size_t>(rng.Below(static_cast<int>(theirs.size())))];
+                }
+                return;
+            }
+
+            if (roll < WAR_CHANCE * civs.aggression[ci] && m_alive.size() > 1)
+            {
+                // Nearest of a few random civilizations, so wars stay mostly local
+                int32_t best = world::HistoryNone;
+                float bestDist = 0.0f;
+                for (int k = 0; k < WAR_CANDIDATES; ++k)
+                {
+                    const int32_t other = m_alive[static_cast<size_t>(rng.Below(static_cast<int>(m_alive.size())))];
+                    if (other == c)
+                        continue;
+
+                    const float dx = civs.homeX[static_cast<size_t>(other)] - civs.homeX[ci];
+                    const float dy = civs.homeY[static_cast<size_t>(other)] - civs.homeY[ci];
+                    const float d = dx * dx + dy * dy;
+                    if (best == world::HistoryNone || d < bestDist)
+                    {
+                        best = other;
+                        bestDist = d;
+                    }
+                }
+
+                if (best != world::HistoryNone)
+                {
+                    intent = Intent::DeclareWar;
+                    m_intents.target[ci] = best;
+                }
+                return;
+            }
+
+            const float settle = rng.Uniform();
+            if (largest >= 0 && settle < SETTLE_CHANCE && static_cast<int>(own.size()) < MAX_FOUNDED_SITES
+                && sites.population[static_cast<size_t>(largest)] > 4.0f * SETTLER_POPULATION)
+            {
+                const float angle = rng.Uniform() * 6.2831853f;
+                const float dist = SETTLE_MIN_DIST + (SETTLE_MAX_DIST - SETTLE_MIN_DIST) * rng.Uniform();
+                const size_t from = static_cast<size_t>(largest);
+
+                intent = Intent::Settle;
+                m_intents.site[ci] = largest;
+                m_intents.x[ci] = std::clamp(sites.x[from] + std::cos(angle) * dist, 0.0f, static_cast<float>(m_p.width - 1));
+                m_intents.y[ci] = std::clamp(sites.y[from] + std::sin(angle) * dist, 0.0f, static_cast<float>(m_p.height - 1));
+                return;
+            }
+
+            if (static_cast<int>(own.size()) >= SECESSION_MIN_SITES && rng.Uniform() < SECESSION_CHANCE)
+            {
+                // Never the capital (the first site)
+                intent = Intent::Secede;
+                m_intents.site[ci] = own[1 + static_cast<size_t>(rng.Below(static_cast<int>(own.size()) - 1))];
+            }
+        }
+
+        // Phase 2: serial, in civilization order; rechecks every intent
+        // against what earlier civilizations did this year
+        void Apply(int year, int c)
+        {
+            world::Civilizations& civs = m_h.civs;
+            world::Sites& sites = m_h.sites;
+            const size_t ci = static_cast<size_t>(c);
+            if (civs.fell[ci] != world::HistoryNone)
+                return;
+
+            const int32_t target = m_intents.target[ci];
+            switch (m_intents.kind[ci])
+            {
+            case Intent::None:
+                break;
+
+            case Intent::MakePeace:
+                if (civs.enemy[ci] == target)
+                {
+                    civs.enemy[ci] = world::HistoryNone;
+                    if (civs.enemy[static_cast<size_t>(target)] == c)
+                        civs.enemy[static_cast<size_t>(target)] = world::HistoryNone;
+                    Event(year, world::HistoryEventKind::PeaceMade, c, target, world::HistoryNone);
+                }
+                break;
+
+            case Intent::DeclareWar:
+                if (civs.enemy[ci] == world::HistoryNone && civs.fell[static_cast<size_t>(target)] == world::HistoryNone)
+                {
+                    civs.enemy[ci] = target;
+                    if (civs.enemy[static_cast<size_t>(target)] == world::HistoryNone)
+                        civs.enemy[static_cast<size_t>(target)] = c;
+                    Event(year, world::HistoryEventKind::WarDeclared, c, target, world::HistoryNone);
+                }
+                break;
+
+            case Intent::Attack:
+            {
+                const int32_t site = m_intents.site[ci];
+                const size_t si = static_cast<size_t>(site);
+                if (sites.owner[si] != target || civs.enemy[ci] != target)
+                    break;
+
+                Rng rng(m_p.seed, year, c, PURPOSE_BATTLE);
+                const float attack = civs.population[ci] * civs.aggression[ci] * (0.5f + rng.Uniform());
+                const float defence = sites.population[si] * 2.0f * (0.5f + rng.Uniform());
+                const size_t capital = static_cast<size_t>(m_siteList[ci].front());
+
+                if (attack <= defence)
+                {
+                    sites.population[capital] *= 0.8f;
+                    break;
+                }
+
+                sites.population[capital] *= 0.9f;
+                RemoveSite(target, site);
+                if (rng.Uniform() < RAZE_CHANCE)
+                {
+                    sites.owner[si] = world::HistoryNone;
+                    sites.fell[si] = year;
+                    sites.population[si] = 0.0f;
+                    Event(year, world::HistoryEventKind::SiteRazed, c, target, site);
+                }
+                else
+                {
+                    sites.owner[si] = c;
+                    sites.population[si] *= 0.5f;
+                    m_siteList[ci].push_back(site);
+                    Event(year, world::HistoryEventKind::SiteConquered, c, target, site);
+                }
+
+                if (m_siteList[static_cast<size_t>(target)].empty())
+                {
+                    civs.fell[static_cast<size_t>(target)] = year;
+                    civs.enemy[static_cast<size_t>(target)] = world::HistoryNone;
+                    civs.enemy[ci] = world::HistoryNone;
+                    Event(year, world::HistoryEventKind::CivilizationFell, target, c, site);
+                }
+                break;
+            }
+
+            case Intent::Settle:
+            {
+                const size_t from = static_cast<size_t>(m_intents.site[ci]);
+                if (sites.owner[from] != c)
+                    break;
+
+                sites.population[from] -= SETTLER_POPULATION;
+                AddSite(year, c, m_intents.x[ci], m_intents.y[ci], SETTLER_POPULATION);
+                break;
+            }
+
+            case Intent::Secede:
+            {
+                const int32_t site = m_intents.site[ci];
+                const size_t si = static_cast<size_t>(site);
+                if (sites.owner[si] != c || m_siteList[ci].size() < 2
+                    || static_cast<int>(civs.Count()) >= m_p.maxCivilizations)
+                    break;
+
+                Rng rng(m_p.seed, year, c, PURPOSE_SECEDE);
+                RemoveSite(c, site);
+                const int rebel = AddCiv(year, c, sites.x[si], sites.y[si], rng);
+                sites.owner[si] = rebel;
+                m_siteList[static_cast<size_t>(rebel)].push_back(site);
+                Event(year, world::HistoryEventKind::Secession, rebel, c, site);
+                break;
+            }
+            }
+        }
+
+        const world::HistoryParams m_p;
+        world::History m_h;
+        Intents m_intents;
+        std::vector<int32_t> m_alive;
+        std::vector<std::vector<int32_t>> m_siteList;  // per civ, capital first
+    };
+}
+
+namespace world
+{
+    HistoryParams WorldHistoryParams(const WorldGenSettings& settings, uint32_t seed, int w, int h)
+    {
+        HistoryParams p;
+        p.years = HISTORY_LENGTH_TO_YEARS[std::clamp(settings.historyLength, 0, 4)];
+        p.civilizations = SATURATION_TO_CIVS[std::clamp(settings.civilizationSaturation, 0, 4)];
+        p.maxCivilizations = p.civilizations * CIV_CAP_FACTOR;
+        p.width = w;
+        p.height = h;
+        p.seed = seed;
+        return p;
+    }
+
+    History SimulateHistory(const HistoryParams& p, ThreadPool& pool)
+    {
+        if (p.width <= 0 || p.height <= 0 || p.civilizations <= 0)
+            return History{};
+
+        Simulation sim(p);
+        return sim.Run(pool);
+    }
+
+    const char* HistoryEventName(HistoryEventKind kind)
+    {
+        switch (kind)
+        {
+        case HistoryEventKind::CivilizationFounded: return "civilization founded";
+        case HistoryEventKind::SiteFounded: return "site founded";
+        case HistoryEventKind::WarDeclared: return "war declared";
+        case HistoryEventKind::PeaceMade: return "peace made";
+        case HistoryEventKind::SiteConquered: return "site conquered";
+        case HistoryEventKind::SiteRazed: return "site razed";
+        case HistoryEventKind::Secession: return "secession";
+        case HistoryEventKind::CivilizationFell: return "civilization fell";
+        }
+        return "?";
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "world/WorldGenSettings.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // Year-by-year history of the civilizations of a world: foundings, wars,
+    // conquests and falls. Entities live in struct-of-arrays tables indexed
+    // by id; ids are assigned in creation order and never reused.
+    struct HistoryParams
+    {
+        int      years = 0;
+        int      civilizations = 0;      // at year 0
+        int      maxCivilizations = 0;   // cap for civilizations born from secession
+        int      width = 0;              // map extent sites are placed in
+        int      height = 0;
+        uint32_t seed = 1337;
+    };
+
+    // WorldGenSettings::historyLength (0 = Primal .. 4 = Ancient) sets the
+    // years, civilizationSaturation (0 = Scarce .. 4 = Excessive) the civs
+    HistoryParams WorldHistoryParams(const WorldGenSettings& settings, uint32_t seed, int w, int h);
+
+    constexpr int32_t HistoryNone = -1;
+
+    struct Civilizations
+    {
+        std::vector<int32_t> founded;     // year
+        std::vector<int32_t> fell;        // year, or HistoryNone while it stands
+        std::vector<int32_t> parent;      // civ it seceded from, or HistoryNone
+        std::vector<int32_t> enemy;       // civ it is at war with, or HistoryNone
+        std::vector<float>   aggression;  // 0..1, chance-weighted per year
+        std::vector<float>   fertility;   // yearly growth rate of its sites
+        std::vector<float>   population;  // sum over its sites, as of the last year
+        std::vector<float>   homeX;       // where it was founded
+        std::vector<float>   homeY;
+
+        size_t Count() const { return founded.size(); }
+    };
+
+    struct Sites
+    {
+        std::vector<float>   x;
+        std::vector<float>   y;
+        std::vector<int32_t> owner;       // civ, or HistoryNone once razed
+        std::vector<int32_t> founded;     // year
+        std::vector<int32_t> fell;        // year it was razed, or HistoryNone
+        std::vector<float>   population;
+
+        size_t Count() const { return x.size(); }
+    };
+
+    enum class HistoryEventKind : uint8_t
+    {
+        CivilizationFounded,  // actor
+        SiteFounded,          // actor, site
+        WarDeclared,          // actor on target
+        PeaceMade,            // actor with target
+        SiteConquered,        // actor took site from target
+        SiteRazed,            // actor destroyed site of target
+        Secession,            // actor broke away from target, taking site
+        CivilizationFell,     // actor, last taken by target (or HistoryNone)
+    };
+
+    struct HistoryEvents
+    {
+        std::vector<int32_t> year;
+        std::vector<HistoryEventKind> kind;
+        std::vector<int32_t> actor;
+        std::vector<int32_t> target;
+        std::vector<int32_t> site;
+
+        size_t Count() const { return year.size(); }
+    };
+
+    struct History
+    {
+        int years = 0;
+        Civilizations civs;
+        Sites sites;
+        HistoryEvents events;
+    };
+
+    // Runs the whole history. Every year has two phases:
+    //  - civilizations are updated in parallel: each grows its own sites and
+    //    writes at most one intent (found a site, declare war or peace,
+    //    attack a site, secede), drawing randomness from (seed, year, civ);
+    //  - intents are then applied serially in civilization order, which
+    //    resolves conflicts (two attacks on one site) and appends events.
+    // The result is therefore identical for any thread count.
+    History SimulateHistory(const HistoryParams& p, ThreadPool& pool);
+
+    const char* HistoryEventName(HistoryEventKind kind);
+}
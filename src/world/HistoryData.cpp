@@ -0,0 +1,339 @@
+#include "world/HistoryData.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    char Lower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    std::string_view Trim(std::string_view s)
+    {
+        const auto space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; };
+        while (!s.empty() && space(s.front()))
+            s.remove_prefix(1);
+        while (!s.empty() && space(s.back()))
+            s.remove_suffix(1);
+        return s;
+    }
+
+    bool StartsWithNoCase(std::string_view s, std::string_view prefix)
+    {
+        return s.size() >= prefix.size() && world::EqualsNoCase(s.substr(0, prefix.size()), prefix);
+    }
+
+    enum class SectionKind : uint8_t
+    {
+        None, Names, Pool, Template
+    };
+
+    // A header's entries as parsed, before sections of one name are merged
+    struct RawSection
+    {
+        SectionKind kind = SectionKind::None;
+        std::string_view name;
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    // Appends the entries of `raw` sections of `kind` to the lists, merging
+    // by name, and rebuilds `entries` so every list stays contiguous
+    template <class T>
+    void MergeLists(std::vector<world::HistoryList>& lists, std::vector<T>& entries,
+        const std::vector<RawSection>& raw, SectionKind kind, const std::vector<T>& rawEntries)
+    {
+        std::vector<std::vector<T>> grouped(lists.size());
+        for (size_t l = 0; l < lists.size(); ++l)
+        {
+            grouped[l].assign(entries.begin() + lists[l].first,
+                entries.begin() + lists[l].first + lists[l].count);
+        }
+
+        for (const RawSection& s : raw)
+        {
+            if (s.kind != kind)
+                continue;
+
+            size_t l = 0;
+            while (l < lists.size() && !world::EqualsNoCase(lists[l].name, s.name))
+                ++l;
+            if (l == lists.size())
+            {
+                world::HistoryList list;
+                list.name = s.name;
+                lists.push_back(list);
+                grouped.emplace_back();
+            }
+
+            grouped[l].insert(grouped[l].end(), rawEntries.begin() + s.first, rawEntries.begin() + s.first + s.count);
+        }
+
+        entries.clear();
+        for (size_t l = 0; l < lists.size(); ++l)
+        {
+            lists[l].first = static_cast<uint32_t>(entries.size());
+            lists[l].count = static_cast<uint32_t>(grouped[l].size());
+            entries.insert(entries.end(), grouped[l].begin(), grouped[l].end());
+        }
+    }
+}
+
+namespace world
+{
+    bool EqualsNoCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (Lower(a[i]) != Lower(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // Tags
+    // ---------------------------------------------------------------------
+
+    size_t TagTable::Hash::operator()(std::string_view s) const
+    {
+        // FNV-1a over the lowercased bytes
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (char c : s)
+        {
+            h ^= static_cast<uint8_t>(Lower(c));
+            h *= 0x100000001B3ull;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    bool TagTable::Equal::operator()(std::string_view a, std::string_view b) const
+    {
+        return EqualsNoCase(a, b);
+    }
+
+    TagId TagTable::Intern(std::string_view tag)
+    {
+        if (const auto it = m_ids.find(tag); it != m_ids.end())
+            return it->second;
+
+        if (m_names.size() >= NoTag)
+            return NoTag;
+
+        const TagId id = static_cast<TagId>(m_names.size());
+        m_names.push_back(tag);
+        m_ids.emplace(tag, id);
+        return id;
+    }
+
+    TagId TagTable::Find(std::string_view tag) const
+    {
+        const auto it = m_ids.find(tag);
+        return (it != m_ids.end()) ? it->second : NoTag;
+    }
+
+    // ---------------------------------------------------------------------
+    // Loading
+    // ---------------------------------------------------------------------
+
+    bool HistoryData::Load(const std::string& path, std::string& error)
+    {
+        auto file = std::make_unique<MappedFile>();
+        if (!file->Open(path, error))
+            return false;
+
+        const std::string_view text(reinterpret_cast<const char*>(file->Data()), file->Size());
+        if (!Parse(text, path, error))
+            return false;
+
+        m_files.push_back(std::move(file));
+        return true;
+    }
+
+    bool HistoryData::Parse(std::string_view text, std::string_view source, std::string& error)
+    {
+        // Everything goes to scratch first so a failed parse adds nothing
+        std::vector<HistoryName> names;
+        std::vector<TagId> nameTags;
+        TagTable tags = m_tags;
+        std::vector<RawSection> sections;
+        std::vector<std::string_view> poolEntries;
+        std::vector<HistoryTemplate> templates;
+
+        RawSection* section = nullptr;
+        int line = 0;
+
+        const auto fail = [&](std::string_view why)
+        {
+            error.assign(source);
+            error += ":" + std::to_string(line) + ": ";
+            error += why;
+            return false;
+        };
+
+        // UTF-8 byte order mark
+        if (text.substr(0, 3) == "\xEF\xBB\xBF")
+            text.remove_prefix(3);
+
+        while (!text.empty())
+        {
+            ++line;
+            const char* end = static_cast<const char*>(std::memchr(text.data(), '\n', text.size()));
+            const size_t length = end ? static_cast<size_t>(end - text.data()) : text.size();
+            const std::string_view s = Trim(text.substr(0, length));
+            text.remove_prefix(end ? length + 1 : length);
+
+            if (s.empty() || s.front() == '#' || s.substr(0, 2) == "//")
+                continue;
+
+            if (s.front() == '[')
+            {
+                if (s.back() != ']')
+                    return fail("header is missing its closing ']'");
+
+                const std::string_view header = Trim(s.substr(1, s.size() - 2));
+                RawSection next;
+                if (EqualsNoCase(header, "NAME"))
+                {
+                    next.kind = SectionKind::Names;
+                }
+                else if (StartsWithNoCase(header, "POOL:"))
+                {
+                    next.kind = SectionKind::Pool;
+                    next.name = Trim(header.substr(5));
+                    next.first = static_cast<uint32_t>(poolEntries.size());
+                }
+                else if (StartsWithNoCase(header, "TEMPLATE:"))
+                {
+                    next.kind = SectionKind::Template;
+                    next.name = Trim(header.substr(9));
+                    next.first = static_cast<uint32_t>(templates.size());
+                }
+                else
+                {
+                    return fail("unknown section [" + std::string(header) + "]; expected [NAME], [POOL:*] or [TEMPLATE:*]");
+                }
+
+                if (next.kind != SectionKind::Names && next.name.empty())
+                    return fail("section [" + std::string(header) + "] has no name");
+
+                sections.push_back(next);
+                section = &sections.back();
+                continue;
+            }
+
+            if (!section)
+                return fail("entry before the first section header");
+
+            switch (section->kind)
+            {
+            case SectionKind::Names:
+            {
+                const size_t bar = s.find('|');
+                HistoryName name;
+                name.text = Trim(s.substr(0, bar));
+                name.firstTag = static_cast<uint32_t>(m_nameTags.size() + nameTags.size());
+                if (name.text.empty())
+                    return fail("name entry has no name");
+
+                if (bar != std::string_view::npos)
+                {
+                    std::string_view list = Trim(s.substr(bar + 1));
+                    if (!StartsWithNoCase(list, "tags:"))
+                        return fail("expected 'tags:' after '|'");
+                    list.remove_prefix(5);
+
+                    while (true)
+                    {
+                        const size_t comma = list.find(',');
+                        const std::string_view tag = Trim(list.substr(0, comma));
+                        if (tag.empty())
+                            return fail("empty tag in the tag list of '" + std::string(name.text) + "'");
+
+                        const TagId id = tags.Intern(tag);
+                        if (id == NoTag)
+                            return fail("too many distinct tags");
+
+                        nameTags.push_back(id);
+                        ++name.tagCount;
+                        if (comma == std::string_view::npos)
+                            break;
+                        list.remove_prefix(comma + 1);
+                    }
+                }
+
+                names.push_back(name);
+                break;
+            }
+
+            case SectionKind::Pool:
+                poolEntries.push_back(s);
+                ++section->count;
+                break;
+
+            case SectionKind::Template:
+            {
+                HistoryTemplate t;
+                t.text = s;
+                if (StartsWithNoCase(s, "weight="))
+                {
+                    const size_t bar = s.find('|');
+                    if (bar == std::string_view::npos)
+                        return fail("expected '|' between the weight and the template");
+
+                    const std::string_view number = Trim(s.substr(7, bar - 7));
+                    const auto [ptr, ec] = std::from_chars(number.data(), number.data() + number.size(), t.weight);
+                    if (ec != std::errc() || ptr != number.data() + number.size() || !(t.weight > 0.0f))
+                        return fail("weight must be a positive number, got '" + std::string(number) + "'");
+
+                    t.text = Trim(s.substr(bar + 1));
+                }
+
+                if (t.text.empty())
+                    return fail("empty template");
+
+                templates.push_back(t);
+                ++section->count;
+                break;
+            }
+
+            case SectionKind::None:
+                break;
+            }
+        }
+
+        m_names.insert(m_names.end(), names.begin(), names.end());
+        m_nameTags.insert(m_nameTags.end(), nameTags.begin(), nameTags.end());
+        m_tags = std::move(tags);
+        MergeLists(m_pools, m_poolEntries, sections, SectionKind::Pool, poolEntries);
+        MergeLists(m_templateGroups, m_templates, sections, SectionKind::Template, templates);
+        return true;
+    }
+
+    const HistoryList* HistoryData::FindPool(std::string_view name) const
+    {
+        for (const HistoryList& l : m_pools)
+        {
+            if (EqualsNoCase(l.name, name))
+                return &l;
+        }
+        return nullptr;
+    }
+
+    const HistoryList* HistoryData::FindTemplates(std::string_view name) const
+    {
+        for (const HistoryList& l : m_templateGroups)
+        {
+            if (EqualsNoCase(l.name, name))
+                return &l;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "core/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace world
+{
+    // Dense ids for the tags of name entries (`human`, `city`, ...), in order
+    // of first appearance. Tags compare case-insensitively (ASCII).
+    using TagId = uint16_t;
+    constexpr TagId NoTag = 0xFFFF;
+
+    class TagTable
+    {
+    public:
+        // Id of `tag`, adding it if new. NoTag once the table is full.
+        TagId Intern(std::string_view tag);
+        TagId Find(std::string_view tag) const;
+
+        std::string_view Name(TagId id) const { return m_names[id]; }
+        size_t Count() const { return m_names.size(); }
+
+    private:
+        struct Hash
+        {
+            size_t operator()(std::string_view s) const;
+        };
+        struct Equal
+        {
+            bool operator()(std::string_view a, std::string_view b) const;
+        };
+
+        std::vector<std::string_view> m_names;
+        std::unordered_map<std::string_view, TagId, Hash, Equal> m_ids;
+    };
+
+    // ASCII case-insensitive comparison, as used for headers, pools and tags
+    bool EqualsNoCase(std::string_view a, std::string_view b);
+
+    struct HistoryName
+    {
+        std::string_view text;
+        uint32_t firstTag = 0;  // into HistoryData::NameTags()
+        uint32_t tagCount = 0;
+    };
+
+    // A [POOL:*] or [TEMPLATE:*] section; sections of the same name (any
+    // case, any file) are merged into one list
+    struct HistoryList
+    {
+        std::string_view name;
+        uint32_t first = 0;  // into PoolEntries() / Templates()
+        uint32_t count = 0;
+    };
+
+    struct HistoryTemplate
+    {
+        std::string_view text;  // with {slot} placeholders
+        float weight = 1.0f;
+    };
+
+    // The history data files (assets/data/history_data*.txt):
+    //
+    //   # comment                   (also // comment)
+    //   [NAME]
+    //   Fourdock | tags:city,human
+    //   [POOL:CONCEPTS]
+    //   Fire
+    //   [TEMPLATE:WARS]
+    //   weight=8 | The War of {concept}
+    //
+    // Files are memory-mapped and every string is a view into the mapping, so
+    // parsing allocates per section and per new tag, never per line. The
+    // views stay valid as long as the HistoryData lives.
+    class HistoryData
+    {
+    public:
+        // Maps and parses `path`, adding to what is already loaded. On failure
+        // nothing is added and `error` reads "<path>:<line>: <reason>".
+        bool Load(const std::string& path, std::string& error);
+
+        // Parses text the caller keeps alive; `source` names it in errors
+        bool Parse(std::string_view text, std::string_view source, std::string& error);
+
+        const std::vector<HistoryName>& Names() const { return m_names; }
+        const std::vector<TagId>& NameTags() const { return m_nameTags; }
+        const TagTable& Tags() const { return m_tags; }
+
+        const std::vector<HistoryList>& Pools() const { return m_pools; }
+        const std::vector<std::string_view>& PoolEntries() const { return m_poolEntries; }
+        const HistoryList* FindPool(std::string_view name) const;
+
+        const std::vector<HistoryList>& TemplateGroups() const { return m_templateGroups; }
+        const std::vector<HistoryTemplate>& Templates() const { return m_templates; }
+        const HistoryList* FindTemplates(std::string_view name) const;
+
+    private:
+        std::vector<std::unique_ptr<MappedFile>> m_files;
+
+        std::vector<HistoryName> m_names;
+        std::vector<TagId> m_nameTags;
+        TagTable m_tags;
+
+        std::vector<HistoryList> m_pools;
+        std::vector<std::string_view> m_poolEntries;
+        std::vector<HistoryList> m_templateGroups;
+        std::vector<HistoryTemplate> m_templates;
+    };
+}
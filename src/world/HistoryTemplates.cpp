@@ -0,0 +1,276 @@
+#include "world/HistoryTemplates.h"
+#include "core/Random.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Slot tokens one template may hold
+    constexpr int MAX_TEMPLATE_SLOTS_USED = 32;
+
+    uint32_t Below(uint64_t r, size_t n)
+    {
+        return static_cast<uint32_t>(((r >> 32) * static_cast<uint64_t>(n)) >> 32);
+    }
+}
+
+namespace world
+{
+    // ---------------------------------------------------------------------
+    // Arena
+    // ---------------------------------------------------------------------
+
+    char* TextArena::Reserve(size_t bytes)
+    {
+        while (m_block < m_blocks.size() && m_used + bytes > m_blockSize[m_block])
+        {
+            ++m_block;
+            m_used = 0;
+        }
+
+        if (m_block == m_blocks.size())
+        {
+            const size_t size = std::max(BlockBytes, bytes);
+            m_blocks.push_back(std::make_unique<char[]>(size));
+            m_blockSize.push_back(size);
+            m_used = 0;
+        }
+
+        return m_blocks[m_block].get() + m_used;
+    }
+
+    std::string_view TextArena::Commit(const char* begin, size_t bytes)
+    {
+        m_used += bytes;
+        return std::string_view(begin, bytes);
+    }
+
+    void TextArena::Clear()
+    {
+        m_block = 0;
+        m_used = 0;
+    }
+
+    size_t TextArena::BytesUsed() const
+    {
+        size_t bytes = m_used;
+        for (size_t b = 0; b < m_block; ++b)
+            bytes += m_blockSize[b];
+        return bytes;
+    }
+
+    // ---------------------------------------------------------------------
+    // Compilation
+    // ---------------------------------------------------------------------
+
+    int TemplateSet::SlotFor(const HistoryData& data, std::string_view name, std::string& error)
+    {
+        for (size_t s = 0; s < m_slots.size(); ++s)
+        {
+            if (EqualsNoCase(m_slots[s].name, name))
+                return static_cast<int>(s);
+        }
+
+        if (m_slots.size() >= MaxTemplateSlots)
+        {
+            error = "more than " + std::to_string(MaxTemplateSlots) + " distinct template slots";
+            return -1;
+        }
+
+        Slot slot;
+        slot.name = name;
+
+        const std::string base(name);
+        std::string plurals[4] = { base + "s", base + "es", base, base };
+        if (!base.empty() && (base.back() == 'y' || base.back() == 'Y'))
+            plurals[3] = base.substr(0, base.size() - 1) + "ies";
+
+        for (const std::string& pool : plurals)
+        {
+            if (const HistoryList* list = data.FindPool(pool))
+            {
+                slot.values.assign(data.PoolEntries().begin() + list->first,
+                    data.PoolEntries().begin() + list->first + list->count);
+                break;
+            }
+        }
+
+        if (slot.values.empty())
+        {
+            const TagId tag = data.Tags().Find(name);
+            for (const HistoryName& n : data.Names())
+            {
+                for (uint32_t t = 0; t < n.tagCount && tag != NoTag; ++t)
+                {
+                    if (data.NameTags()[n.firstTag + t] == tag)
+                    {
+                        slot.values.push_back(n.text);
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (slot.values.empty())
+        {
+            error = "slot {" + base + "} matches no pool and no tagged name";
+            return -1;
+        }
+
+        m_slots.push_back(std::move(slot));
+        return static_cast<int>(m_slots.size()) - 1;
+    }
+
+    bool TemplateSet::Compile(const HistoryData& data, std::string& error)
+    {
+        m_tokens.clear();
+        m_templates.clear();
+        m_cumulative.clear();
+        m_groups.clear();
+        m_slots.clear();
+
+        for (const HistoryList& list : data.TemplateGroups())
+        {
+            Group group;
+            group.name = list.name;
+            group.first = static_cast<uint32_t>(m_templates.size());
+            group.count = list.count;
+
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < list.count; ++i)
+            {
+                const HistoryTemplate& t = data.Templates()[list.first + i];
+                const std::string_view text = t.text;
+                const auto fail = [&](const std::string& why)
+                {
+                    error = "[TEMPLATE:" + std::string(list.name) + "] \"" + std::string(text) + "\": " + why;
+                    return false;
+                };
+
+                Compiled c;
+                c.firstToken = static_cast<uint32_t>(m_tokens.size());
+                int slotsUsed = 0;
+
+                size_t pos = 0;
+                while (pos < text.size())
+                {
+                    const size_t open = text.find('{', pos);
+                    const size_t literalEnd = (open == std::string_view::npos) ? text.size() : open;
+                    if (literalEnd > pos)
+                    {
+                        Token lit;
+                        lit.text = text.data() + pos;
+                        lit.length = static_cast<uint32_t>(literalEnd - pos);
+                        m_tokens.push_back(lit);
+                        c.literalBytes += lit.length;
+                    }
+                    if (open == std::string_view::npos)
+                        break;
+
+                    const size_t close = text.find('}', open);
+                    if (close == std::string_view::npos)
+                        return fail("unclosed '{'");
+
+                    std::string why;
+                    const int slot = SlotFor(data, text.substr(open + 1, close - open - 1), why);
+                    if (slot < 0)
+                        return fail(why);
+                    if (++slotsUsed > MAX_TEMPLATE_SLOTS_USED)
+                        return fail("too many slots in one template");
+
+                    Token token;
+                    token.slot = static_cast<uint16_t>(slot);
+                    m_tokens.push_back(token);
+                    pos = close + 1;
+                }
+
+                c.tokenCount = static_cast<uint32_t>(m_tokens.size()) - c.firstToken;
+                m_templates.push_back(c);
+                sum += t.weight;
+                m_cumulative.push_back(sum);
+            }
+
+            m_groups.push_back(group);
+        }
+
+        return true;
+    }
+
+    int TemplateSet::FindGroup(std::string_view name) const
+    {
+        for (size_t g = 0; g < m_groups.size(); ++g)
+        {
+            if (EqualsNoCase(m_groups[g].name, name))
+                return static_cast<int>(g);
+        }
+        return -1;
+    }
+
+    int TemplateSet::FindSlot(std::string_view name) const
+    {
+        for (size_t s = 0; s < m_slots.size(); ++s)
+        {
+            if (EqualsNoCase(m_slots[s].name, name))
+                return static_cast<int>(s);
+        }
+        return -1;
+    }
+
+    // ---------------------------------------------------------------------
+    // Expansion
+    // ---------------------------------------------------------------------
+
+    std::string_view TemplateSet::Expand(int group, uint64_t key, TextArena& out, const std::string_view* bound) const
+    {
+        if (group < 0 || group >= static_cast<int>(m_groups.size()) || m_groups[static_cast<size_t>(group)].count == 0)
+            return {};
+
+        const Group& g = m_groups[static_cast<size_t>(group)];
+        uint64_t r = SplitMix64(key ^ (static_cast<uint64_t>(group) << 56));
+
+        // Weighted pick: groups are a handful of templates, a linear scan of
+        // the running sums beats anything cleverer
+        const float* sums = m_cumulative.data() + g.first;
+        const float pick = static_cast<float>(r >> 40) * (1.0f / 16777216.0f) * sums[g.count - 1];
+        uint32_t k = 0;
+        while (k + 1 < g.count && sums[k] <= pick)
+            ++k;
+
+        const Compiled& c = m_templates[g.first + k];
+        const Token* tokens = m_tokens.data() + c.firstToken;
+
+        std::string_view values[MAX_TEMPLATE_SLOTS_USED];
+        size_t bytes = c.literalBytes;
+        int used = 0;
+        for (uint32_t i = 0; i < c.tokenCount; ++i)
+        {
+            if (tokens[i].slot == LITERAL)
+                continue;
+
+            std::string_view v = bound ? bound[tokens[i].slot] : std::string_view{};
+            if (v.empty())
+            {
+                const Slot& slot = m_slots[tokens[i].slot];
+                r = SplitMix64(r);
+                v = slot.values[Below(r, slot.values.size())];
+            }
+
+            values[used++] = v;
+            bytes += v.size();
+        }
+
+        char* const begin = out.Reserve(bytes);
+        char* p = begin;
+        used = 0;
+        for (uint32_t i = 0; i < c.tokenCount; ++i)
+        {
+            const std::string_view v = (tokens[i].slot == LITERAL)
+                ? std::string_view(tokens[i].text, tokens[i].length) : values[used++];
+            std::memcpy(p, v.data(), v.size());
+            p += v.size();
+        }
+
+        return out.Commit(begin, bytes);
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "world/HistoryData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace world
+{
+    // Append-only text storage in fixed blocks. Views it returns stay valid
+    // until Clear(), which keeps the blocks for reuse.
+    class TextArena
+    {
+    public:
+        static constexpr size_t BlockBytes = 64 * 1024;
+
+        // Room for `bytes` contiguous chars; fill them, then Commit
+        char* Reserve(size_t bytes);
+        std::string_view Commit(const char* begin, size_t bytes);
+
+        void Clear();
+        size_t BytesUsed() const;
+
+    private:
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        std::vector<size_t> m_blockSize;
+        size_t m_block = 0;  // block being filled
+        size_t m_used = 0;   // in that block
+    };
+
+    using SlotId = uint16_t;
+    constexpr int MaxTemplateSlots = 32;
+
+    // The [TEMPLATE:*] groups of a HistoryData, compiled into token streams.
+    // A template like "The Fall of {city}" becomes a literal span of its text
+    // followed by slot `city`; expanding one is a few memcpys into an arena.
+    //
+    // A slot {x} draws from the first of pool X+"S", X+"ES", X (Y -> IES, so
+    // {city} tries CITIES) that exists, otherwise from the names tagged x.
+    // Callers can bind a slot to a fixed value instead, e.g. the actual city
+    // of a history event.
+    class TemplateSet
+    {
+    public:
+        // Compiles every template group of `data`, which must outlive the set.
+        // Fails on an unclosed '{' or a slot with nothing to draw from.
+        bool Compile(const HistoryData& data, std::string& error);
+
+        // -1 if there is no such group / slot (case-insensitive)
+        int FindGroup(std::string_view name) const;
+        int FindSlot(std::string_view name) const;
+        int GroupCount() const { return static_cast<int>(m_groups.size()); }
+        int SlotCount() const { return static_cast<int>(m_slots.size()); }
+
+        // Picks a template of `group` by weight and fills its slots. The same
+        // (group, key, bindings) always gives the same text. `bound`, if
+        // given, has SlotCount() entries; a non-empty entry replaces the draw.
+        std::string_view Expand(int group, uint64_t key, TextArena& out, const std::string_view* bound = nullptr) const;
+
+    private:
+        static constexpr uint16_t LITERAL = 0xFFFF;
+
+        struct Token
+        {
+            const char* text = nullptr;  // literal, into the data file
+            uint32_t length = 0;
+            uint16_t slot = LITERAL;
+        };
+
+        struct Compiled
+        {
+            uint32_t firstToken = 0;
+            uint32_t tokenCount = 0;
+            uint32_t literalBytes = 0;
+        };
+
+        struct Group
+        {
+            std::string_view name;
+            uint32_t first = 0;  // into m_templates / m_cumulative
+            uint32_t count = 0;
+        };
+
+        struct Slot
+        {
+            std::string_view name;
+            std::vector<std::string_view> values;
+        };
+
+        int SlotFor(const HistoryData& data, std::string_view name, std::string& error);
+
+        std::vector<Token> m_tokens;
+        std::vector<Compiled> m_templates;
+        std::vector<float> m_cumulative;  // weights, running sum per group
+        std::vector<Group> m_groups;
+        std::vector<Slot> m_slots;
+    };
+}
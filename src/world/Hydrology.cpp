@@ -0,0 +1,550 @@
+#include "world/Hydrology.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int FLOOD_LEVELS = 1 << 16;   // quantized heights in the flood queue
+    constexpr int FLOW_TILE = 256;          // flow accumulation tile edge
+    static_assert(FLOW_TILE * FLOW_TILE <= 1 << 16, "tile-local indices are stored in 16 bits");
+    constexpr int DIR_ROWS_PER_TASK = 16;
+
+    constexpr float DIAGONAL = 0.70710678f; // 1 / sqrt(2)
+    constexpr float INV_DIST[8] = { 1.0f, DIAGONAL, 1.0f, DIAGONAL, 1.0f, DIAGONAL, 1.0f, DIAGONAL };
+
+    // Monotone bucket queue: pops never go below the last popped level, and
+    // the flood only pushes at or above it. One FIFO list per level, linked
+    // through `next`, so push and pop are O(1) and a sweep is O(levels).
+    class BucketQueue
+    {
+    public:
+        BucketQueue(int levels, size_t cells)
+            : m_head(static_cast<size_t>(levels), -1), m_tail(static_cast<size_t>(levels), -1), m_next(cells, -1)
+        {
+        }
+
+        void Push(int level, int cell)
+        {
+            m_next[static_cast<size_t>(cell)] = -1;
+
+            int& tail = m_tail[static_cast<size_t>(level)];
+            if (tail < 0)
+                m_head[static_cast<size_t>(level)] = cell;
+            else
+                m_next[static_cast<size_t>(tail)] = cell;
+            tail = cell;
+        }
+
+        bool Pop(int& cell)
+        {
+            const int levels = static_cast<int>(m_head.size());
+            while (m_level < levels && m_head[static_cast<size_t>(m_level)] < 0)
+                ++m_level;
+            if (m_level == levels)
+                return false;
+
+            int& head = m_head[static_cast<size_t>(m_level)];
+            cell = head;
+            head = m_next[static_cast<size_t>(cell)];
+            if (head < 0)
+                m_tail[static_cast<size_t>(m_level)] = -1;
+            return true;
+        }
+
+    private:
+        std::vector<int> m_head;
+        std::vector<int> m_tail;
+        std::vector<int> m_next;
+        int m_level = 0;
+    };
+
+    int Receiver(const uint8_t* dir, int w, int x, int y)
+    {
+        const uint8_t d = dir[static_cast<size_t>(y) * w + x];
+        if (d == world::FlowNone)
+            return -1;
+        return (y + world::FlowDY[d]) * w + (x + world::FlowDX[d]);
+    }
+
+    struct Tile
+    {
+        int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        int Width() const { return x1 - x0; }
+        int Area() const { return (x1 - x0) * (y1 - y0); }
+        bool Contains(int x, int y) const { return x >= x0 && x < x1 && y >= y0 && y < y1; }
+    };
+
+    constexpr int RECEIVER_NONE = -1;
+    constexpr int RECEIVER_OUTSIDE = -2;
+
+    // One tile's part of the drainage forest, in tile-local indices
+    struct TileScratch
+    {
+        std::vector<int> receiver;     // local index, RECEIVER_NONE or RECEIVER_OUTSIDE
+        std::vector<uint8_t> donors;
+        std::vector<int> order;        // upstream cells first
+        std::vector<float> flow;
+    };
+
+    void LinkTile(const uint8_t* dir, int w, const Tile& t, TileScratch& s)
+    {
+        const int tw = t.Width();
+        s.receiver.resize(static_cast<size_t>(t.Area()));
+        s.donors.assign(static_cast<size_t>(t.Area()), 0);
+
+        for (int y = t.y0; y < t.y1; ++y)
+        {
+            for (int x = t.x0; x < t.x1; ++x)
+            {
+                const int l = (y - t.y0) * tw + (x - t.x0);
+                const uint8_t d = dir[static_cast<size_t>(y) * w + x];
+
+                if (d == world::FlowNone)
+                {
+                    s.receiver[static_cast<size_t>(l)] = RECEIVER_NONE;
+                }
+                else if (!t.Contains(x + world::FlowDX[d], y + world::FlowDY[d]))
+                {
+                    s.receiver[static_cast<size_t>(l)] = RECEIVER_OUTSIDE;
+                }
+                else
+                {
+                    const int r = l + world::FlowDY[d] * tw + world::FlowDX[d];
+                    s.receiver[static_cast<size_t>(l)] = r;
+                    ++s.donors[static_cast<size_t>(r)];
+                }
+            }
+        }
+    }
+
+    // Adds every cell's flow to its receiver inside the tile in Kahn's order.
+    // s.flow holds each cell's own contribution on entry.
+    void AccumulateTile(TileScratch& s)
+    {
+        const int area = static_cast<int>(s.receiver.size());
+
+        s.order.clear();
+        for (int l = 0; l < area; ++l)
+        {
+            if (s.donors[static_cast<size_t>(l)] == 0)
+                s.order.push_back(l);
+        }
+
+        for (size_t k = 0; k < s.order.size(); ++k)
+        {
+            const int l = s.order[k];
+            const int r = s.receiver[static_cast<size_t>(l)];
+            if (r < 0)
+                continue;
+
+            s.flow[static_cast<size_t>(r)] += s.flow[static_cast<size_t>(l)];
+            if (--s.donors[static_cast<size_t>(r)] == 0)
+                s.order.push_back(r);
+        }
+    }
+
+    // Whole-map accumulation in Kahn's order, for a pool of one thread where
+    // tiling has nothing to gain
+    void AccumulateSerial(const uint8_t* dir, int w, int h, float* flow)
+    {
+        const size_t n = static_cast<size_t>(w) * h;
+        std::vector<int> receiver(n);
+        std::vector<uint8_t> donors(n, 0);
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                const size_t i = static_cast<size_t>(y) * w + x;
+                receiver[i] = Receiver(dir, w, x, y);
+                if (receiver[i] >= 0)
+                    ++donors[static_cast<size_t>(receiver[i])];
+            }
+        }
+
+        std::fill(flow, flow + n, 1.0f);
+        std::vector<int> order;
+        order.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (donors[i] == 0)
+                order.push_back(static_cast<int>(i));
+        }
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            const int r = receiver[static_cast<size_t>(order[k])];
+            if (r < 0)
+                continue;
+
+            flow[r] += flow[order[k]];
+            if (--donors[static_cast<size_t>(r)] == 0)
+                order.push_back(r);
+        }
+    }
+
+    // What the serial pass needs from one tile (global cell indices, ascending)
+    struct TileFlow
+    {
+        std::vector<int> exits;        // cells draining into another tile
+        std::vector<float> exitFlow;   // their flow from inside the tile alone
+        std::vector<int> inflows;      // cells fed from another tile
+        std::vector<int> inflowExit;   // per inflow: the exit its water leaves by, -1 if it stays
+        std::vector<float> inflowAmount;
+
+        // Pass 1's Kahn order, kept for pass 3: (donor << 16 | receiver) in
+        // tile-local indices, for every cell draining inside the tile
+        std::vector<uint32_t> steps;
+    };
+
+    bool FedFromOutside(const uint8_t* dir, int w, int h, const Tile& t, int x, int y)
+    {
+        for (int k = 0; k < 8; ++k)
+        {
+            const int nx = x + world::FlowDX[k];
+            const int ny = y + world::FlowDY[k];
+            if (nx < 0 || ny < 0 || nx >= w || ny >= h || t.Contains(nx, ny))
+                continue;
+
+            // The neighbour drains into (x, y) if its direction is the reverse of k
+            if (dir[static_cast<size_t>(ny) * w + nx] == ((k + 4) & 7))
+                return true;
+        }
+        return false;
+    }
+
+    int IndexIn(const std::vector<int>& sorted, int cell)
+    {
+        return static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), cell) - sorted.begin());
+    }
+}
+
+namespace world
+{
+    void FillDepressions(const float* height, int w, int h, float seaLevel, int levels, float* filled,
+        uint8_t* floodDir)
+    {
+        const size_t n = static_cast<size_t>(w) * h;
+        if (n == 0)
+            return;
+
+        levels = std::max(levels, 1);
+        const auto [mnIt, mxIt] = std::minmax_element(height, height + n);
+        const float mn = *mnIt;
+        const float toLevel = (*mxIt > mn) ? static_cast<float>(levels - 1) / (*mxIt - mn) : 0.0f;
+        const auto level = [&](float v) { return std::min(static_cast<int>((v - mn) * toLevel), levels - 1); };
+
+        // The flood runs on a copy with a one-cell frame of cells that count as
+        // reached: neighbours are fixed index offsets with no bounds checks,
+        // and a cell's height and fill sit side by side.
+        const int pw = w + 2;
+        const size_t pn = static_cast<size_t>(pw) * (h + 2);
+        const int offset[8] = { 1, pw + 1, pw, pw - 1, -1, -pw - 1, -pw, -pw + 1 };
+
+        struct Cell
+        {
+            float height;
+            float filled;
+        };
+        std::vector<Cell> grid(pn, Cell{ 0.0f, 0.0f });
+        std::vector<uint8_t> from(pn, FlowNone); // FlowNone + 1 = not reached yet
+        BucketQueue queue(levels, pn);
+
+        for (int y = 0; y < h + 2; ++y)
+        {
+            for (int x = 0; x < pw; ++x)
+            {
+                const size_t p = static_cast<size_t>(y) * pw + x;
+                if (x == 0 || y == 0 || x == pw - 1 || y == h + 1)
+                    continue; // frame: counts as reached, never pushed
+
+                const float z = height[static_cast<size_t>(y - 1) * w + (x - 1)];
+                grid[p].height = z;
+
+                const bool border = x == 1 || y == 1 || x == w || y == h;
+                if (border || z < seaLevel)
+                    grid[p].filled = z;
+                else
+                    from[p] = FlowNone + 1;
+            }
+        }
+
+        // Only seeds next to an unreached cell start the flood; open sea is
+        // most of a map and never needs to pass through the queue
+        for (int y = 1; y <= h; ++y)
+        {
+            for (int x = 1; x <= w; ++x)
+            {
+                const int p = y * pw + x;
+                if (from[static_cast<size_t>(p)] != FlowNone)
+                    continue;
+
+                bool coast = false;
+                for (int k = 0; k < 8; ++k)
+                    coast = coast || from[static_cast<size_t>(p + offset[k])] == FlowNone + 1;
+
+                if (coast)
+                    queue.Push(level(grid[static_cast<size_t>(p)].height), p);
+            }
+        }
+
+        int c = 0;
+        while (queue.Pop(c))
+        {
+            const float spill = grid[static_cast<size_t>(c)].filled;
+
+            for (int k = 0; k < 8; ++k)
+            {
+                const size_t p = static_cast<size_t>(c + offset[k]);
+                if (from[p] != FlowNone + 1)
+                    continue;
+
+                from[p] = static_cast<uint8_t>((k + 4) & 7);
+                const float z = std::max(grid[p].height, spill);
+                grid[p].filled = z;
+                queue.Push(level(z), static_cast<int>(p));
+            }
+        }
+
+        for (int y = 0; y < h; ++y)
+        {
+            const size_t row = static_cast<size_t>(y + 1) * pw + 1;
+            for (int x = 0; x < w; ++x)
+            {
+                filled[static_cast<size_t>(y) * w + x] = grid[row + x].filled;
+                if (floodDir)
+                    floodDir[static_cast<size_t>(y) * w + x] = from[row + x];
+            }
+        }
+    }
+
+    void FlowDirections(const float* filled, const uint8_t* floodDir, int w, int h, float seaLevel, uint8_t* dir,
+        ThreadPool& pool)
+    {
+        const int tasks = (h + DIR_ROWS_PER_TASK - 1) / DIR_ROWS_PER_TASK;
+        pool.ParallelFor(tasks, [&](int task)
+        {
+            const int y0 = task * DIR_ROWS_PER_TASK;
+            const int y1 = std::min(h, y0 + DIR_ROWS_PER_TASK);
+
+            for (int y = y0; y < y1; ++y)
+            {
+                for (int x = 0; x < w; ++x)
+                {
+                    const size_t i = static_cast<size_t>(y) * w + x;
+                    const float z = filled[i];
+                    if (z < seaLevel)
+                    {
+                        dir[i] = FlowNone;
+                        continue;
+                    }
+
+                    uint8_t best = FlowNone;
+                    float bestDrop = 0.0f;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        const int nx = x + FlowDX[k];
+                        const int ny = y + FlowDY[k];
+                        if (nx < 0 || ny < 0 || nx >= w || ny >= h)
+                            continue;
+
+                        const float drop = (z - filled[static_cast<size_t>(ny) * w + nx]) * INV_DIST[k];
+                        if (drop > bestDrop)
+                        {
+                            bestDrop = drop;
+                            best = static_cast<uint8_t>(k);
+                        }
+                    }
+
+                    dir[i] = (best != FlowNone || !floodDir) ? best : floodDir[i];
+                }
+            }
+        });
+    }
+
+    void FlowAccumulation(const uint8_t* dir, int w, int h, float* flow, ThreadPool& pool)
+    {
+        if (pool.ThreadCount() <= 1)
+        {
+            AccumulateSerial(dir, w, h, flow);
+            return;
+        }
+
+        const int tilesX = (w + FLOW_TILE - 1) / FLOW_TILE;
+        const int tilesY = (h + FLOW_TILE - 1) / FLOW_TILE;
+        const int tileCount = tilesX * tilesY;
+
+        std::vector<Tile> tiles(static_cast<size_t>(tileCount));
+        for (int t = 0; t < tileCount; ++t)
+        {
+            Tile& tile = tiles[static_cast<size_t>(t)];
+            tile.x0 = (t % tilesX) * FLOW_TILE;
+            tile.y0 = (t / tilesX) * FLOW_TILE;
+            tile.x1 = std::min(w, tile.x0 + FLOW_TILE);
+            tile.y1 = std::min(h, tile.y0 + FLOW_TILE);
+        }
+
+        const auto tileOf = [&](int cell) { return (cell / w / FLOW_TILE) * tilesX + (cell % w / FLOW_TILE); };
+
+        // Pass 1: each tile on its own, noting where water enters and leaves it
+        std::vector<TileFlow> tileFlow(static_cast<size_t>(tileCount));
+        pool.ParallelFor(tileCount, [&](int ti)
+        {
+            const Tile& t = tiles[static_cast<size_t>(ti)];
+            TileFlow& tf = tileFlow[static_cast<size_t>(ti)];
+            const int tw = t.Width();
+
+            TileScratch s;
+            LinkTile(dir, w, t, s);
+            s.flow.assign(static_cast<size_t>(t.Area()), 1.0f);
+            AccumulateTile(s);
+
+            tf.steps.reserve(s.order.size());
+            for (const int l : s.order)
+            {
+                const int r = s.receiver[static_cast<size_t>(l)];
+                if (r >= 0)
+                    tf.steps.push_back(static_cast<uint32_t>(l) << 16 | static_cast<uint32_t>(r));
+            }
+
+            // Downstream first: the exit each cell's water leaves the tile by
+            std::vector<int> exitOf(static_cast<size_t>(t.Area()), -1);
+            for (size_t k = s.order.size(); k-- > 0;)
+            {
+                const int l = s.order[k];
+                const int r = s.receiver[static_cast<size_t>(l)];
+                exitOf[static_cast<size_t>(l)] = (r == RECEIVER_OUTSIDE) ? l : (r >= 0) ? exitOf[static_cast<size_t>(r)] : -1;
+            }
+
+            const auto global = [&](int l) { return (t.y0 + l / tw) * w + t.x0 + l % tw; };
+
+            for (int y = t.y0; y < t.y1; ++y)
+            {
+                for (int x = t.x0; x < t.x1; ++x)
+                {
+                    const int l = (y - t.y0) * tw + (x - t.x0);
+                    if (s.receiver[static_cast<size_t>(l)] == RECEIVER_OUTSIDE)
+                    {
+                        tf.exits.push_back(y * w + x);
+                        tf.exitFlow.push_back(s.flow[static_cast<size_t>(l)]);
+                    }
+
+                    const bool edge = x == t.x0 || y == t.y0 || x == t.x1 - 1 || y == t.y1 - 1;
+                    if (edge && FedFromOutside(dir, w, h, t, x, y))
+                    {
+                        const int e = exitOf[static_cast<size_t>(l)];
+                        tf.inflows.push_back(y * w + x);
+                        tf.inflowExit.push_back(e < 0 ? -1 : global(e));
+                    }
+                }
+            }
+            tf.inflowAmount.assign(tf.inflows.size(), 0.0f);
+        });
+
+        // Pass 2 (serial): exits form a forest (each one's water reaches at
+        // most one further exit), accumulated in Kahn's order
+        std::vector<int> firstExit(static_cast<size_t>(tileCount) + 1, 0);
+        for (int t = 0; t < tileCount; ++t)
+            firstExit[static_cast<size_t>(t) + 1] = firstExit[static_cast<size_t>(t)]
+                + static_cast<int>(tileFlow[static_cast<size_t>(t)].exits.size());
+
+        const int exitCount = firstExit.back();
+        std::vector<int> exitCell(static_cast<size_t>(exitCount));
+        std::vector<int> next(static_cast<size_t>(exitCount), -1);
+        std::vector<float> carried(static_cast<size_t>(exitCount));
+        std::vector<int> feeders(static_cast<size_t>(exitCount), 0);
+
+        for (int t = 0; t < tileCount; ++t)
+        {
+            const TileFlow& tf = tileFlow[static_cast<size_t>(t)];
+            for (size_t k = 0; k < tf.exits.size(); ++k)
+            {
+                const int i = firstExit[static_cast<size_t>(t)] + static_cast<int>(k);
+                const int c = tf.exits[k];
+                exitCell[static_cast<size_t>(i)] = c;
+                carried[static_cast<size_t>(i)] = tf.exitFlow[k];
+
+                const int r = Receiver(dir, w, c % w, c / w);
+                const int rt = tileOf(r);
+                const TileFlow& down = tileFlow[static_cast<size_t>(rt)];
+                const int e = down.inflowExit[static_cast<size_t>(IndexIn(down.inflows, r))];
+                if (e >= 0)
+                {
+                    const int et = tileOf(e);
+                    next[static_cast<size_t>(i)] = firstExit[static_cast<size_t>(et)]
+                        + IndexIn(tileFlow[static_cast<size_t>(et)].exits, e);
+                    ++feeders[static_cast<size_t>(next[static_cast<size_t>(i)])];
+                }
+            }
+        }
+
+        std::vector<int> order;
+        order.reserve(static_cast<size_t>(exitCount));
+        for (int i = 0; i < exitCount; ++i)
+        {
+            if (feeders[static_cast<size_t>(i)] == 0)
+                order.push_back(i);
+        }
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            const int i = order[k];
+            const int j = next[static_cast<size_t>(i)];
+            if (j < 0)
+                continue;
+
+            carried[static_cast<size_t>(j)] += carried[static_cast<size_t>(i)];
+            if (--feeders[static_cast<size_t>(j)] == 0)
+                order.push_back(j);
+        }
+
+        for (int i = 0; i < exitCount; ++i)
+        {
+            const int c = exitCell[static_cast<size_t>(i)];
+            const int r = Receiver(dir, w, c % w, c / w);
+            TileFlow& down = tileFlow[static_cast<size_t>(tileOf(r))];
+            down.inflowAmount[static_cast<size_t>(IndexIn(down.inflows, r))] += carried[static_cast<size_t>(i)];
+        }
+
+        // Pass 3: every tile again, replaying pass 1's order with its inflow
+        // added where it enters
+        pool.ParallelFor(tileCount, [&](int ti)
+        {
+            const Tile& t = tiles[static_cast<size_t>(ti)];
+            TileFlow& tf = tileFlow[static_cast<size_t>(ti)];
+            const int tw = t.Width();
+
+            std::vector<float> local(static_cast<size_t>(t.Area()), 1.0f);
+            for (size_t k = 0; k < tf.inflows.size(); ++k)
+            {
+                const int c = tf.inflows[k];
+                local[static_cast<size_t>((c / w - t.y0) * tw + (c % w - t.x0))] += tf.inflowAmount[k];
+            }
+            for (const uint32_t step : tf.steps)
+                local[step & 0xFFFFu] += local[step >> 16];
+            tf.steps = {};
+
+            for (int y = t.y0; y < t.y1; ++y)
+            {
+                std::copy_n(local.data() + static_cast<size_t>(y - t.y0) * tw, tw,
+                    flow + static_cast<size_t>(y) * w + t.x0);
+            }
+        });
+    }
+
+    Hydrology ComputeHydrology(const float* height, int w, int h, float seaLevel, ThreadPool& pool)
+    {
+        const size_t n = static_cast<size_t>(w) * h;
+
+        Hydrology out;
+        out.filled.resize(n);
+        out.dir.resize(n);
+        out.flow.resize(n);
+
+        std::vector<uint8_t> floodDir(n);
+        FillDepressions(height, w, h, seaLevel, FLOOD_LEVELS, out.filled.data(), floodDir.data());
+        FlowDirections(out.filled.data(), floodDir.data(), w, h, seaLevel, out.dir.data(), pool);
+        FlowAccumulation(out.dir.data(), w, h, out.flow.data(), pool);
+        return out;
+    }
+}
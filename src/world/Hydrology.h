@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // D8 flow directions: 0..7 clockwise from east, FlowNone for cells that
+    // drain off the map or into the sea
+    constexpr uint8_t FlowNone = 8;
+    constexpr int FlowDX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    constexpr int FlowDY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+    // Priority-flood depression filling (Barnes et al.). Seeds are the map
+    // border and every cell below seaLevel; cells are then flooded inward in
+    // order of height, each raised to at least the cell that reached it, so
+    // every cell of `filled` has a non-ascending path to a seed.
+    //
+    // The queue is a monotone bucket queue over `levels` quantized heights
+    // (FIFO within a bucket), which makes the fill O(n + levels). Ordering
+    // inside a bucket is approximate, so a cell can end up filled by at most
+    // one quantum ((max - min) / levels) more than an exact fill would.
+    //
+    // floodDir (optional) receives, for every non-seed cell, the D8
+    // direction to the cell that flooded it: a drainage route across the
+    // flats the fill creates.
+    void FillDepressions(const float* height, int w, int h, float seaLevel, int levels, float* filled,
+        uint8_t* floodDir);
+
+    // Steepest-descent D8 directions on a filled surface. Cells without a
+    // lower neighbour (filled flats) follow floodDir instead, so every land
+    // cell drains to a seed without cycles; sea cells get FlowNone.
+    void FlowDirections(const float* filled, const uint8_t* floodDir, int w, int h, float seaLevel, uint8_t* dir,
+        ThreadPool& pool);
+
+    // Upstream catchment of every cell, in cells (itself included). Exact in
+    // float for maps under 2^24 cells.
+    //
+    // Runs in three passes: tiles accumulate their own cells in parallel and
+    // keep their Kahn order; a short serial pass carries flow between tiles
+    // through the cells where water leaves a tile; tiles then replay their
+    // order, in parallel, with that inflow added. A pool of one thread runs
+    // a single whole-map pass instead. The result is identical for any
+    // thread count.
+    void FlowAccumulation(const uint8_t* dir, int w, int h, float* flow, ThreadPool& pool);
+
+    // All three stages over a height field
+    struct Hydrology
+    {
+        std::vector<float> filled;
+        std::vector<uint8_t> dir;
+        std::vector<float> flow;
+    };
+
+    Hydrology ComputeHydrology(const float* height, int w, int h, float seaLevel, ThreadPool& pool);
+}
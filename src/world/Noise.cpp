@@ -1,37 +1,24 @@
 // Noise.cpp
 #include "world/Noise.h"
+#include "world/NoiseKernels.h"
+#include "core/Config.h"
+#include "core/ThreadPool.h"
 
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
+#include <utility>
+#include <vector>
 
 namespace
 {
-    // ---------------------------------------------------------------------
-    // Core Perlin helpers
-    // ---------------------------------------------------------------------
-
-    float Fade(float t)
-    {
-        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
-    }
-
-    float Lerp(float a, float b, float t)
-    {
-        return a + t * (b - a);
-    }
-
-    float Grad(int hash, float x, float y)
-    {
-        const int h = hash & 3;
-        const float u = (h < 2) ? x : y;
-        const float v = (h < 2) ? y : x;
-        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
-    }
+    using world::detail::PermTable;
 
-    std::array<int, 512> BuildPerm(uint32_t seed)
+    PermTable BuildPerm(uint32_t seed)
     {
         std::array<int, 256> p{};
         std::iota(p.begin(), p.end(), 0);
@@ -39,42 +26,71 @@ namespace
         std::mt19937 rng(seed);
         std::shuffle(p.begin(), p.end(), rng);
 
-        std::array<int, 512> perm{};
+        PermTable perm{};
         for (int i = 0; i < 512; ++i)
             perm[i] = p[i & 255];
 
         return perm;
     }
 
-    float Perlin2D(float x, float y, const std::array<int, 512>& perm)
+    // Seeding mt19937 and shuffling costs more than a whole 64x64 chunk of
+    // fBm, and chunked/tiled generation asks for the same seed over and over.
+    // The most recently used tables are kept, most recent first; a caller
+    // holds its table by shared_ptr, so eviction never pulls it away mid-use.
+    constexpr size_t PERM_CACHE_SEEDS = 64;
+
+    std::shared_ptr<const PermTable> CachedPerm(uint32_t seed)
     {
-        const int xi = static_cast<int>(std::floor(x)) & 255;
-        const int yi = static_cast<int>(std::floor(y)) & 255;
+        static std::mutex mutex;
+        static std::vector<std::pair<uint32_t, std::shared_ptr<const PermTable>>> recent;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < recent.size(); ++i)
+            {
+                if (recent[i].first == seed)
+                {
+                    std::rotate(recent.begin(), recent.begin() + i, recent.begin() + i + 1);
+                    return recent.front().second;
+                }
+            }
+        }
 
-        const float xf = x - std::floor(x);
-        const float yf = y - std::floor(y);
+        auto table = std::make_shared<const PermTable>(BuildPerm(seed));
 
-        const float u = Fade(xf);
-        const float v = Fade(yf);
+        std::lock_guard<std::mutex> lock(mutex);
+        recent.insert(recent.begin(), { seed, table });
+        if (recent.size() > PERM_CACHE_SEEDS)
+            recent.pop_back();
 
-        const int aa = perm[perm[xi] + yi];
-        const int ab = perm[perm[xi] + yi + 1];
-        const int ba = perm[perm[xi + 1] + yi];
-        const int bb = perm[perm[xi + 1] + yi + 1];
+        return table;
+    }
 
-        const float x1 = Lerp(
-            Grad(aa, xf, yf),
-            Grad(ba, xf - 1.0f, yf),
-            u
-        );
+    world::detail::FbmSetup MakeSetup(const world::NoiseParams& p, const PermTable& perm)
+    {
+        world::detail::FbmSetup setup;
+        setup.perm = perm.data();
+        setup.baseScale = (p.scale <= 0.0001f) ? 0.0001f : p.scale;
+        setup.offsetX = p.offsetX;
+        setup.offsetY = p.offsetY;
+        setup.octaves = p.octaves;
+        setup.persistence = p.persistence;
+        setup.lacunarity = p.lacunarity;
+        world::detail::PrepareOctaves(setup);
+        return setup;
+    }
+}
 
-        const float x2 = Lerp(
-            Grad(ab, xf, yf - 1.0f),
-            Grad(bb, xf - 1.0f, yf - 1.0f),
-            u
-        );
+namespace world::detail
+{
+    std::shared_ptr<const PermTable> SeedPermutation(uint32_t seed)
+    {
+        return CachedPerm(seed);
+    }
 
-        return Lerp(x1, x2, v);
+    FbmSetup MakeFbmSetup(const NoiseParams& p, const PermTable& perm)
+    {
+        return MakeSetup(p, perm);
     }
 }
 
@@ -87,39 +103,117 @@ namespace world
     std::vector<float> PerlinFbm2D(int w, int h, const NoiseParams& p)
     {
         std::vector<float> out(static_cast<size_t>(w) * static_cast<size_t>(h), 0.0f);
-        const auto perm = BuildPerm(p.seed);
+        PerlinFbm2DRegion(out.data(), w, 0, 0, w, h, p);
+        return out;
+    }
 
-        const float baseScale = (p.scale <= 0.0001f) ? 0.0001f : p.scale;
+    std::vector<float> PerlinFbm2D(int w, int h, const NoiseParams& p, ThreadPool& pool)
+    {
+        std::vector<float> out(static_cast<size_t>(w) * static_cast<size_t>(h), 0.0f);
+        PerlinFbm2DRegion(out.data(), w, 0, 0, w, h, p, pool);
+        return out;
+    }
+
+    void PerlinFbm2DRegion(float* dst, int stride, int x0, int y0, int w, int h, const NoiseParams& p)
+    {
+        const auto perm = CachedPerm(p.seed);
+        const detail::FbmSetup setup = MakeSetup(p, *perm);
+
+        // SIMD row kernel picked once by CPUID (scalar fallback)
+        const detail::FbmKernel& kernel = detail::ActiveFbmKernel();
 
         for (int y = 0; y < h; ++y)
+            kernel.row(setup, x0, y0 + y, w, dst + static_cast<size_t>(y) * stride);
+    }
+
+    void PerlinFbm2DRegion(float* dst, int stride, int x0, int y0, int w, int h, const NoiseParams& p,
+        ThreadPool& pool)
+    {
+        const auto perm = CachedPerm(p.seed);
+        const detail::FbmSetup setup = MakeSetup(p, *perm);
+        const detail::FbmKernel& kernel = detail::ActiveFbmKernel();
+
+        // Every sample depends only on its own coordinates, so tiles can run in
+        // any order on any thread and still produce the same bits.
+        const int tile = cfg::NoiseTilePx;
+        const int tilesX = (w + tile - 1) / tile;
+        const int tilesY = (h + tile - 1) / tile;
+
+        pool.ParallelFor(tilesX * tilesY, [&](int t)
         {
-            for (int x = 0; x < w; ++x)
-            {
-                float amp = 1.0f;
-                float freq = 1.0f;
-                float sum = 0.0f;
-                float ampSum = 0.0f;
+            const int tx = (t % tilesX) * tile;
+            const int ty = (t / tilesX) * tile;
+            const int tw = std::min(tile, w - tx);
+            const int th = std::min(tile, h - ty);
+
+            for (int y = ty; y < ty + th; ++y)
+                kernel.row(setup, x0 + tx, y0 + y, tw, dst + static_cast<size_t>(y) * stride + tx);
+        });
+    }
 
-                for (int o = 0; o < p.octaves; ++o)
-                {
-                    const float nx = ((static_cast<float>(x) + p.offsetX) / baseScale) * freq;
-                    const float ny = ((static_cast<float>(y) + p.offsetY) / baseScale) * freq;
+    void PerlinFbm2DMulti(float* const* dst, const NoiseParams* params, int count, int w, int h, ThreadPool& pool)
+    {
+        if (count <= 0)
+            return;
 
-                    sum += Perlin2D(nx, ny, perm) * amp;
-                    ampSum += amp;
+        // Held for the whole pass so the setups' perm pointers stay valid
+        std::vector<std::shared_ptr<const PermTable>> perms;
+        std::vector<detail::FbmSetup> setups;
+        for (int c = 0; c < count; ++c)
+        {
+            perms.push_back(CachedPerm(params[c].seed));
+            setups.push_back(MakeSetup(params[c], *perms.back()));
+        }
 
-                    amp *= p.persistence;
-                    freq *= p.lacunarity;
-                }
+        detail::MultiFbmSetup m;
+        if (!detail::PrepareMultiFbm(setups.data(), count, m))
+        {
+            for (int c = 0; c < count; ++c)
+                PerlinFbm2DRegion(dst[c], w, 0, 0, w, h, params[c], pool);
+            return;
+        }
 
-                if (ampSum > 0.0f)
-                    sum /= ampSum;
+        const detail::FbmKernel& kernel = detail::ActiveFbmKernel();
 
-                out[static_cast<size_t>(y) * w + x] = sum;
+        const int tile = cfg::NoiseTilePx;
+        const int tilesX = (w + tile - 1) / tile;
+        const int tilesY = (h + tile - 1) / tile;
+
+        pool.ParallelFor(tilesX * tilesY, [&](int t)
+        {
+            const int tx = (t % tilesX) * tile;
+            const int ty = (t / tilesX) * tile;
+            const int tw = std::min(tile, w - tx);
+            const int th = std::min(tile, h - ty);
+
+            float* rowOut[detail::MaxMultiChannels];
+            for (int y = ty; y < ty + th; ++y)
+            {
+                for (int c = 0; c < count; ++c)
+                    rowOut[c] = dst[c] + static_cast<size_t>(y) * w + tx;
+
+                kernel.multiRow(m, tx, y, tw, rowOut);
             }
+        });
+    }
+
+    int NyquistOctaves(const NoiseParams& p, float spacing)
+    {
+        const float baseScale = (p.scale <= 0.0001f) ? 0.0001f : p.scale;
+
+        // Octave o runs at lacunarity^o lattice cycles per baseScale pixels
+        int keep = 0;
+        float freq = 1.0f;
+        for (int o = 0; o < p.octaves; ++o)
+        {
+            if (freq * spacing / baseScale > 0.5f)
+                break;
+
+            ++keep;
+            freq *= p.lacunarity;
         }
 
-        return out;
+        return (p.octaves <= 0) ? p.octaves : std::max(1, keep);
     }
 
     // ---------------------------------------------------------------------
@@ -131,8 +225,11 @@ namespace world
         if (src.empty()) return {};
 
         auto [mnIt, mxIt] = std::minmax_element(src.begin(), src.end());
-        float mn = *mnIt;
-        float mx = *mxIt;
+        return NormalizeToU8(src, *mnIt, *mxIt);
+    }
+
+    std::vector<uint8_t> NormalizeToU8(const std::vector<float>& src, float mn, float mx)
+    {
         if (std::abs(mx - mn) < 1e-8f)
             mx = mn + 1e-8f;
 
@@ -164,6 +261,31 @@ namespace world
         return rgba;
     }
 
+    void FloatToGrayRGBA(const float* src, int srcStride, int w, int h, float mn, float mx,
+        uint8_t* dst, int dstPitchBytes)
+    {
+        if (std::abs(mx - mn) < 1e-8f)
+            mx = mn + 1e-8f;
+
+        for (int y = 0; y < h; ++y)
+        {
+            const float* in = src + static_cast<size_t>(y) * srcStride;
+            uint8_t* out = dst + static_cast<size_t>(y) * dstPitchBytes;
+
+            for (int x = 0; x < w; ++x)
+            {
+                float t = (in[x] - mn) / (mx - mn);
+                t = std::clamp(t, 0.0f, 1.0f);
+                const uint8_t g = static_cast<uint8_t>(t * 255.0f + 0.5f);
+
+                out[x * 4 + 0] = g;
+                out[x * 4 + 1] = g;
+                out[x * 4 + 2] = g;
+                out[x * 4 + 3] = 255;
+            }
+        }
+    }
+
     // ---------------------------------------------------------------------
     // Terrain-specific normalization (continents)
     // ---------------------------------------------------------------------
@@ -173,29 +295,129 @@ namespace world
         return std::clamp(x, 0.0f, 1.0f);
     }
 
-    static float Percentile(std::vector<float> data, float p01)
+    // The clip percentiles come from a histogram instead of sorting copies of
+    // the field: one pass for the range, one to count, then a walk over the
+    // cumulative counts. Inside a bin the rank is interpolated linearly; with
+    // 64K bins that is far below one output step.
+    static constexpr int TERRAIN_HIST_BINS = 1 << 16;
+
+    // pow(t, gamma) sampled on [0, 1] and interpolated linearly. For gamma >= 0.5
+    // this stays within 1 LSB of std::pow even at the steep end near t = 0;
+    // flatter curves are too steep there, so they call std::pow per pixel.
+    static constexpr int GAMMA_LUT_STEPS = 4096;
+    static constexpr float GAMMA_LUT_MIN = 0.5f;
+
+    // One contiguous range per thread, but no ranges of only a few samples
+    static int PartCount(size_t n, ThreadPool* pool)
+    {
+        return pool ? static_cast<int>(std::min<size_t>(pool->ThreadCount(), std::max<size_t>(1, n / 4096))) : 1;
+    }
+
+    // Calls fn(part, begin, end) for each of PartCount(n, pool) ranges of [0, n)
+    template <class Fn>
+    static void ForEachPart(size_t n, ThreadPool* pool, Fn&& fn)
+    {
+        const int parts = PartCount(n, pool);
+        const auto range = [&](int part)
+        {
+            fn(part, n * part / parts, n * (part + 1) / parts);
+        };
+
+        if (pool && parts > 1)
+            pool->ParallelFor(parts, range);
+        else
+            for (int part = 0; part < parts; ++part)
+                range(part);
+    }
+
+    // Values at the clipLow / clipHigh ranks (same ranks Percentile used to pick)
+    static void HistogramPercentiles(const std::vector<float>& src, float clipLow, float clipHigh,
+        ThreadPool* pool, float& lo, float& hi)
     {
-        if (data.empty()) return 0.0f;
-        p01 = std::clamp(p01, 0.0f, 1.0f);
+        const size_t n = src.size();
+        const int parts = PartCount(n, pool);
+
+        // Pass 1: range
+        std::vector<float> partMin(parts, src[0]), partMax(parts, src[0]);
+        ForEachPart(n, pool, [&](int part, size_t begin, size_t end)
+        {
+            float mn = src[begin];
+            float mx = src[begin];
+            for (size_t i = begin; i < end; ++i)
+            {
+                mn = std::min(mn, src[i]);
+                mx = std::max(mx, src[i]);
+            }
+            partMin[part] = mn;
+            partMax[part] = mx;
+        });
+
+        const float mn = *std::min_element(partMin.begin(), partMin.end());
+        const float mx = *std::max_element(partMax.begin(), partMax.end());
+        if (!(mx > mn))
+        {
+            lo = hi = mn;
+            return;
+        }
+
+        // Pass 2: one histogram per part, merged afterwards
+        const double binWidth = (static_cast<double>(mx) - mn) / TERRAIN_HIST_BINS;
+        const float toBin = static_cast<float>(1.0 / binWidth);
 
-        const size_t n = data.size();
-        const size_t k = static_cast<size_t>(std::round(p01 * float(n - 1)));
+        std::vector<uint32_t> hist(static_cast<size_t>(parts) * TERRAIN_HIST_BINS, 0);
+        ForEachPart(n, pool, [&](int part, size_t begin, size_t end)
+        {
+            uint32_t* h = hist.data() + static_cast<size_t>(part) * TERRAIN_HIST_BINS;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const int bin = static_cast<int>((src[i] - mn) * toBin);
+                ++h[std::clamp(bin, 0, TERRAIN_HIST_BINS - 1)];
+            }
+        });
 
-        std::nth_element(data.begin(), data.begin() + k, data.end());
-        return data[k];
+        for (int part = 1; part < parts; ++part)
+        {
+            const uint32_t* h = hist.data() + static_cast<size_t>(part) * TERRAIN_HIST_BINS;
+            for (int b = 0; b < TERRAIN_HIST_BINS; ++b)
+                hist[b] += h[b];
+        }
+
+        const auto valueAtRank = [&](float p01)
+        {
+            p01 = std::clamp(p01, 0.0f, 1.0f);
+            const size_t k = static_cast<size_t>(std::round(p01 * float(n - 1)));
+
+            size_t below = 0;
+            for (int b = 0; b < TERRAIN_HIST_BINS; ++b)
+            {
+                if (k < below + hist[b])
+                {
+                    const double within = (static_cast<double>(k - below) + 0.5) / hist[b];
+                    return static_cast<float>(mn + (b + within) * binWidth);
+                }
+                below += hist[b];
+            }
+            return mx;
+        };
+
+        lo = valueAtRank(clipLow);
+        hi = valueAtRank(clipHigh);
     }
 
-    std::vector<uint8_t> NormalizeTerrainToU8(
+    static std::vector<uint8_t> NormalizeTerrain(
         const std::vector<float>& src,
         float clipLow,
         float clipHigh,
         float SeaLevel,
-        float gamma)
+        float gamma,
+        ThreadPool* pool)
     {
         if (src.empty()) return {};
 
-        const float lo = Percentile(src, clipLow);
-        const float hi = Percentile(src, clipHigh);
+        float lo = 0.0f;
+        float hi = 0.0f;
+        HistogramPercentiles(src, clipLow, clipHigh, pool, lo, hi);
+
         float denom = hi - lo;
         if (std::abs(denom) < 1e-8f)
             denom = 1e-8f;
@@ -203,24 +425,63 @@ namespace world
         // SeaLevel: 0.50 = neutral
         const float seaBias = SeaLevel - 0.5f;
 
+        const bool curve = gamma > 0.0001f;
+        const bool curveLut = gamma >= GAMMA_LUT_MIN;
+        std::array<float, GAMMA_LUT_STEPS + 1> gammaLut{};
+        if (curveLut)
+        {
+            for (int i = 0; i <= GAMMA_LUT_STEPS; ++i)
+                gammaLut[i] = std::pow(static_cast<float>(i) / GAMMA_LUT_STEPS, gamma);
+        }
+
         std::vector<uint8_t> out(src.size());
 
-        for (size_t i = 0; i < src.size(); ++i)
+        ForEachPart(src.size(), pool, [&](int, size_t begin, size_t end)
         {
-            // 1) Robust normalization
-            float t = (src[i] - lo) / denom;
-            t = Clamp01(t);
+            for (size_t i = begin; i < end; ++i)
+            {
+                // 1) Robust normalization
+                float t = (src[i] - lo) / denom;
+                t = Clamp01(t);
 
-            // 2) Sea level bias (controls land/ocean ratio)
-            t = Clamp01(t - seaBias);
+                // 2) Sea level bias (controls land/ocean ratio)
+                t = Clamp01(t - seaBias);
 
-            // 3) Game curve (gamma)
-            if (gamma > 0.0001f)
-                t = std::pow(t, gamma);
+                // 3) Game curve (gamma)
+                if (curveLut)
+                {
+                    const float x = t * GAMMA_LUT_STEPS;
+                    const int j = std::min(static_cast<int>(x), GAMMA_LUT_STEPS - 1);
+                    t = gammaLut[j] + (x - j) * (gammaLut[j + 1] - gammaLut[j]);
+                }
+                else if (curve)
+                    t = std::pow(t, gamma);
 
-            out[i] = static_cast<uint8_t>(t * 255.0f + 0.5f);
-        }
+                out[i] = static_cast<uint8_t>(t * 255.0f + 0.5f);
+            }
+        });
 
         return out;
     }
+
+    std::vector<uint8_t> NormalizeTerrainToU8(
+        const std::vector<float>& src,
+        float clipLow,
+        float clipHigh,
+        float SeaLevel,
+        float gamma)
+    {
+        return NormalizeTerrain(src, clipLow, clipHigh, SeaLevel, gamma, nullptr);
+    }
+
+    std::vector<uint8_t> NormalizeTerrainToU8(
+        const std::vector<float>& src,
+        ThreadPool& pool,
+        float clipLow,
+        float clipHigh,
+        float SeaLevel,
+        float gamma)
+    {
+        return NormalizeTerrain(src, clipLow, clipHigh, SeaLevel, gamma, &pool);
+    }
 }
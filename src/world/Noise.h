@@ -2,6 +2,8 @@
 #include <cstdint>
 #include <vector>
 
+class ThreadPool;
+
 namespace world
 {
     // Parameters controlling fBm Perlin noise generation
@@ -23,6 +25,31 @@ namespace world
     // Returns floats (roughly in [-1, 1], fBm is normalized by amplitude sum)
     std::vector<float> PerlinFbm2D(int w, int h, const NoiseParams& p);
 
+    // Same field, split into cfg::NoiseTilePx tiles spread across the pool.
+    // Bit-identical to the single-threaded version for any thread count.
+    std::vector<float> PerlinFbm2D(int w, int h, const NoiseParams& p, ThreadPool& pool);
+
+    // Writes the w x h block of the same field whose top-left sample is (x0, y0)
+    // into dst (row pitch `stride` floats). Sample (x, y) of PerlinFbm2D equals
+    // sample (x, y) here, so blocks of one field can be computed piecemeal.
+    void PerlinFbm2DRegion(float* dst, int stride, int x0, int y0, int w, int h, const NoiseParams& p);
+    void PerlinFbm2DRegion(float* dst, int stride, int x0, int y0, int w, int h, const NoiseParams& p,
+        ThreadPool& pool);
+
+    // Evaluates `count` fields (each with its own params and seed) over the
+    // same w x h grid in one pass and writes field c to dst[c] (w * h floats,
+    // row-major), e.g. the elevation, temperature and moisture layers of a world.
+    // Octaves that sample the same lattice (equal offsets and scale / frequency,
+    // across fields too) share their coordinate setup; each field is still
+    // bit-identical to PerlinFbm2D with its params. More than 8 fields or 64
+    // octaves in total fall back to one PerlinFbm2D pass per field.
+    void PerlinFbm2DMulti(float* const* dst, const NoiseParams* params, int count, int w, int h, ThreadPool& pool);
+
+    // Leading octaves worth evaluating when the field is sampled every `spacing`
+    // pixels: octaves above the sampling Nyquist limit (0.5 cycles per sample)
+    // only alias, so level-of-detail callers drop them. Always at least 1.
+    int NyquistOctaves(const NoiseParams& p, float spacing);
+
     // ---------------------------------------------------------------------
     // Generic utilities (non-terrain-specific)
     // ---------------------------------------------------------------------
@@ -30,9 +57,18 @@ namespace world
     // Normalize float field to 0..255 using auto min/max
     std::vector<uint8_t> NormalizeToU8(const std::vector<float>& src);
 
+    // Normalize float field to 0..255 using a fixed [mn, mx] range (values outside are clamped)
+    std::vector<uint8_t> NormalizeToU8(const std::vector<float>& src, float mn, float mx);
+
     // Convert grayscale to RGBA8888 bytes (size = w * h * 4)
     std::vector<uint8_t> GrayToRGBA(const std::vector<uint8_t>& gray);
 
+    // NormalizeToU8(mn, mx) + GrayToRGBA in one pass, without intermediates:
+    // reads a w x h float block (row pitch `srcStride` floats) and writes the
+    // same RGBA bytes to dst (row pitch `dstPitchBytes`), e.g. locked texture memory.
+    void FloatToGrayRGBA(const float* src, int srcStride, int w, int h, float mn, float mx,
+        uint8_t* dst, int dstPitchBytes);
+
     // ---------------------------------------------------------------------
     // Terrain-specific post-processing
     // ---------------------------------------------------------------------
@@ -41,10 +77,24 @@ namespace world
     //  - clipLow / clipHigh: percentile clamps (0..1), e.g. 0.02 / 0.98 | Ignore extreme outliers in the noise distribution. Prevent “everything turns white” or “everything turns black”
     //  - SeaLevel: 0..1 (0.50 = neutral, higher => more ocean)
     //  - gamma: game curve (>1 darkens midtones, sharper coastlines)
+    // Percentiles are read off a 64K-bin histogram and, for gamma >= 0.5, the
+    // curve off a lookup table, so results can differ from exact sorting +
+    // std::pow by 1 LSB. Gamma below 0.5 calls std::pow per pixel (about twice
+    // the cost); its near-vertical start still magnifies the histogram's tiny
+    // percentile error, so pixels just above the low clip can be a few LSB off.
     std::vector<uint8_t> NormalizeTerrainToU8(
         const std::vector<float>& src,
         float clipLow = 0.02f,
         float clipHigh = 0.98f,
         float SeaLevel = 0.55f, // Biases the heightmap before gamma | 0.50 → neutral | > 0.50 → more ocean | < 0.50 → more land
         float gamma = 1.45f);
+
+    // Same, with the histogram and mapping passes split across the pool
+    std::vector<uint8_t> NormalizeTerrainToU8(
+        const std::vector<float>& src,
+        ThreadPool& pool,
+        float clipLow = 0.02f,
+        float clipHigh = 0.98f,
+        float SeaLevel = 0.55f,
+        float gamma = 1.45f);
 }
@@ -0,0 +1,218 @@
+#include "world/NoiseCache.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr int CHUNK = cfg::NoiseChunkPx;
+    constexpr size_t CHUNK_BYTES = sizeof(float) * CHUNK * CHUNK;
+
+    int FloorDiv(int a, int b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    uint64_t Fnv1a(uint64_t h, const void* data, size_t n)
+    {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < n; ++i)
+        {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Everything that shapes the field except the seed (a key field of its own)
+    uint64_t HashParams(const world::NoiseParams& p)
+    {
+        uint64_t h = 1469598103934665603ull;
+        h = Fnv1a(h, &p.scale, sizeof(p.scale));
+        h = Fnv1a(h, &p.octaves, sizeof(p.octaves));
+        h = Fnv1a(h, &p.persistence, sizeof(p.persistence));
+        h = Fnv1a(h, &p.lacunarity, sizeof(p.lacunarity));
+        h = Fnv1a(h, &p.offsetX, sizeof(p.offsetX));
+        h = Fnv1a(h, &p.offsetY, sizeof(p.offsetY));
+        return h;
+    }
+
+    // Parameters whose pixel grid is the LOD grid. Scaling by a power of two is
+    // exact in float, so LOD sample (i, j) reproduces field pixel (i << L, j << L).
+    world::NoiseParams LodParams(const world::NoiseParams& p, int lod)
+    {
+        world::NoiseParams q = p;
+        const float s = std::ldexp(1.0f, -lod);
+        q.scale *= s;
+        q.offsetX *= s;
+        q.offsetY *= s;
+        return q;
+    }
+}
+
+namespace world
+{
+    size_t NoiseChunkCache::KeyHash::operator()(const Key& k) const
+    {
+        uint64_t h = k.paramsHash;
+        h = Fnv1a(h, &k.seed, sizeof(k.seed));
+        h = Fnv1a(h, &k.cx, sizeof(k.cx));
+        h = Fnv1a(h, &k.cy, sizeof(k.cy));
+        h = Fnv1a(h, &k.lod, sizeof(k.lod));
+        return static_cast<size_t>(h);
+    }
+
+    NoiseChunkCache::NoiseChunkCache(size_t budgetBytes)
+        : m_budget(budgetBytes)
+    {
+    }
+
+    void NoiseChunkCache::SetBudget(size_t bytes)
+    {
+        m_budget = bytes;
+        EvictToBudget();
+    }
+
+    void NoiseChunkCache::Clear()
+    {
+        m_lru.clear();
+        m_index.clear();
+        m_stats.chunks = 0;
+        m_stats.bytes = 0;
+    }
+
+    bool NoiseChunkCache::Read(float* dst, int stride, int x0, int y0, int w, int h,
+        const NoiseParams& p, int lod, ThreadPool& pool, const std::function<bool()>& cancelled)
+    {
+        if (w <= 0 || h <= 0)
+            return true;
+
+        const uint64_t paramsHash = HashParams(p);
+
+        const int cx0 = FloorDiv(x0, CHUNK);
+        const int cy0 = FloorDiv(y0, CHUNK);
+        const int cols = FloorDiv(x0 + w - 1, CHUNK) - cx0 + 1;
+        const int rows = FloorDiv(y0 + h - 1, CHUNK) - cy0 + 1;
+
+        // Resolve every chunk the rect touches: hits move to the LRU front,
+        // misses are collected and computed together below.
+        std::vector<const float*> sources(static_cast<size_t>(cols) * rows, nullptr);
+        std::vector<Chunk> fresh;
+        std::vector<size_t> freshSlot;
+
+        for (int j = 0; j < rows; ++j)
+        {
+            for (int i = 0; i < cols; ++i)
+            {
+                const Key key{ p.seed, paramsHash, cx0 + i, cy0 + j, lod };
+                const size_t slot = static_cast<size_t>(j) * cols + i;
+
+                auto it = m_index.find(key);
+                if (it != m_index.end())
+                {
+                    m_lru.splice(m_lru.begin(), m_lru, it->second);
+                    sources[slot] = it->second->samples.data();
+                    ++m_stats.hits;
+                }
+                else
+                {
+                    fresh.push_back(Chunk{ key, {} });
+                    freshSlot.push_back(slot);
+                    ++m_stats.misses;
+                }
+            }
+        }
+
+        if (!fresh.empty())
+        {
+            const NoiseParams lodParams = LodParams(p, lod);
+
+            std::atomic<bool> stop{ false };
+
+            pool.ParallelFor(static_cast<int>(fresh.size()), [&](int i)
+            {
+                if (stop.load(std::memory_order_relaxed))
+                    return;
+                if (cancelled && cancelled())
+                {
+                    stop.store(true, std::memory_order_relaxed);
+                    return;
+                }
+
+                Chunk& c = fresh[i];
+                c.samples.resize(static_cast<size_t>(CHUNK) * CHUNK);
+                PerlinFbm2DRegion(c.samples.data(), CHUNK, c.key.cx * CHUNK, c.key.cy * CHUNK, CHUNK, CHUNK, lodParams);
+            });
+
+            if (stop.load(std::memory_order_relaxed))
+            {
+                // Keep the finished chunks: a restarted request will want them
+                for (Chunk& c : fresh)
+                {
+                    if (!c.samples.empty())
+                        Insert(std::move(c));
+                }
+
+                EvictToBudget();
+                return false;
+            }
+
+            for (size_t i = 0; i < fresh.size(); ++i)
+                sources[freshSlot[i]] = fresh[i].samples.data();
+        }
+
+        // Copy the requested rect out of the chunks
+        for (int j = 0; j < rows; ++j)
+        {
+            const int chunkY = (cy0 + j) * CHUNK;
+            const int ya = std::max(y0, chunkY);
+            const int yb = std::min(y0 + h, chunkY + CHUNK);
+
+            for (int i = 0; i < cols; ++i)
+            {
+                const int chunkX = (cx0 + i) * CHUNK;
+                const int xa = std::max(x0, chunkX);
+                const int xb = std::min(x0 + w, chunkX + CHUNK);
+                const float* src = sources[static_cast<size_t>(j) * cols + i];
+
+                for (int y = ya; y < yb; ++y)
+                {
+                    std::memcpy(
+                        dst + static_cast<size_t>(y - y0) * stride + (xa - x0),
+                        src + static_cast<size_t>(y - chunkY) * CHUNK + (xa - chunkX),
+                        sizeof(float) * static_cast<size_t>(xb - xa));
+                }
+            }
+        }
+
+        // Only now insert and evict: nothing read above may disappear mid-copy
+        for (Chunk& c : fresh)
+            Insert(std::move(c));
+
+        EvictToBudget();
+        return true;
+    }
+
+    void NoiseChunkCache::Insert(Chunk&& c)
+    {
+        m_lru.push_front(std::move(c));
+        m_index[m_lru.front().key] = m_lru.begin();
+        m_stats.bytes += CHUNK_BYTES;
+    }
+
+    void NoiseChunkCache::EvictToBudget()
+    {
+        while (!m_lru.empty() && m_stats.bytes > m_budget)
+        {
+            m_index.erase(m_lru.back().key);
+            m_lru.pop_back();
+            m_stats.bytes -= CHUNK_BYTES;
+            ++m_stats.evictions;
+        }
+
+        m_stats.chunks = m_lru.size();
+    }
+}
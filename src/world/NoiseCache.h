@@ -0,0 +1,88 @@
+#pragma once
+#include "core/Config.h"
+#include "world/Noise.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    struct NoiseCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t chunks = 0;
+        size_t bytes = 0;
+    };
+
+    // World-space cache of fBm samples in cfg::NoiseChunkPx square chunks,
+    // keyed by (seed, params hash, chunk x/y, LOD) and evicted least recently
+    // used first once the memory budget is exceeded.
+    //
+    // LOD L samples the field every 2^L pixels: LOD sample (i, j) is field
+    // pixel (i << L, j << L), bit-identical to the LOD 0 sample there.
+    class NoiseChunkCache
+    {
+    public:
+        explicit NoiseChunkCache(size_t budgetBytes = cfg::NoiseCacheBudgetBytes);
+
+        // Evicts immediately if the cache is now over budget
+        void SetBudget(size_t bytes);
+        size_t Budget() const { return m_budget; }
+
+        // Copies LOD samples [x0, x0+w) x [y0, y0+h) into dst (row pitch `stride`
+        // floats). Missing chunks are computed in parallel and cached.
+        //
+        // `cancelled` is polled before each missing chunk. Once it returns true
+        // the remaining chunks are skipped, dst is left untouched and Read
+        // returns false; chunks that were already finished are still cached.
+        bool Read(float* dst, int stride, int x0, int y0, int w, int h,
+            const NoiseParams& p, int lod, ThreadPool& pool,
+            const std::function<bool()>& cancelled = {});
+
+        const NoiseCacheStats& Stats() const { return m_stats; }
+        void Clear();
+
+    private:
+        struct Key
+        {
+            uint32_t seed = 0;
+            uint64_t paramsHash = 0;
+            int cx = 0;
+            int cy = 0;
+            int lod = 0;
+
+            bool operator==(const Key& o) const
+            {
+                return seed == o.seed && paramsHash == o.paramsHash && cx == o.cx && cy == o.cy && lod == o.lod;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& k) const;
+        };
+
+        struct Chunk
+        {
+            Key key;
+            std::vector<float> samples; // NoiseChunkPx * NoiseChunkPx
+        };
+
+        void Insert(Chunk&& c);
+        void EvictToBudget();
+
+    private:
+        size_t m_budget = 0;
+        std::list<Chunk> m_lru; // front = most recently used
+        std::unordered_map<Key, std::list<Chunk>::iterator, KeyHash> m_index;
+        NoiseCacheStats m_stats;
+    };
+}
@@ -0,0 +1,566 @@
+#include "world/NoiseGraph.h"
+#include "world/NoiseKernels.h"
+#include "world/WorldGen.h"
+#include "core/Config.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+    // X and Y sample positions of the current block, in pixels
+    constexpr int REG_X = 0;
+    constexpr int REG_Y = 1;
+
+    enum class Op : uint8_t
+    {
+        Constant,   // dst = k0
+        FbmRow,     // dst = fBm at the block's own (unwarped) positions, SIMD row kernel
+        FbmPoints,  // dst = shaped fBm at (a, b)
+        MulAdd,     // dst = a + k0 * b  (warped coordinates)
+        Add,        // dst = a + b
+        Mul,        // dst = a * b
+        Clamp,      // dst = clamp(a, k0, k1)
+        Curve,      // dst = curve[table](a)
+        Terrace,    // dst = terrace(a, steps k0, rise k1)
+    };
+
+    struct Instr
+    {
+        Op op = Op::Constant;
+        world::detail::FbmShape shape = world::detail::FbmShape::Plain;
+        int dst = 0;
+        int a = -1;
+        int b = -1;
+        float k0 = 0.0f;
+        float k1 = 0.0f;
+        int table = -1;  // fBm source or curve
+    };
+
+    float CurveAt(const std::vector<float>& points, float v)
+    {
+        const size_t n = points.size() / 2;
+        const float* in = points.data();
+        const float* out = points.data() + n;
+
+        if (v <= in[0])
+            return out[0];
+        if (v >= in[n - 1])
+            return out[n - 1];
+
+        size_t k = 1;
+        while (in[k] < v)
+            ++k;
+
+        const float t = (v - in[k - 1]) / (in[k] - in[k - 1]);
+        return out[k - 1] + (out[k] - out[k - 1]) * t;
+    }
+
+    float TerraceAt(float v, float steps, float rise)
+    {
+        const float t = v * steps;
+        const float base = std::floor(t);
+        const float f = t - base;
+        const float flat = 1.0f - rise;
+
+        float s = 0.0f;
+        if (f > flat)
+        {
+            const float u = (f - flat) / rise;
+            s = u * u * (3.0f - 2.0f * u);
+        }
+
+        return (base + s) / steps;
+    }
+}
+
+namespace world
+{
+    // ---------------------------------------------------------------------
+    // Graph
+    // ---------------------------------------------------------------------
+
+    NoiseGraph::Node NoiseGraph::Push(const NodeDesc& n)
+    {
+        m_nodes.push_back(n);
+        return static_cast<Node>(m_nodes.size()) - 1;
+    }
+
+    NoiseGraph::Node NoiseGraph::Constant(float value)
+    {
+        NodeDesc n;
+        n.kind = Kind::Constant;
+        n.k0 = value;
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Fbm(const NoiseParams& p)
+    {
+        NodeDesc n;
+        n.kind = Kind::Fbm;
+        n.table = static_cast<int>(m_params.size());
+        m_params.push_back(p);
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Ridged(const NoiseParams& p)
+    {
+        NodeDesc n;
+        n.kind = Kind::Ridged;
+        n.table = static_cast<int>(m_params.size());
+        m_params.push_back(p);
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Billow(const NoiseParams& p)
+    {
+        NodeDesc n;
+        n.kind = Kind::Billow;
+        n.table = static_cast<int>(m_params.size());
+        m_params.push_back(p);
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Warp(Node source, Node dx, Node dy, float strength)
+    {
+        NodeDesc n;
+        n.kind = Kind::Warp;
+        n.a = source;
+        n.b = dx;
+        n.c = dy;
+        n.k0 = strength;
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Add(Node a, Node b)
+    {
+        NodeDesc n;
+        n.kind = Kind::Add;
+        n.a = a;
+        n.b = b;
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Mul(Node a, Node b)
+    {
+        NodeDesc n;
+        n.kind = Kind::Mul;
+        n.a = a;
+        n.b = b;
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Clamp(Node a, float lo, float hi)
+    {
+        NodeDesc n;
+        n.kind = Kind::Clamp;
+        n.a = a;
+        n.k0 = lo;
+        n.k1 = hi;
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Curve(Node a, std::vector<float> in, std::vector<float> out)
+    {
+        const size_t count = std::min(in.size(), out.size());
+        if (count == 0)
+            return a;
+
+        std::vector<float> points(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(count));
+        points.insert(points.end(), out.begin(), out.begin() + static_cast<std::ptrdiff_t>(count));
+
+        NodeDesc n;
+        n.kind = Kind::Curve;
+        n.a = a;
+        n.table = static_cast<int>(m_curves.size());
+        m_curves.push_back(std::move(points));
+        return Push(n);
+    }
+
+    NoiseGraph::Node NoiseGraph::Terrace(Node a, float steps, float rise)
+    {
+        NodeDesc n;
+        n.kind = Kind::Terrace;
+        n.a = a;
+        n.k0 = std::max(steps, 1.0f);
+        n.k1 = std::clamp(rise, 0.001f, 1.0f);
+        return Push(n);
+    }
+
+    // ---------------------------------------------------------------------
+    // Program
+    // ---------------------------------------------------------------------
+
+    struct NoiseProgram::Impl
+    {
+        int blockSamples = MaxBlockSamples;
+        int registers = 2;
+        int output = -1;
+        std::vector<Instr> code;
+
+        // Per fBm source: the table its setup points into, and the setup
+        std::vector<std::shared_ptr<const detail::PermTable>> perms;
+        std::vector<detail::FbmSetup> setups;
+        std::vector<std::vector<float>> curves;
+
+        void Block(float* regs, int x, int y, int count) const;
+    };
+
+    // Flattens the nodes `output` depends on into instructions in dependency
+    // order. A node is emitted once per coordinate context (the X/Y registers
+    // it samples at), so a subgraph shared between branches runs once. Values
+    // get one virtual register each; physical registers are then reused once
+    // a value's last reader has run.
+    NoiseProgram NoiseProgram::Compile(const NoiseGraph& graph, NoiseGraph::Node output, int blockSamples)
+    {
+        using Kind = NoiseGraph::Kind;
+
+        NoiseProgram program;
+        Impl& impl = *program.m_impl;
+        impl.blockSamples = std::clamp(blockSamples, 1, MaxBlockSamples);
+        impl.curves = graph.m_curves;
+
+        if (output < 0 || output >= static_cast<int>(graph.m_nodes.size()))
+        {
+            Instr zero;
+            zero.dst = 2;
+            impl.code.push_back(zero);
+            impl.output = 2;
+            impl.registers = 3;
+            return program;
+        }
+
+        std::vector<int> sourceOf(graph.m_params.size(), -1);
+        std::map<std::tuple<int, int, int>, int> done;
+        int next = 2;
+
+        const auto push = [&](Instr in)
+        {
+            in.dst = next++;
+            impl.code.push_back(in);
+            return in.dst;
+        };
+
+        const auto source = [&](int table)
+        {
+            if (sourceOf[table] < 0)
+            {
+                auto perm = detail::SeedPermutation(graph.m_params[table].seed);
+                impl.setups.push_back(detail::MakeFbmSetup(graph.m_params[table], *perm));
+                impl.perms.push_back(std::move(perm));
+                sourceOf[table] = static_cast<int>(impl.setups.size()) - 1;
+            }
+            return sourceOf[table];
+        };
+
+        const auto emit = [&](auto& self, int node, int xReg, int yReg) -> int
+        {
+            const auto key = std::make_tuple(node, xReg, yReg);
+            if (const auto it = done.find(key); it != done.end())
+                return it->second;
+
+            const NoiseGraph::NodeDesc& n = graph.m_nodes[static_cast<size_t>(node)];
+            const bool unwarped = (xReg == REG_X && yReg == REG_Y);
+
+            Instr in;
+            int reg = -1;
+            switch (n.kind)
+            {
+            case Kind::Constant:
+                in.op = Op::Constant;
+                in.k0 = n.k0;
+                reg = push(in);
+                break;
+
+            case Kind::Fbm:
+            case Kind::Ridged:
+            case Kind::Billow:
+                in.table = source(n.table);
+                if (n.kind == Kind::Fbm && unwarped)
+                {
+                    in.op = Op::FbmRow;
+                }
+                else
+                {
+                    in.op = Op::FbmPoints;
+                    in.shape = (n.kind == Kind::Ridged) ? detail::FbmShape::Ridged
+                        : (n.kind == Kind::Billow) ? detail::FbmShape::Billow : detail::FbmShape::Plain;
+                    in.a = xReg;
+                    in.b = yReg;
+                }
+                reg = push(in);
+                break;
+
+            case Kind::Warp:
+            {
+                const int dx = self(self, n.b, xReg, yReg);
+                const int dy = self(self, n.c, xReg, yReg);
+
+                in.op = Op::MulAdd;
+                in.k0 = n.k0;
+                in.a = xReg;
+                in.b = dx;
+                const int wx = push(in);
+                in.a = yReg;
+                in.b = dy;
+                const int wy = push(in);
+
+                reg = self(self, n.a, wx, wy);
+                break;
+            }
+
+            case Kind::Add:
+            case Kind::Mul:
+                in.op = (n.kind == Kind::Add) ? Op::Add : Op::Mul;
+                in.a = self(self, n.a, xReg, yReg);
+                in.b = self(self, n.b, xReg, yReg);
+                reg = push(in);
+                break;
+
+            case Kind::Clamp:
+            case Kind::Curve:
+            case Kind::Terrace:
+                in.op = (n.kind == Kind::Clamp) ? Op::Clamp : (n.kind == Kind::Curve) ? Op::Curve : Op::Terrace;
+                in.a = self(self, n.a, xReg, yReg);
+                in.k0 = n.k0;
+                in.k1 = n.k1;
+                in.table = n.table;
+                reg = push(in);
+                break;
+            }
+
+            done.emplace(key, reg);
+            return reg;
+        };
+
+        const int result = emit(emit, output, REG_X, REG_Y);
+
+        // Every op reads its inputs at sample i before writing sample i, so an
+        // instruction may take over the register of an input it reads last
+        std::vector<int> lastUse(static_cast<size_t>(next), -1);
+        for (size_t k = 0; k < impl.code.size(); ++k)
+        {
+            for (int r : { impl.code[k].a, impl.code[k].b })
+            {
+                if (r >= 0)
+                    lastUse[static_cast<size_t>(r)] = static_cast<int>(k);
+            }
+        }
+        lastUse[static_cast<size_t>(result)] = static_cast<int>(impl.code.size());
+
+        std::vector<int> physical(static_cast<size_t>(next), -1);
+        physical[REG_X] = REG_X;
+        physical[REG_Y] = REG_Y;
+        std::vector<int> spare;
+        int registers = 2;
+
+        for (size_t k = 0; k < impl.code.size(); ++k)
+        {
+            Instr& in = impl.code[k];
+            const int virt = in.dst;
+
+            for (int* r : { &in.a, &in.b })
+            {
+                if (*r < 0)
+                    continue;
+                const int v = *r;
+                *r = physical[static_cast<size_t>(v)];
+                if (v > REG_Y && lastUse[static_cast<size_t>(v)] == static_cast<int>(k)
+                    && std::find(spare.begin(), spare.end(), *r) == spare.end())
+                    spare.push_back(*r);
+            }
+
+            if (spare.empty())
+            {
+                physical[static_cast<size_t>(virt)] = registers++;
+            }
+            else
+            {
+                physical[static_cast<size_t>(virt)] = spare.back();
+                spare.pop_back();
+            }
+            in.dst = physical[static_cast<size_t>(virt)];
+        }
+
+        impl.output = physical[static_cast<size_t>(result)];
+        impl.registers = registers;
+        return program;
+    }
+
+    NoiseProgram::NoiseProgram() : m_impl(std::make_unique<Impl>()) {}
+    NoiseProgram::~NoiseProgram() = default;
+    NoiseProgram::NoiseProgram(NoiseProgram&&) noexcept = default;
+    NoiseProgram& NoiseProgram::operator=(NoiseProgram&&) noexcept = default;
+
+    int NoiseProgram::InstructionCount() const
+    {
+        return static_cast<int>(m_impl->code.size());
+    }
+
+    int NoiseProgram::RegisterCount() const
+    {
+        return m_impl->registers;
+    }
+
+    void NoiseProgram::Impl::Block(float* regs, int x, int y, int count) const
+    {
+        const detail::FbmKernel& kernel = detail::ActiveFbmKernel();
+        const auto reg = [&](int r) { return regs + static_cast<size_t>(r) * MaxBlockSamples; };
+
+        float* rx = reg(REG_X);
+        float* ry = reg(REG_Y);
+        for (int i = 0; i < count; ++i)
+        {
+            rx[i] = static_cast<float>(x + i);
+            ry[i] = static_cast<float>(y);
+        }
+
+        for (const Instr& in : code)
+        {
+            float* d = reg(in.dst);
+            const float* a = (in.a >= 0) ? reg(in.a) : nullptr;
+            const float* b = (in.b >= 0) ? reg(in.b) : nullptr;
+
+            switch (in.op)
+            {
+            case Op::Constant:
+                std::fill(d, d + count, in.k0);
+                break;
+            case Op::FbmRow:
+                kernel.row(setups[static_cast<size_t>(in.table)], x, y, count, d);
+                break;
+            case Op::FbmPoints:
+                detail::ScalarFbmPoints(setups[static_cast<size_t>(in.table)], in.shape, a, b, count, d);
+                break;
+            case Op::MulAdd:
+                for (int i = 0; i < count; ++i)
+                    d[i] = a[i] + in.k0 * b[i];
+                break;
+            case Op::Add:
+                for (int i = 0; i < count; ++i)
+                    d[i] = a[i] + b[i];
+                break;
+            case Op::Mul:
+                for (int i = 0; i < count; ++i)
+                    d[i] = a[i] * b[i];
+                break;
+            case Op::Clamp:
+                for (int i = 0; i < count; ++i)
+                    d[i] = std::clamp(a[i], in.k0, in.k1);
+                break;
+            case Op::Curve:
+            {
+                const std::vector<float>& points = curves[static_cast<size_t>(in.table)];
+                for (int i = 0; i < count; ++i)
+                    d[i] = CurveAt(points, a[i]);
+                break;
+            }
+            case Op::Terrace:
+                for (int i = 0; i < count; ++i)
+                    d[i] = TerraceAt(a[i], in.k0, in.k1);
+                break;
+            }
+        }
+    }
+
+    void NoiseProgram::Evaluate(float* dst, int stride, int x0, int y0, int w, int h) const
+    {
+        const Impl& p = *m_impl;
+        std::vector<float> regs(static_cast<size_t>(p.registers) * MaxBlockSamples);
+        const float* out = regs.data() + static_cast<size_t>(p.output) * MaxBlockSamples;
+
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; x += p.blockSamples)
+            {
+                const int count = std::min(p.blockSamples, w - x);
+                p.Block(regs.data(), x0 + x, y0 + y, count);
+                std::memcpy(dst + static_cast<size_t>(y) * stride + x, out, sizeof(float) * static_cast<size_t>(count));
+            }
+        }
+    }
+
+    void NoiseProgram::Evaluate(float* dst, int stride, int x0, int y0, int w, int h, ThreadPool& pool) const
+    {
+        // Bands of rows as wide as the request, so every block is full-width;
+        // each sample only depends on its position, so any split gives the same bits
+        const int band = cfg::NoiseTilePx;
+        const int bands = (h + band - 1) / band;
+
+        pool.ParallelFor(bands, [&](int b)
+        {
+            const int y = b * band;
+            Evaluate(dst + static_cast<size_t>(y) * stride, stride, x0, y0 + y, w, std::min(band, h - y));
+        });
+    }
+
+    // ---------------------------------------------------------------------
+    // Presets
+    // ---------------------------------------------------------------------
+
+    namespace
+    {
+        // Seed salts per preset layer, so layers of one world never correlate
+        constexpr uint32_t SALT_WARP_X = 0x3A4B0101u;
+        constexpr uint32_t SALT_WARP_Y = 0x3A4B0202u;
+        constexpr uint32_t SALT_RIDGES = 0x3A4B0303u;
+
+        NoiseParams PresetParams(uint32_t seed, float scale, int octaves, float persistence)
+        {
+            NoiseParams p;
+            p.scale = scale;
+            p.octaves = octaves;
+            p.persistence = persistence;
+            p.lacunarity = 2.0f;
+            p.seed = seed;
+            return p;
+        }
+    }
+
+    TerrainGraph BuildTerrainGraph(TerrainPreset preset, const WorldGenSettings& settings, uint32_t seed)
+    {
+        const float res = static_cast<float>(WorldResolution(settings.worldSize));
+        const float volatility = static_cast<float>(std::clamp(settings.worldVolatility, 0, 4)) / 4.0f;
+
+        TerrainGraph t;
+        NoiseGraph& g = t.graph;
+
+        if (preset == TerrainPreset::Continents)
+        {
+            // scale ~ map width / 2 gives one to three landmasses; the warp
+            // breaks up their round outlines and ridges raise ranges inland
+            const float scale = res * 0.5f;
+            const auto warpX = g.Fbm(PresetParams(seed ^ SALT_WARP_X, scale * 0.5f, 3, 0.5f));
+            const auto warpY = g.Fbm(PresetParams(seed ^ SALT_WARP_Y, scale * 0.5f, 3, 0.5f));
+            const auto land = g.Warp(g.Fbm(PresetParams(seed, scale, 5, 0.5f)), warpX, warpY,
+                res * (0.03f + 0.05f * volatility));
+
+            const auto ridges = g.Ridged(PresetParams(seed ^ SALT_RIDGES, scale * 0.25f, 5, 0.5f));
+            const auto inland = g.Clamp(g.Mul(land, g.Constant(4.0f)), 0.0f, 1.0f);
+            const auto ranges = g.Mul(g.Mul(g.Add(ridges, g.Constant(1.0f)), inland),
+                g.Constant(0.1f + 0.2f * volatility));
+
+            t.output = g.Add(land, ranges);
+        }
+        else
+        {
+            // Small features pushed down so most of the map is shallow sea,
+            // then terraced so islands rise in shelves from the shore
+            const float scale = 64.0f + 16.0f * static_cast<float>(std::clamp(settings.worldSize, 0, 4));
+            const auto warpX = g.Fbm(PresetParams(seed ^ SALT_WARP_X, scale, 2, 0.5f));
+            const auto warpY = g.Fbm(PresetParams(seed ^ SALT_WARP_Y, scale, 2, 0.5f));
+            const auto islands = g.Warp(g.Fbm(PresetParams(seed, scale, 6, 0.55f)), warpX, warpY,
+                scale * (0.15f + 0.25f * volatility));
+
+            const auto shaped = g.Curve(islands, { -1.0f, -0.1f, 0.15f, 1.0f }, { -1.0f, -0.45f, 0.05f, 0.8f });
+            t.output = g.Terrace(shaped, 8.0f, 0.4f);
+        }
+
+        return t;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include "world/Noise.h"
+#include "world/WorldGenSettings.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // A terrain field described as a graph of noise sources and operators:
+    //
+    //   NoiseGraph g;
+    //   const auto base = g.Fbm(ElevationParams(seed));
+    //   const auto peaks = g.Mul(g.Ridged(mountains), g.Constant(0.4f));
+    //   const NoiseProgram program = Compile(g, g.Add(base, peaks));
+    //
+    // Node handles are indices into the graph and only valid for it. Sources
+    // sample at the pixel being evaluated unless a Warp moves them.
+    class NoiseGraph
+    {
+    public:
+        using Node = int;
+
+        // Sources
+        Node Constant(float value);
+        Node Fbm(const NoiseParams& p);     // same field as PerlinFbm2D(p)
+        Node Ridged(const NoiseParams& p);  // fBm of (1 - |n|)^2 octaves, in [-1, 1]
+        Node Billow(const NoiseParams& p);  // fBm of 2|n| - 1 octaves
+
+        // Evaluates `source` at (x + strength * dx, y + strength * dy), with dx
+        // and dy sampled at (x, y). Warps nest: a warp inside `source` offsets
+        // the already warped position.
+        Node Warp(Node source, Node dx, Node dy, float strength);
+
+        // Operators
+        Node Add(Node a, Node b);
+        Node Mul(Node a, Node b);
+        Node Clamp(Node a, float lo, float hi);
+
+        // Piecewise-linear remap through (in, out) control points, given in
+        // increasing `in` order; flat beyond the first and last point
+        Node Curve(Node a, std::vector<float> in, std::vector<float> out);
+
+        // Quantizes into `steps` plateaus per unit; each step rises over the
+        // last `rise` (0..1] of its span with a smoothstep
+        Node Terrace(Node a, float steps, float rise);
+
+    private:
+        friend class NoiseProgram;
+
+        enum class Kind : uint8_t
+        {
+            Constant, Fbm, Ridged, Billow, Warp, Add, Mul, Clamp, Curve, Terrace
+        };
+
+        struct NodeDesc
+        {
+            Kind kind = Kind::Constant;
+            Node a = -1;
+            Node b = -1;
+            Node c = -1;
+            float k0 = 0.0f;
+            float k1 = 0.0f;
+            int table = -1;  // into m_params or m_curves
+        };
+
+        Node Push(const NodeDesc& n);
+
+        std::vector<NodeDesc> m_nodes;
+        std::vector<NoiseParams> m_params;
+        std::vector<std::vector<float>> m_curves;  // in..., out... per curve
+    };
+
+    // A graph compiled to a flat instruction list over block registers. One
+    // call runs each instruction across a whole block of samples (one row
+    // segment), so dispatch costs once per block rather than once per sample.
+    // Plain fBm at unwarped positions runs the SIMD row kernel and matches
+    // PerlinFbm2D bit for bit.
+    class NoiseProgram
+    {
+    public:
+        // Largest block; smaller ones only exist for benchmarking dispatch cost
+        static constexpr int MaxBlockSamples = 256;
+
+        NoiseProgram();
+        ~NoiseProgram();
+        NoiseProgram(NoiseProgram&&) noexcept;
+        NoiseProgram& operator=(NoiseProgram&&) noexcept;
+
+        // Compiles the part of `graph` that `output` depends on
+        static NoiseProgram Compile(const NoiseGraph& graph, NoiseGraph::Node output,
+            int blockSamples = MaxBlockSamples);
+
+        int InstructionCount() const;
+        int RegisterCount() const;
+
+        // Same contract as PerlinFbm2DRegion: sample (x0 + i, y0 + j) to
+        // dst[j * stride + i]
+        void Evaluate(float* dst, int stride, int x0, int y0, int w, int h) const;
+        void Evaluate(float* dst, int stride, int x0, int y0, int w, int h, ThreadPool& pool) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
+    // Terrain presets. Both follow WorldGenSettings: worldSize sets the
+    // feature scale relative to the map, worldVolatility the mountain and
+    // warp strength.
+    enum class TerrainPreset
+    {
+        Continents,   // one to three large landmasses with ridged ranges
+        Archipelago,  // many warped islands with terraced shores
+    };
+
+    struct TerrainGraph
+    {
+        NoiseGraph graph;
+        NoiseGraph::Node output = -1;
+    };
+
+    TerrainGraph BuildTerrainGraph(TerrainPreset preset, const WorldGenSettings& settings, uint32_t seed);
+}
@@ -0,0 +1,542 @@
+// NoiseKernels.cpp
+#include "world/NoiseKernels.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    // ---------------------------------------------------------------------
+    // Core Perlin helpers (scalar reference)
+    // ---------------------------------------------------------------------
+
+    float Fade(float t)
+    {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+
+    float Lerp(float a, float b, float t)
+    {
+        return a + t * (b - a);
+    }
+
+    float Grad(int hash, float x, float y)
+    {
+        const int h = hash & 3;
+        const float u = (h < 2) ? x : y;
+        const float v = (h < 2) ? y : x;
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    // Hashing and interpolation for one lattice cell; (xi, yi) the wrapped
+    // cell, (xf, yf) the offset inside it and (u, v) its faded weights
+    float PerlinCell(int xi, int yi, float xf, float yf, float u, float v, const int* perm)
+    {
+        const int aa = perm[perm[xi] + yi];
+        const int ab = perm[perm[xi] + yi + 1];
+        const int ba = perm[perm[xi + 1] + yi];
+        const int bb = perm[perm[xi + 1] + yi + 1];
+
+        const float x1 = Lerp(
+            Grad(aa, xf, yf),
+            Grad(ba, xf - 1.0f, yf),
+            u
+        );
+
+        const float x2 = Lerp(
+            Grad(ab, xf, yf - 1.0f),
+            Grad(bb, xf - 1.0f, yf - 1.0f),
+            u
+        );
+
+        return Lerp(x1, x2, v);
+    }
+
+    float Perlin2D(float x, float y, const int* perm)
+    {
+        const int xi = static_cast<int>(std::floor(x)) & 255;
+        const int yi = static_cast<int>(std::floor(y)) & 255;
+
+        const float xf = x - std::floor(x);
+        const float yf = y - std::floor(y);
+
+        return PerlinCell(xi, yi, xf, yf, Fade(xf), Fade(yf), perm);
+    }
+
+    // ---------------------------------------------------------------------
+    // fBm rows
+    // ---------------------------------------------------------------------
+
+    // Calls fn(0) ... fn(N - 1) as straight-line code
+    template <int N, class Fn>
+    inline void ForEachOctave(Fn&& fn)
+    {
+        [&]<int... O>(std::integer_sequence<int, O...>) { (fn(O), ...); }(std::make_integer_sequence<int, N>{});
+    }
+
+    void FbmRowLoop(const world::detail::FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        const float rowY = (static_cast<float>(y) + s.offsetY) / s.baseScale;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const float bx = (static_cast<float>(x0 + i) + s.offsetX) / s.baseScale;
+
+            float amp = 1.0f;
+            float freq = 1.0f;
+            float sum = 0.0f;
+            float ampSum = 0.0f;
+
+            for (int o = 0; o < s.octaves; ++o)
+            {
+                sum += Perlin2D(bx * freq, rowY * freq, s.perm) * amp;
+                ampSum += amp;
+
+                amp *= s.persistence;
+                freq *= s.lacunarity;
+            }
+
+            if (ampSum > 0.0f)
+                sum /= ampSum;
+
+            out[i] = sum;
+        }
+    }
+
+    // Same arithmetic as FbmRowLoop, with frequencies/amplitudes from the
+    // setup tables and the per-octave row coordinate hoisted out of the row
+    template <int Octaves>
+    void FbmRowUnrolled(const world::detail::FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        const float rowY = (static_cast<float>(y) + s.offsetY) / s.baseScale;
+
+        float ny[Octaves];
+        ForEachOctave<Octaves>([&](int o) { ny[o] = rowY * s.octaveFreq[o]; });
+
+        for (int i = 0; i < count; ++i)
+        {
+            const float bx = (static_cast<float>(x0 + i) + s.offsetX) / s.baseScale;
+
+            float sum = 0.0f;
+            ForEachOctave<Octaves>([&](int o)
+            {
+                sum += Perlin2D(bx * s.octaveFreq[o], ny[o], s.perm) * s.octaveAmp[o];
+            });
+
+            if (s.ampSum > 0.0f)
+                sum /= s.ampSum;
+
+            out[i] = sum;
+        }
+    }
+
+    // Lattice layer key for octave `freq` of a channel (see MultiFbmSetup)
+    world::detail::MultiFbmLayer LayerKey(const world::detail::FbmSetup& s, float freq)
+    {
+        world::detail::MultiFbmLayer key;
+        key.offsetX = s.offsetX;
+        key.offsetY = s.offsetY;
+
+        int exp = 0;
+        if (std::frexp(freq, &exp) == 0.5f)
+        {
+            key.scale = std::ldexp(s.baseScale, 1 - exp); // baseScale / freq, exactly
+            key.freq = 1.0f;
+        }
+        else
+        {
+            key.scale = s.baseScale;
+            key.freq = freq;
+        }
+
+        return key;
+    }
+
+    bool SameLattice(const world::detail::MultiFbmLayer& a, const world::detail::MultiFbmLayer& b)
+    {
+        return a.scale == b.scale && a.freq == b.freq && a.offsetX == b.offsetX && a.offsetY == b.offsetY;
+    }
+
+    // ---------------------------------------------------------------------
+    // CPU feature detection
+    // ---------------------------------------------------------------------
+
+    struct CpuFeatures
+    {
+        bool sse41 = false;
+        bool avx2 = false;
+        bool avx512f = false;
+    };
+
+    CpuFeatures DetectCpu()
+    {
+        CpuFeatures f;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int r[4] = {};
+        __cpuid(r, 0);
+        const int maxLeaf = r[0];
+
+        __cpuid(r, 1);
+        const bool osxsave = (r[2] & (1 << 27)) != 0;
+        const bool avx = (r[2] & (1 << 28)) != 0;
+        f.sse41 = (r[2] & (1 << 19)) != 0;
+
+        // The OS must save YMM/ZMM state on context switch, or AVX code faults
+        const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+        const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+        if (maxLeaf >= 7)
+        {
+            __cpuidex(r, 7, 0);
+            f.avx2 = avx && ymmEnabled && (r[1] & (1 << 5)) != 0;
+            f.avx512f = zmmEnabled && (r[1] & (1 << 16)) != 0;
+        }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        // libgcc/compiler-rt also check XCR0 for the AVX families
+        __builtin_cpu_init();
+        f.sse41 = __builtin_cpu_supports("sse4.1");
+        f.avx2 = __builtin_cpu_supports("avx2");
+        f.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+
+        return f;
+    }
+
+    // ---------------------------------------------------------------------
+    // Dispatch
+    // ---------------------------------------------------------------------
+
+    // Compare a candidate kernel with the scalar one on a small field whose
+    // width is not a multiple of any lane count (so tails get exercised too).
+    bool MatchesScalar(const world::detail::FbmKernel& k, float& maxErr)
+    {
+        std::array<int, 512> perm{};
+        for (int i = 0; i < 512; ++i)
+            perm[i] = ((i & 255) * 167 + 13) & 255;
+
+        world::detail::FbmSetup s;
+        s.perm = perm.data();
+        s.baseScale = 37.5f;
+        s.offsetX = -301.25f;
+        s.offsetY = 77.5f;
+        s.persistence = 0.55f;
+        s.lacunarity = 2.03f;
+
+        constexpr int W = 67;
+        constexpr int H = 5;
+        std::vector<float> ref(W), got(W);
+
+        // Every unrolled octave count plus the runtime loop on either side
+        maxErr = 0.0f;
+        for (int octaves = world::detail::MinUnrolledOctaves - 1; octaves <= world::detail::MaxUnrolledOctaves + 1; ++octaves)
+        {
+            s.octaves = octaves;
+            world::detail::PrepareOctaves(s);
+
+            for (int y = 0; y < H; ++y)
+            {
+                world::detail::ScalarFbmRow(s, -11, y, W, ref.data());
+                k.row(s, -11, y, W, got.data());
+
+                for (int x = 0; x < W; ++x)
+                    maxErr = std::max(maxErr, std::abs(ref[x] - got[x]));
+            }
+        }
+
+        // The multi-channel row: two fields sharing lattices (power-of-two
+        // related scales) and one that shares nothing
+        std::array<int, 512> perm2{};
+        for (int i = 0; i < 512; ++i)
+            perm2[i] = ((i & 255) * 89 + 41) & 255;
+
+        world::detail::FbmSetup channels[3] = { s, s, s };
+        channels[0].octaves = 5;
+        channels[0].lacunarity = 2.0f;
+        channels[1].perm = perm2.data();
+        channels[1].baseScale = 75.0f;
+        channels[1].octaves = 3;
+        channels[1].lacunarity = 2.0f;
+        channels[2].octaves = 2;
+
+        world::detail::MultiFbmSetup m;
+        world::detail::PrepareMultiFbm(channels, 3, m);
+
+        std::vector<float> refs(3 * W), gots(3 * W);
+        float* refOut[3] = { refs.data(), refs.data() + W, refs.data() + 2 * W };
+        float* gotOut[3] = { gots.data(), gots.data() + W, gots.data() + 2 * W };
+        for (int y = 0; y < H; ++y)
+        {
+            world::detail::ScalarMultiFbmRow(m, -11, y, W, refOut);
+            k.multiRow(m, -11, y, W, gotOut);
+
+            for (int i = 0; i < 3 * W; ++i)
+                maxErr = std::max(maxErr, std::abs(refs[i] - gots[i]));
+        }
+
+        return maxErr <= world::detail::SimdKernelTolerance;
+    }
+
+    const world::detail::FbmKernel& SelectKernel()
+    {
+        const auto candidates = world::detail::SupportedSimdFbmKernels();
+
+        for (const world::detail::FbmKernel* k : candidates)
+        {
+            float err = 0.0f;
+            if (MatchesScalar(*k, err))
+            {
+                logx::Info(std::string("Noise kernel: ") + k->name);
+                return *k;
+            }
+
+            logx::Warn(std::string("Noise kernel ") + k->name + " disagrees with scalar reference (max error "
+                + std::to_string(err) + "); skipping it.");
+        }
+
+        logx::Info("Noise kernel: scalar");
+        return world::detail::ScalarFbmKernel();
+    }
+}
+
+namespace world::detail
+{
+    void PrepareOctaves(FbmSetup& s)
+    {
+        s.tableOctaves = 0;
+        s.ampSum = 0.0f;
+        if (s.octaves < 1 || s.octaves > MaxUnrolledOctaves)
+            return;
+
+        float amp = 1.0f;
+        float freq = 1.0f;
+        for (int o = 0; o < s.octaves; ++o)
+        {
+            s.octaveFreq[o] = freq;
+            s.octaveAmp[o] = amp;
+            s.ampSum += amp;
+
+            amp *= s.persistence;
+            freq *= s.lacunarity;
+        }
+
+        s.tableOctaves = s.octaves;
+    }
+
+    void ScalarFbmRow(const FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        static_assert(MinUnrolledOctaves == 4 && MaxUnrolledOctaves == 7, "update the switch below");
+
+        if (s.tableOctaves == s.octaves)
+        {
+            switch (s.octaves)
+            {
+            case 4: return FbmRowUnrolled<4>(s, x0, y, count, out);
+            case 5: return FbmRowUnrolled<5>(s, x0, y, count, out);
+            case 6: return FbmRowUnrolled<6>(s, x0, y, count, out);
+            case 7: return FbmRowUnrolled<7>(s, x0, y, count, out);
+            default: break;
+            }
+        }
+
+        FbmRowLoop(s, x0, y, count, out);
+    }
+
+    bool PrepareMultiFbm(const FbmSetup* channels, int count, MultiFbmSetup& m)
+    {
+        m = MultiFbmSetup{};
+        if (count < 0 || count > MaxMultiChannels)
+            return false;
+
+        // Terms in slot order first, each tagged with its layer
+        MultiFbmLayer key[MaxMultiTerms];
+        int termLayer[MaxMultiTerms] = {};
+        const int* termPerm[MaxMultiTerms] = {};
+
+        int terms = 0;
+        for (int c = 0; c < count; ++c)
+        {
+            const FbmSetup& s = channels[c];
+            const int octaves = std::max(0, s.octaves);
+            if (octaves > MaxMultiOctaves || terms + octaves > MaxMultiTerms)
+                return false;
+
+            m.channelFirstSlot[c] = terms;
+            m.channelOctaves[c] = octaves;
+
+            float amp = 1.0f;
+            float freq = 1.0f;
+            float ampSum = 0.0f;
+            for (int o = 0; o < octaves; ++o, ++terms)
+            {
+                const MultiFbmLayer k = LayerKey(s, freq);
+
+                int layer = 0;
+                while (layer < m.layers && !SameLattice(key[layer], k))
+                    ++layer;
+                if (layer == m.layers)
+                    key[m.layers++] = k;
+
+                termLayer[terms] = layer;
+                termPerm[terms] = s.perm;
+                m.slotAmp[terms] = amp;
+                ampSum += amp;
+
+                amp *= s.persistence;
+                freq *= s.lacunarity;
+            }
+
+            m.channelAmpSum[c] = ampSum;
+        }
+
+        m.channels = count;
+        m.terms = terms;
+
+        // Regroup the terms layer by layer
+        int next = 0;
+        for (int l = 0; l < m.layers; ++l)
+        {
+            m.layer[l] = key[l];
+            m.layer[l].firstTerm = next;
+
+            for (int t = 0; t < terms; ++t)
+            {
+                if (termLayer[t] != l)
+                    continue;
+
+                m.termPerm[next] = termPerm[t];
+                m.termSlot[next] = t;
+                ++next;
+            }
+
+            m.layer[l].termCount = next - m.layer[l].firstTerm;
+        }
+
+        return true;
+    }
+
+    void ScalarMultiFbmRow(const MultiFbmSetup& m, int x0, int y, int count, float* const* out)
+    {
+        // The row coordinate of every layer, once per row
+        int yi[MaxMultiTerms];
+        float yf[MaxMultiTerms];
+        float v[MaxMultiTerms];
+        for (int l = 0; l < m.layers; ++l)
+        {
+            const MultiFbmLayer& L = m.layer[l];
+            const float ny = (static_cast<float>(y) + L.offsetY) / L.scale * L.freq;
+            yi[l] = static_cast<int>(std::floor(ny)) & 255;
+            yf[l] = ny - std::floor(ny);
+            v[l] = Fade(yf[l]);
+        }
+
+        float noise[MaxMultiTerms];
+        for (int i = 0; i < count; ++i)
+        {
+            for (int l = 0; l < m.layers; ++l)
+            {
+                const MultiFbmLayer& L = m.layer[l];
+                const float nx = (static_cast<float>(x0 + i) + L.offsetX) / L.scale * L.freq;
+                const int xi = static_cast<int>(std::floor(nx)) & 255;
+                const float xf = nx - std::floor(nx);
+                const float u = Fade(xf);
+
+                for (int t = L.firstTerm; t < L.firstTerm + L.termCount; ++t)
+                    noise[m.termSlot[t]] = PerlinCell(xi, yi[l], xf, yf[l], u, v[l], m.termPerm[t]);
+            }
+
+            for (int c = 0; c < m.channels; ++c)
+            {
+                const int first = m.channelFirstSlot[c];
+
+                float sum = 0.0f;
+                for (int o = 0; o < m.channelOctaves[c]; ++o)
+                    sum += noise[first + o] * m.slotAmp[first + o];
+
+                if (m.channelAmpSum[c] > 0.0f)
+                    sum /= m.channelAmpSum[c];
+
+                out[c][i] = sum;
+            }
+        }
+    }
+
+    void ScalarFbmPoints(const FbmSetup& s, FbmShape shape, const float* x, const float* y, int count, float* out)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            const float bx = (x[i] + s.offsetX) / s.baseScale;
+            const float by = (y[i] + s.offsetY) / s.baseScale;
+
+            float amp = 1.0f;
+            float freq = 1.0f;
+            float sum = 0.0f;
+            float ampSum = 0.0f;
+
+            for (int o = 0; o < s.octaves; ++o)
+            {
+                float n = Perlin2D(bx * freq, by * freq, s.perm);
+                if (shape == FbmShape::Ridged)
+                {
+                    n = 1.0f - std::abs(n);
+                    n *= n;
+                }
+                else if (shape == FbmShape::Billow)
+                {
+                    n = 2.0f * std::abs(n) - 1.0f;
+                }
+
+                sum += n * amp;
+                ampSum += amp;
+
+                amp *= s.persistence;
+                freq *= s.lacunarity;
+            }
+
+            if (ampSum > 0.0f)
+                sum /= ampSum;
+            if (shape == FbmShape::Ridged)
+                sum = sum * 2.0f - 1.0f;
+
+            out[i] = sum;
+        }
+    }
+
+    std::vector<const FbmKernel*> SupportedSimdFbmKernels()
+    {
+        const CpuFeatures cpu = DetectCpu();
+
+        std::vector<const FbmKernel*> out;
+        if (cpu.avx512f && Avx512FbmKernel())
+            out.push_back(Avx512FbmKernel());
+        if (cpu.avx2 && Avx2FbmKernel())
+            out.push_back(Avx2FbmKernel());
+        if (cpu.sse41 && Sse41FbmKernel())
+            out.push_back(Sse41FbmKernel());
+
+        return out;
+    }
+
+    const FbmKernel& ScalarFbmKernel()
+    {
+        static const FbmKernel kernel{ "scalar", &ScalarFbmRow, &ScalarMultiFbmRow };
+        return kernel;
+    }
+
+    const FbmKernel& ActiveFbmKernel()
+    {
+        static const FbmKernel& kernel = SelectKernel();
+        return kernel;
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace world
+{
+    struct NoiseParams;
+}
+
+// Internal interface between the public noise API (Noise.cpp) and the
+// per-instruction-set fBm kernels. Not meant to be included by game code.
+namespace world::detail
+{
+    // Octave counts with a fully unrolled kernel; other counts take the runtime loop
+    constexpr int MinUnrolledOctaves = 4;
+    constexpr int MaxUnrolledOctaves = 7;
+
+    // Everything a row kernel needs, resolved once per PerlinFbm2D call
+    struct FbmSetup
+    {
+        const int* perm = nullptr; // 512 entries (256-entry permutation, doubled)
+        float baseScale = 1.0f;
+        float offsetX = 0.0f;
+        float offsetY = 0.0f;
+        int   octaves = 0;
+        float persistence = 0.5f;
+        float lacunarity = 2.0f;
+
+        // Per-octave frequency and amplitude, and the amplitude sum, as the
+        // octave loop would accumulate them. Filled by PrepareOctaves(); the
+        // unrolled kernels only run when tableOctaves == octaves.
+        int   tableOctaves = 0;
+        float octaveFreq[MaxUnrolledOctaves] = {};
+        float octaveAmp[MaxUnrolledOctaves] = {};
+        float ampSum = 0.0f;
+    };
+
+    // Fills the octave tables from octaves/persistence/lacunarity
+    void PrepareOctaves(FbmSetup& s);
+
+    // The seed's permutation table (shared, cached per seed; see Noise.cpp)
+    // and the setup PerlinFbm2D builds from it. The setup points into the
+    // table, so keep the table alive while the setup is in use.
+    using PermTable = std::array<int, 512>;
+    std::shared_ptr<const PermTable> SeedPermutation(uint32_t seed);
+    FbmSetup MakeFbmSetup(const NoiseParams& p, const PermTable& perm);
+
+    // Writes `count` consecutive samples of row `y`, starting at column `x0`.
+    // Every kernel picks its unrolled variant for s.octaves itself.
+    using FbmRowFn = void (*)(const FbmSetup& s, int x0, int y, int count, float* out);
+
+    // Limits of one multi-channel pass (see MultiFbmSetup)
+    constexpr int MaxMultiChannels = 8;
+    constexpr int MaxMultiOctaves = 16;
+    constexpr int MaxMultiTerms = 64;
+
+    // Several fBm fields evaluated together. Every (channel, octave) pair is a
+    // term; terms whose sample coordinates come out bit-identical share a
+    // lattice layer, which computes floor, fraction and fade once for all of
+    // them. Only the permutation hashing, gradients and lerps run per term.
+    //
+    // An octave at a power-of-two frequency f samples (x + off) / scale * f,
+    // which is exactly (x + off) / (scale / f): such octaves are keyed by the
+    // reduced scale, so octave 1 of a 128-scale field and octave 0 of a 64-scale
+    // field land on the same layer.
+    struct MultiFbmLayer
+    {
+        float scale = 1.0f;
+        float freq = 1.0f;
+        float offsetX = 0.0f;
+        float offsetY = 0.0f;
+        int   firstTerm = 0; // terms [firstTerm, firstTerm + termCount) read this layer
+        int   termCount = 0;
+    };
+
+    struct MultiFbmSetup
+    {
+        int channels = 0;
+        int layers = 0;
+        int terms = 0;
+        MultiFbmLayer layer[MaxMultiTerms];
+
+        // Per term, grouped by layer: the channel's permutation and the slot
+        // the term's noise value goes to (slots are channel-major, octave order)
+        const int* termPerm[MaxMultiTerms] = {};
+        int termSlot[MaxMultiTerms] = {};
+
+        // Per channel: its slots, their amplitudes and the amplitude sum, as the
+        // single-channel octave loop accumulates them
+        int   channelFirstSlot[MaxMultiChannels] = {};
+        int   channelOctaves[MaxMultiChannels] = {};
+        float slotAmp[MaxMultiTerms] = {};
+        float channelAmpSum[MaxMultiChannels] = {};
+    };
+
+    // Builds the layers for channels[0..count). False if the channels exceed
+    // the Max* limits above; callers then evaluate them one by one.
+    bool PrepareMultiFbm(const FbmSetup* channels, int count, MultiFbmSetup& m);
+
+    // Writes `count` samples of row `y` from column `x0` for every channel:
+    // channel c to out[c]. Each channel matches its single-channel FbmRowFn.
+    using MultiFbmRowFn = void (*)(const MultiFbmSetup& m, int x0, int y, int count, float* const* out);
+
+    struct FbmKernel
+    {
+        const char* name;
+        FbmRowFn row;
+        MultiFbmRowFn multiRow;
+    };
+
+    // Reference implementations; SIMD kernels use them for row tails
+    void ScalarFbmRow(const FbmSetup& s, int x0, int y, int count, float* out);
+    void ScalarMultiFbmRow(const MultiFbmSetup& m, int x0, int y, int count, float* const* out);
+
+    const FbmKernel& ScalarFbmKernel();
+
+    // Per-octave shaping for the point kernel
+    enum class FbmShape : uint8_t
+    {
+        Plain,   // the octave value itself
+        Ridged,  // (1 - |n|)^2, sharp crests where the noise crosses zero
+        Billow,  // 2|n| - 1, rounded lumps
+    };
+
+    // fBm at arbitrary sample positions (pixel units, mapped like the row
+    // kernels), for warped coordinates. Plain at integer positions gives the
+    // row kernels' values; Ridged is rescaled from [0, 1] to [-1, 1].
+    void ScalarFbmPoints(const FbmSetup& s, FbmShape shape, const float* x, const float* y, int count, float* out);
+
+    // Best kernel for this CPU (CPUID), verified against the scalar kernel on
+    // first use. Falls back to scalar if nothing faster is usable.
+    const FbmKernel& ActiveFbmKernel();
+
+    // SIMD kernels built into this binary that the CPU can run, fastest first
+    std::vector<const FbmKernel*> SupportedSimdFbmKernels();
+
+    // Max |simd - scalar| accepted by the first-use verification
+    constexpr float SimdKernelTolerance = 1e-5f;
+
+    // Per-ISA kernels; null when the TU was built without that instruction set
+    const FbmKernel* Sse41FbmKernel();
+    const FbmKernel* Avx2FbmKernel();
+    const FbmKernel* Avx512FbmKernel();
+}
@@ -0,0 +1,71 @@
+// NoiseKernelsAvx2.cpp
+//
+// 8-wide fBm kernel using hardware gathers for the permutation lookups.
+// Built with -mavx2 (GCC/Clang) or /arch:AVX2 (MSVC); see CMakeLists.txt.
+#include "world/NoiseKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2
+    {
+        using F = __m256;
+        using I = __m256i;
+        static constexpr int Lanes = 8;
+
+        static F Set1(float v) { return _mm256_set1_ps(v); }
+        static I Set1i(int v) { return _mm256_set1_epi32(v); }
+        static I Iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+        static F ToFloat(I v) { return _mm256_cvtepi32_ps(v); }
+
+        static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+        static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+        static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+        static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+        static I Addi(I a, I b) { return _mm256_add_epi32(a, b); }
+        static I Andi(I a, I b) { return _mm256_and_si256(a, b); }
+
+        static F Floor(F v) { return _mm256_floor_ps(v); }
+        static I Trunc(F v) { return _mm256_cvttps_epi32(v); }
+
+        static I Gather(const int* base, I idx) { return _mm256_i32gather_epi32(base, idx, 4); }
+
+        static F Grad(I hash, F x, F y)
+        {
+            const I h = _mm256_and_si256(hash, _mm256_set1_epi32(3));
+            const F lt2 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), h));
+
+            const F u = _mm256_blendv_ps(y, x, lt2);
+            const F v = _mm256_blendv_ps(x, y, lt2);
+
+            const F signU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+            const F signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+
+            return _mm256_add_ps(_mm256_xor_ps(u, signU), _mm256_xor_ps(v, signV));
+        }
+
+        static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    };
+}
+
+#include "world/NoiseKernelsSimd.inl"
+
+namespace world::detail
+{
+    const FbmKernel* Avx2FbmKernel()
+    {
+        static const FbmKernel kernel{ "AVX2", &FbmRowSimd<Avx2>, &MultiFbmRowSimd<Avx2> };
+        return &kernel;
+    }
+}
+
+#else
+
+namespace world::detail
+{
+    const FbmKernel* Avx2FbmKernel() { return nullptr; }
+}
+
+#endif
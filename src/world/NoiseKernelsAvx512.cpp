@@ -0,0 +1,73 @@
+// NoiseKernelsAvx512.cpp
+//
+// 16-wide fBm kernel (AVX-512F only, no DQ/BW/VL required).
+// Built with -mavx512f (GCC/Clang) or /arch:AVX512 (MSVC); see CMakeLists.txt.
+#include "world/NoiseKernels.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512
+    {
+        using F = __m512;
+        using I = __m512i;
+        static constexpr int Lanes = 16;
+
+        static F Set1(float v) { return _mm512_set1_ps(v); }
+        static I Set1i(int v) { return _mm512_set1_epi32(v); }
+        static I Iota() { return _mm512_set_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0); }
+        static F ToFloat(I v) { return _mm512_cvtepi32_ps(v); }
+
+        static F Add(F a, F b) { return _mm512_add_ps(a, b); }
+        static F Sub(F a, F b) { return _mm512_sub_ps(a, b); }
+        static F Mul(F a, F b) { return _mm512_mul_ps(a, b); }
+        static F Div(F a, F b) { return _mm512_div_ps(a, b); }
+        static I Addi(I a, I b) { return _mm512_add_epi32(a, b); }
+        static I Andi(I a, I b) { return _mm512_and_si512(a, b); }
+
+        static F Floor(F v) { return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        static I Trunc(F v) { return _mm512_cvttps_epi32(v); }
+
+        static I Gather(const int* base, I idx) { return _mm512_i32gather_epi32(idx, base, 4); }
+
+        static F Grad(I hash, F x, F y)
+        {
+            const I h = _mm512_and_si512(hash, _mm512_set1_epi32(3));
+            const __mmask16 lt2 = _mm512_cmplt_epi32_mask(h, _mm512_set1_epi32(2));
+
+            const I u = _mm512_castps_si512(_mm512_mask_blend_ps(lt2, y, x));
+            const I v = _mm512_castps_si512(_mm512_mask_blend_ps(lt2, x, y));
+
+            const I signU = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(1)), 31);
+            const I signV = _mm512_slli_epi32(_mm512_and_si512(h, _mm512_set1_epi32(2)), 30);
+
+            return _mm512_add_ps(
+                _mm512_castsi512_ps(_mm512_xor_si512(u, signU)),
+                _mm512_castsi512_ps(_mm512_xor_si512(v, signV)));
+        }
+
+        static void Store(float* p, F v) { _mm512_storeu_ps(p, v); }
+    };
+}
+
+#include "world/NoiseKernelsSimd.inl"
+
+namespace world::detail
+{
+    const FbmKernel* Avx512FbmKernel()
+    {
+        static const FbmKernel kernel{ "AVX-512", &FbmRowSimd<Avx512>, &MultiFbmRowSimd<Avx512> };
+        return &kernel;
+    }
+}
+
+#else
+
+namespace world::detail
+{
+    const FbmKernel* Avx512FbmKernel() { return nullptr; }
+}
+
+#endif
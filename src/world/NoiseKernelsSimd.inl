@@ -0,0 +1,314 @@
+// NoiseKernelsSimd.inl
+//
+// Lane-width-agnostic fBm row kernel. Included once per instruction set by
+// NoiseKernelsSse41.cpp / NoiseKernelsAvx2.cpp / NoiseKernelsAvx512.cpp after
+// they define a traits struct `V` exposing:
+//
+//   F, I, Lanes, Set1, Set1i, Iota, ToFloat, Add, Sub, Mul, Div, Addi, Andi,
+//   Floor, Trunc, Gather, Grad, Store
+//
+// Every operation mirrors the scalar Perlin2D/fBm in NoiseKernels.cpp in the
+// same order (no FMA, no reassociation) so the result matches the scalar
+// kernel; the dispatcher still verifies that within SimdKernelTolerance.
+//
+// FbmRowSimd dispatches on the octave count: 4..7 octaves run fully unrolled
+// with the setup's octave tables, anything else the runtime loop.
+// MultiFbmRowSimd is the multi-channel row (see MultiFbmSetup).
+//
+// Everything here has internal linkage: the TUs are compiled with different
+// -m/arch flags and must not share any out-of-line symbol.
+
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    template <class V>
+    typename V::F FadeV(typename V::F t)
+    {
+        const typename V::F t3 = V::Mul(V::Mul(t, t), t);
+        const typename V::F inner = V::Add(
+            V::Mul(t, V::Sub(V::Mul(t, V::Set1(6.0f)), V::Set1(15.0f))),
+            V::Set1(10.0f));
+        return V::Mul(t3, inner);
+    }
+
+    template <class V>
+    typename V::F LerpV(typename V::F a, typename V::F b, typename V::F t)
+    {
+        return V::Add(a, V::Mul(t, V::Sub(b, a)));
+    }
+
+    // Gradients and interpolation from the four corner hashes of each lane's cell
+    template <class V>
+    typename V::F PerlinBlendV(typename V::I aa, typename V::I ab, typename V::I ba, typename V::I bb,
+        typename V::F xf, typename V::F yf, typename V::F u, typename V::F v)
+    {
+        using F = typename V::F;
+
+        const F fone = V::Set1(1.0f);
+        const F xf1 = V::Sub(xf, fone);
+        const F yf1 = V::Sub(yf, fone);
+
+        const F x1 = LerpV<V>(V::Grad(aa, xf, yf), V::Grad(ba, xf1, yf), u);
+        const F x2 = LerpV<V>(V::Grad(ab, xf, yf1), V::Grad(bb, xf1, yf1), u);
+
+        return LerpV<V>(x1, x2, v);
+    }
+
+    // Hashing and interpolation for one lattice cell per lane (see PerlinCell)
+    template <class V>
+    typename V::F PerlinCellV(typename V::I xi, typename V::I yi, typename V::F xf, typename V::F yf,
+        typename V::F u, typename V::F v, const int* perm)
+    {
+        using I = typename V::I;
+
+        const I one = V::Set1i(1);
+        const I px0 = V::Addi(V::Gather(perm, xi), yi);
+        const I px1 = V::Addi(V::Gather(perm, V::Addi(xi, one)), yi);
+
+        return PerlinBlendV<V>(V::Gather(perm, px0), V::Gather(perm, V::Addi(px0, one)),
+            V::Gather(perm, px1), V::Gather(perm, V::Addi(px1, one)), xf, yf, u, v);
+    }
+
+    // Same, when every lane is in the same cell (xi, yi): four scalar hash
+    // lookups instead of six gathers
+    template <class V>
+    typename V::F PerlinCellUniformV(int xi, int yi, typename V::F xf, typename V::F yf,
+        typename V::F u, typename V::F v, const int* perm)
+    {
+        const int px0 = perm[xi] + yi;
+        const int px1 = perm[xi + 1] + yi;
+
+        return PerlinBlendV<V>(V::Set1i(perm[px0]), V::Set1i(perm[px0 + 1]),
+            V::Set1i(perm[px1]), V::Set1i(perm[px1 + 1]), xf, yf, u, v);
+    }
+
+    template <class V>
+    typename V::F Perlin2DV(typename V::F x, typename V::F y, const int* perm)
+    {
+        using F = typename V::F;
+        using I = typename V::I;
+
+        const F fx = V::Floor(x);
+        const F fy = V::Floor(y);
+
+        const I mask = V::Set1i(255);
+        const I xi = V::Andi(V::Trunc(fx), mask);
+        const I yi = V::Andi(V::Trunc(fy), mask);
+
+        const F xf = V::Sub(x, fx);
+        const F yf = V::Sub(y, fy);
+
+        return PerlinCellV<V>(xi, yi, xf, yf, FadeV<V>(xf), FadeV<V>(yf), perm);
+    }
+
+    // Calls fn(0) ... fn(N - 1) as straight-line code
+    template <int N, class Fn>
+    inline void ForEachOctave(Fn&& fn)
+    {
+        [&]<int... O>(std::integer_sequence<int, O...>) { (fn(O), ...); }(std::make_integer_sequence<int, N>{});
+    }
+
+    template <class V>
+    void FbmRowSimdLoop(const world::detail::FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        using F = typename V::F;
+
+        const int vecCount = count - count % V::Lanes;
+
+        const F offX = V::Set1(s.offsetX);
+        const F scale = V::Set1(s.baseScale);
+        const float rowY = (static_cast<float>(y) + s.offsetY) / s.baseScale;
+
+        for (int i = 0; i < vecCount; i += V::Lanes)
+        {
+            const F bx = V::Div(V::Add(V::ToFloat(V::Addi(V::Set1i(x0 + i), V::Iota())), offX), scale);
+
+            F sum = V::Set1(0.0f);
+            float amp = 1.0f;
+            float freq = 1.0f;
+            float ampSum = 0.0f;
+
+            for (int o = 0; o < s.octaves; ++o)
+            {
+                const F nx = V::Mul(bx, V::Set1(freq));
+                const F ny = V::Set1(rowY * freq);
+
+                sum = V::Add(sum, V::Mul(Perlin2DV<V>(nx, ny, s.perm), V::Set1(amp)));
+                ampSum += amp;
+
+                amp *= s.persistence;
+                freq *= s.lacunarity;
+            }
+
+            if (ampSum > 0.0f)
+                sum = V::Div(sum, V::Set1(ampSum));
+
+            V::Store(out + i, sum);
+        }
+
+        if (vecCount < count)
+            world::detail::ScalarFbmRow(s, x0 + vecCount, y, count - vecCount, out + vecCount);
+    }
+
+    template <class V, int Octaves>
+    void FbmRowSimdUnrolled(const world::detail::FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        using F = typename V::F;
+
+        const int vecCount = count - count % V::Lanes;
+
+        const F offX = V::Set1(s.offsetX);
+        const F scale = V::Set1(s.baseScale);
+        const float rowY = (static_cast<float>(y) + s.offsetY) / s.baseScale;
+
+        // Per-octave broadcasts, including the row coordinate, once per row
+        F freq[Octaves];
+        F amp[Octaves];
+        F ny[Octaves];
+        ForEachOctave<Octaves>([&](int o)
+        {
+            freq[o] = V::Set1(s.octaveFreq[o]);
+            amp[o] = V::Set1(s.octaveAmp[o]);
+            ny[o] = V::Set1(rowY * s.octaveFreq[o]);
+        });
+
+        for (int i = 0; i < vecCount; i += V::Lanes)
+        {
+            const F bx = V::Div(V::Add(V::ToFloat(V::Addi(V::Set1i(x0 + i), V::Iota())), offX), scale);
+
+            F sum = V::Set1(0.0f);
+            ForEachOctave<Octaves>([&](int o)
+            {
+                sum = V::Add(sum, V::Mul(Perlin2DV<V>(V::Mul(bx, freq[o]), ny[o], s.perm), amp[o]));
+            });
+
+            if (s.ampSum > 0.0f)
+                sum = V::Div(sum, V::Set1(s.ampSum));
+
+            V::Store(out + i, sum);
+        }
+
+        if (vecCount < count)
+            world::detail::ScalarFbmRow(s, x0 + vecCount, y, count - vecCount, out + vecCount);
+    }
+
+    template <class V>
+    void FbmRowSimd(const world::detail::FbmSetup& s, int x0, int y, int count, float* out)
+    {
+        static_assert(world::detail::MinUnrolledOctaves == 4 && world::detail::MaxUnrolledOctaves == 7,
+            "update the switch below");
+
+        if (s.tableOctaves == s.octaves)
+        {
+            switch (s.octaves)
+            {
+            case 4: return FbmRowSimdUnrolled<V, 4>(s, x0, y, count, out);
+            case 5: return FbmRowSimdUnrolled<V, 5>(s, x0, y, count, out);
+            case 6: return FbmRowSimdUnrolled<V, 6>(s, x0, y, count, out);
+            case 7: return FbmRowSimdUnrolled<V, 7>(s, x0, y, count, out);
+            default: break;
+            }
+        }
+
+        FbmRowSimdLoop<V>(s, x0, y, count, out);
+    }
+
+    template <class V>
+    void MultiFbmRowSimd(const world::detail::MultiFbmSetup& m, int x0, int y, int count, float* const* out)
+    {
+        using F = typename V::F;
+        using I = typename V::I;
+        using world::detail::MaxMultiChannels;
+        using world::detail::MaxMultiTerms;
+
+        const int vecCount = count - count % V::Lanes;
+
+        // The row coordinate of every layer is the same for all lanes: done in
+        // scalar once per row (same operations, so the same bits) and broadcast
+        struct RowLattice
+        {
+            int yiScalar;
+            I yi;
+            F yf;
+            F v;
+        };
+        RowLattice row[MaxMultiTerms];
+        for (int l = 0; l < m.layers; ++l)
+        {
+            const world::detail::MultiFbmLayer& L = m.layer[l];
+            const float ny = (static_cast<float>(y) + L.offsetY) / L.scale * L.freq;
+            const float fy = std::floor(ny);
+            const float yf = ny - fy;
+
+            row[l].yiScalar = static_cast<int>(fy) & 255;
+            row[l].yi = V::Set1i(row[l].yiScalar);
+            row[l].yf = V::Set1(yf);
+            row[l].v = FadeV<V>(V::Set1(yf));
+        }
+
+        const I mask = V::Set1i(255);
+        F noise[MaxMultiTerms];
+
+        for (int i = 0; i < vecCount; i += V::Lanes)
+        {
+            const F x = V::ToFloat(V::Addi(V::Set1i(x0 + i), V::Iota()));
+
+            for (int l = 0; l < m.layers; ++l)
+            {
+                const world::detail::MultiFbmLayer& L = m.layer[l];
+                const F nx = V::Mul(V::Div(V::Add(x, V::Set1(L.offsetX)), V::Set1(L.scale)), V::Set1(L.freq));
+
+                const F fx = V::Floor(nx);
+                const F xf = V::Sub(nx, fx);
+                const F u = FadeV<V>(xf);
+
+                // The sample coordinate is monotonic in x, so the vector spans
+                // one cell when its first and last lanes do. Low-frequency
+                // layers are nearly always in that case.
+                const float first = std::floor((static_cast<float>(x0 + i) + L.offsetX) / L.scale * L.freq);
+                const float last = std::floor((static_cast<float>(x0 + i + V::Lanes - 1) + L.offsetX) / L.scale * L.freq);
+
+                if (first == last)
+                {
+                    const int xi = static_cast<int>(first) & 255;
+                    for (int t = L.firstTerm; t < L.firstTerm + L.termCount; ++t)
+                    {
+                        noise[m.termSlot[t]] = PerlinCellUniformV<V>(xi, row[l].yiScalar, xf, row[l].yf, u, row[l].v,
+                            m.termPerm[t]);
+                    }
+                }
+                else
+                {
+                    const I xi = V::Andi(V::Trunc(fx), mask);
+                    for (int t = L.firstTerm; t < L.firstTerm + L.termCount; ++t)
+                        noise[m.termSlot[t]] = PerlinCellV<V>(xi, row[l].yi, xf, row[l].yf, u, row[l].v, m.termPerm[t]);
+                }
+            }
+
+            for (int c = 0; c < m.channels; ++c)
+            {
+                const int first = m.channelFirstSlot[c];
+
+                F sum = V::Set1(0.0f);
+                for (int o = 0; o < m.channelOctaves[c]; ++o)
+                    sum = V::Add(sum, V::Mul(noise[first + o], V::Set1(m.slotAmp[first + o])));
+
+                if (m.channelAmpSum[c] > 0.0f)
+                    sum = V::Div(sum, V::Set1(m.channelAmpSum[c]));
+
+                V::Store(out[c] + i, sum);
+            }
+        }
+
+        if (vecCount < count)
+        {
+            float* tail[MaxMultiChannels];
+            for (int c = 0; c < m.channels; ++c)
+                tail[c] = out[c] + vecCount;
+
+            world::detail::ScalarMultiFbmRow(m, x0 + vecCount, y, count - vecCount, tail);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+// NoiseKernelsSse41.cpp
+//
+// 4-wide fBm kernel. Built with -msse4.1 on GCC/Clang (see CMakeLists.txt);
+// MSVC x64 accepts SSE4.1 intrinsics without extra flags.
+#include "world/NoiseKernels.h"
+
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && defined(_M_X64))
+#include <smmintrin.h>
+
+namespace
+{
+    struct Sse41
+    {
+        using F = __m128;
+        using I = __m128i;
+        static constexpr int Lanes = 4;
+
+        static F Set1(float v) { return _mm_set1_ps(v); }
+        static I Set1i(int v) { return _mm_set1_epi32(v); }
+        static I Iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+        static F ToFloat(I v) { return _mm_cvtepi32_ps(v); }
+
+        static F Add(F a, F b) { return _mm_add_ps(a, b); }
+        static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+        static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+        static F Div(F a, F b) { return _mm_div_ps(a, b); }
+        static I Addi(I a, I b) { return _mm_add_epi32(a, b); }
+        static I Andi(I a, I b) { return _mm_and_si128(a, b); }
+
+        static F Floor(F v) { return _mm_floor_ps(v); }
+        static I Trunc(F v) { return _mm_cvttps_epi32(v); }
+
+        // No hardware gather before AVX2: spill the indices and load lane by lane
+        static I Gather(const int* base, I idx)
+        {
+            alignas(16) int i[4];
+            _mm_store_si128(reinterpret_cast<I*>(i), idx);
+            return _mm_setr_epi32(base[i[0]], base[i[1]], base[i[2]], base[i[3]]);
+        }
+
+        static F Grad(I hash, F x, F y)
+        {
+            const I h = _mm_and_si128(hash, _mm_set1_epi32(3));
+            const F lt2 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(2)));
+
+            const F u = _mm_blendv_ps(y, x, lt2);
+            const F v = _mm_blendv_ps(x, y, lt2);
+
+            const F signU = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+            const F signV = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+
+            return _mm_add_ps(_mm_xor_ps(u, signU), _mm_xor_ps(v, signV));
+        }
+
+        static void Store(float* p, F v) { _mm_storeu_ps(p, v); }
+    };
+}
+
+#include "world/NoiseKernelsSimd.inl"
+
+namespace world::detail
+{
+    const FbmKernel* Sse41FbmKernel()
+    {
+        static const FbmKernel kernel{ "SSE4.1", &FbmRowSimd<Sse41>, &MultiFbmRowSimd<Sse41> };
+        return &kernel;
+    }
+}
+
+#else
+
+namespace world::detail
+{
+    const FbmKernel* Sse41FbmKernel() { return nullptr; }
+}
+
+#endif
@@ -0,0 +1,243 @@
+#include "world/NoisePreviewWorker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    int FloorDiv(int a, int b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    bool SameParams(const world::NoiseParams& a, const world::NoiseParams& b)
+    {
+        return a.scale == b.scale && a.octaves == b.octaves && a.persistence == b.persistence
+            && a.lacunarity == b.lacunarity && a.seed == b.seed
+            && a.offsetX == b.offsetX && a.offsetY == b.offsetY;
+    }
+
+    // Everything but the window position
+    bool SameField(const world::PreviewRequest& a, const world::PreviewRequest& b)
+    {
+        return a.w == b.w && a.h == b.h && a.lod == b.lod && SameParams(a.params, b.params);
+    }
+
+    bool SameRequest(const world::PreviewRequest& a, const world::PreviewRequest& b)
+    {
+        return SameField(a, b) && a.originX == b.originX && a.originY == b.originY;
+    }
+}
+
+namespace world
+{
+    NoisePreviewWorker::NoisePreviewWorker(ThreadPool& pool)
+        : m_pool(pool), m_viewport(m_cache, pool)
+    {
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    NoisePreviewWorker::~NoisePreviewWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true);
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    void NoisePreviewWorker::Request(const PreviewRequest& r)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_hasRequest && SameRequest(m_request, r))
+                return;
+
+            m_request = r;
+            m_hasRequest = true;
+            m_latest.fetch_add(1); // the job in flight sees this and stops
+        }
+        m_wake.notify_one();
+    }
+
+    bool NoisePreviewWorker::TakeCoarse(PreviewCoarsePass& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasCoarse)
+            return false;
+
+        std::swap(out, m_coarse);
+        m_hasCoarse = false;
+        return true;
+    }
+
+    bool NoisePreviewWorker::TakeRing(PreviewRingUpdate& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasRing)
+            return false;
+
+        std::swap(out, m_ring);
+        m_hasRing = false;
+        return true;
+    }
+
+    bool NoisePreviewWorker::Busy() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_hasRequest && m_done != m_latest.load();
+    }
+
+    NoiseCacheStats NoisePreviewWorker::CacheStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void NoisePreviewWorker::Run()
+    {
+        for (;;)
+        {
+            PreviewRequest request;
+            uint64_t generation = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stop.load() || (m_hasRequest && m_done != m_latest.load()); });
+                if (m_stop.load())
+                    return;
+
+                request = m_request;
+                generation = m_latest.load();
+            }
+
+            const bool finished = Process(request, generation);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (finished)
+                m_done = generation;
+            m_stats = m_cache.Stats();
+        }
+    }
+
+    bool NoisePreviewWorker::Process(const PreviewRequest& r, uint64_t generation)
+    {
+        const auto cancelled = [this, generation]
+        {
+            return m_stop.load(std::memory_order_relaxed) || m_latest.load(std::memory_order_relaxed) != generation;
+        };
+
+        const bool sameField = m_hasField && SameField(m_field, r);
+
+        // Pan: only what scrolled into view
+        if (sameField && m_viewport.Valid())
+        {
+            if (!m_viewport.ScrollTo(r.originX, r.originY, cancelled))
+                return false;
+
+            PublishRing(false);
+            return true;
+        }
+
+        if (!sameField)
+        {
+            // Coarse pass over the same area, one sample per 8x8 block
+            const int step = 1 << PreviewCoarseShift;
+
+            PreviewCoarsePass& pass = m_coarseScratch;
+            pass.lod = r.lod + PreviewCoarseShift;
+            pass.originX = FloorDiv(r.originX, step);
+            pass.originY = FloorDiv(r.originY, step);
+            pass.w = FloorDiv(r.originX + r.w + step - 1, step) - pass.originX;
+            pass.h = FloorDiv(r.originY + r.h + step - 1, step) - pass.originY;
+            pass.samples.resize(static_cast<size_t>(pass.w) * pass.h);
+
+            if (!m_cache.Read(pass.samples.data(), pass.w, pass.originX, pass.originY, pass.w, pass.h,
+                r.params, pass.lod, m_pool, cancelled))
+            {
+                return false;
+            }
+
+            const auto [mn, mx] = std::minmax_element(pass.samples.begin(), pass.samples.end());
+            pass.lo = *mn;
+            pass.hi = *mx;
+            PublishCoarse();
+        }
+
+        if (!m_viewport.Reset(r.w, r.h, r.params, r.lod, r.originX, r.originY, cancelled))
+            return false;
+
+        // Fix the grey range per field so strips computed while panning match it
+        if (!sameField)
+        {
+            const float* samples = m_viewport.Ring();
+            const auto [mn, mx] = std::minmax_element(samples, samples + static_cast<size_t>(r.w) * r.h);
+            m_lo = *mn;
+            m_hi = *mx;
+            m_field = r;
+            m_hasField = true;
+        }
+
+        PublishRing(true);
+        return true;
+    }
+
+    void NoisePreviewWorker::PublishCoarse()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_coarseScratch.serial = ++m_serial;
+        std::swap(m_coarse, m_coarseScratch);
+        m_hasCoarse = true;
+    }
+
+    void NoisePreviewWorker::PublishRing(bool full)
+    {
+        // An update the render thread has not taken yet can't simply be
+        // replaced by a partial one: resend the whole ring instead.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            full = full || m_hasRing;
+        }
+
+        PreviewRingUpdate& u = m_ringScratch;
+        u.full = full;
+        u.w = m_viewport.Width();
+        u.h = m_viewport.Height();
+        u.lod = m_viewport.Lod();
+        u.originX = m_viewport.OriginX();
+        u.originY = m_viewport.OriginY();
+        u.ringX = m_viewport.RingX();
+        u.ringY = m_viewport.RingY();
+        u.lo = m_lo;
+        u.hi = m_hi;
+
+        u.rects.clear();
+        u.samples.clear();
+
+        if (full)
+        {
+            u.rects.push_back(RingRect{ 0, 0, u.w, u.h });
+            u.samples.assign(m_viewport.Ring(), m_viewport.Ring() + static_cast<size_t>(u.w) * u.h);
+        }
+        else
+        {
+            u.rects.assign(m_viewport.Dirty().begin(), m_viewport.Dirty().end());
+
+            for (const RingRect& rc : u.rects)
+            {
+                for (int y = 0; y < rc.h; ++y)
+                {
+                    const float* src = m_viewport.Ring() + static_cast<size_t>(rc.y + y) * u.w + rc.x;
+                    u.samples.insert(u.samples.end(), src, src + rc.w);
+                }
+            }
+        }
+
+        m_viewport.ClearDirty();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        u.serial = ++m_serial;
+        std::swap(m_ring, u);
+        m_hasRing = true;
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include "world/Noise.h"
+#include "world/NoiseCache.h"
+#include "world/NoiseViewport.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // The coarse pass samples every 2^PreviewCoarseShift-th LOD sample (1/8)
+    constexpr int PreviewCoarseShift = 3;
+
+    // What the preview should show: a w x h window of LOD samples
+    struct PreviewRequest
+    {
+        int w = 0;
+        int h = 0;
+        NoiseParams params{};
+        int lod = 0;
+        int originX = 0; // top-left sample, in LOD samples
+        int originY = 0;
+    };
+
+    // Quick low-resolution pass covering (at least) the requested window
+    struct PreviewCoarsePass
+    {
+        uint64_t serial = 0; // publication order, shared with PreviewRingUpdate
+        int w = 0;
+        int h = 0;
+        int lod = 0;         // request LOD + PreviewCoarseShift
+        int originX = 0;     // in samples of that LOD
+        int originY = 0;
+        float lo = 0.0f;     // grey range of this pass
+        float hi = 1.0f;
+        std::vector<float> samples; // w * h, row-major
+    };
+
+    // Full-resolution change to the toroidal window (see NoiseViewport)
+    struct PreviewRingUpdate
+    {
+        uint64_t serial = 0;
+        bool full = false;   // the whole ring was replaced (size, LOD or field may differ)
+        int w = 0;
+        int h = 0;
+        int lod = 0;
+        int originX = 0;
+        int originY = 0;
+        int ringX = 0;
+        int ringY = 0;
+        float lo = 0.0f;     // grey range, fixed until the field changes
+        float hi = 1.0f;
+        std::vector<RingRect> rects;
+        std::vector<float> samples; // each rect's samples, row-major, one rect after another
+    };
+
+    // Computes the map preview on a background thread so the render loop never
+    // waits on noise generation.
+    //
+    // A new field (size, LOD, parameters) is published in two passes: a 1/8
+    // resolution coarse pass, then the full ring. A pan of the same field only
+    // computes what scrolled into view. Posting a different request cancels
+    // the job in flight at the next chunk boundary; chunks it finished stay
+    // in the cache, so the restarted job picks up from there.
+    class NoisePreviewWorker
+    {
+    public:
+        explicit NoisePreviewWorker(ThreadPool& pool);
+        ~NoisePreviewWorker();
+
+        NoisePreviewWorker(const NoisePreviewWorker&) = delete;
+        NoisePreviewWorker& operator=(const NoisePreviewWorker&) = delete;
+
+        // Never blocks on generation. Repeating the current request is a no-op.
+        void Request(const PreviewRequest& r);
+
+        // Hand finished passes to the render thread. False if there is nothing new.
+        bool TakeCoarse(PreviewCoarsePass& out);
+        bool TakeRing(PreviewRingUpdate& out);
+
+        // True until the latest request has been fully published
+        bool Busy() const;
+
+        NoiseCacheStats CacheStats() const;
+
+    private:
+        void Run();
+
+        // False if the job was cancelled
+        bool Process(const PreviewRequest& r, uint64_t generation);
+        void PublishCoarse();
+        void PublishRing(bool full);
+
+    private:
+        ThreadPool& m_pool;
+
+        // Worker thread only
+        NoiseChunkCache m_cache;
+        NoiseViewport m_viewport;
+        PreviewRequest m_field{};  // field (origin aside) of the current ring
+        bool m_hasField = false;
+        float m_lo = 0.0f;
+        float m_hi = 1.0f;
+
+        // Passes are built here and swapped with the published slots, so the
+        // buffers cycle between worker, slot and render thread without reallocating
+        PreviewCoarsePass m_coarseScratch;
+        PreviewRingUpdate m_ringScratch;
+
+        // Shared, guarded by m_mutex
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        PreviewRequest m_request{};
+        bool m_hasRequest = false;
+        uint64_t m_done = 0;       // last generation fully published
+        uint64_t m_serial = 0;
+        bool m_hasCoarse = false;
+        PreviewCoarsePass m_coarse;
+        bool m_hasRing = false;
+        PreviewRingUpdate m_ring;
+        NoiseCacheStats m_stats;
+
+        std::atomic<uint64_t> m_latest{ 0 }; // bumped by every new request
+        std::atomic<bool> m_stop{ false };
+
+        std::thread m_thread; // last: starts once everything above exists
+    };
+}
@@ -0,0 +1,101 @@
+#include "world/NoiseViewport.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace world
+{
+    NoiseViewport::NoiseViewport(NoiseChunkCache& cache, ThreadPool& pool)
+        : m_cache(cache), m_pool(pool)
+    {
+    }
+
+    bool NoiseViewport::Reset(int w, int h, const NoiseParams& p, int lod, int originX, int originY,
+        const std::function<bool()>& cancelled)
+    {
+        m_params = p;
+        m_lod = lod;
+        m_w = std::max(1, w);
+        m_h = std::max(1, h);
+        m_originX = originX;
+        m_originY = originY;
+
+        m_ring.assign(static_cast<size_t>(m_w) * m_h, 0.0f);
+        m_dirty.clear();
+
+        m_valid = Fill(m_originX, m_originY, m_w, m_h, cancelled);
+        return m_valid;
+    }
+
+    bool NoiseViewport::ScrollTo(int originX, int originY, const std::function<bool()>& cancelled)
+    {
+        if (!Valid())
+            return false;
+
+        const int dx = originX - m_originX;
+        const int dy = originY - m_originY;
+        if (dx == 0 && dy == 0)
+            return true;
+
+        if (std::abs(dx) >= m_w || std::abs(dy) >= m_h)
+            return Reset(m_w, m_h, m_params, m_lod, originX, originY, cancelled);
+
+        m_originX = originX;
+        m_originY = originY;
+
+        // Newly exposed columns, full window height
+        bool ok = true;
+        if (dx > 0)
+            ok = Fill(m_originX + m_w - dx, m_originY, dx, m_h, cancelled);
+        else if (dx < 0)
+            ok = Fill(m_originX, m_originY, -dx, m_h, cancelled);
+
+        // Newly exposed rows, minus the columns already done above
+        const int colX = (dx > 0) ? m_originX : m_originX - dx;
+        const int colW = m_w - std::abs(dx);
+
+        if (ok && dy > 0)
+            ok = Fill(colX, m_originY + m_h - dy, colW, dy, cancelled);
+        else if (ok && dy < 0)
+            ok = Fill(colX, m_originY, colW, -dy, cancelled);
+
+        m_valid = ok;
+        return ok;
+    }
+
+    bool NoiseViewport::Fill(int x0, int y0, int w, int h, const std::function<bool()>& cancelled)
+    {
+        if (w <= 0 || h <= 0)
+            return true;
+
+        // A field rect maps to at most four ring rects (split where the ring wraps)
+        const int rx = Wrap(x0, m_w);
+        const int ry = Wrap(y0, m_h);
+        const int w1 = std::min(w, m_w - rx);
+        const int h1 = std::min(h, m_h - ry);
+
+        const RingRect parts[4] = {
+            { rx, ry, w1, h1 },
+            { 0, ry, w - w1, h1 },
+            { rx, 0, w1, h - h1 },
+            { 0, 0, w - w1, h - h1 },
+        };
+        const int fieldX[4] = { x0, x0 + w1, x0, x0 + w1 };
+        const int fieldY[4] = { y0, y0, y0 + h1, y0 + h1 };
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const RingRect& r = parts[i];
+            if (r.w <= 0 || r.h <= 0)
+                continue;
+
+            float* dst = m_ring.data() + static_cast<size_t>(r.y) * m_w + r.x;
+            if (!m_cache.Read(dst, m_w, fieldX[i], fieldY[i], r.w, r.h, m_params, m_lod, m_pool, cancelled))
+                return false;
+
+            m_dirty.push_back(r);
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "world/Noise.h"
+#include "world/NoiseCache.h"
+
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // Rectangle in ring-buffer (texture) cells
+    struct RingRect
+    {
+        int x = 0;
+        int y = 0;
+        int w = 0;
+        int h = 0;
+    };
+
+    // A w x h window onto the infinite fBm field of one NoiseParams, stored
+    // toroidally: field sample (X, Y) lives in ring cell (X mod w, Y mod h).
+    // Scrolling the window only computes the newly exposed rows/columns and
+    // reports them as dirty ring rects; every other sample stays where it is,
+    // so a texture mirroring the ring only needs those rects re-uploaded.
+    // Samples are read through the chunk cache, so revisiting an area is cheap.
+    class NoiseViewport
+    {
+    public:
+        NoiseViewport(NoiseChunkCache& cache, ThreadPool& pool);
+
+        // Refills the whole window with (originX, originY) as its top-left sample.
+        // Coordinates are in LOD samples (see NoiseChunkCache): one sample every 2^lod pixels.
+        //
+        // Both calls poll `cancelled` between chunks. A cancelled call returns
+        // false and leaves the viewport invalid until the next Reset.
+        bool Reset(int w, int h, const NoiseParams& p, int lod, int originX, int originY,
+            const std::function<bool()>& cancelled = {});
+
+        // Moves the window, filling only what came into view. Jumps of a full
+        // window or more are handled as a Reset.
+        bool ScrollTo(int originX, int originY, const std::function<bool()>& cancelled = {});
+
+        bool Valid() const { return m_valid; }
+        int Width() const { return m_w; }
+        int Height() const { return m_h; }
+        int OriginX() const { return m_originX; }
+        int OriginY() const { return m_originY; }
+        int Lod() const { return m_lod; }
+        const NoiseParams& Params() const { return m_params; }
+
+        // Ring cell holding the window's top-left sample
+        int RingX() const { return Wrap(m_originX, m_w); }
+        int RingY() const { return Wrap(m_originY, m_h); }
+
+        // Row-major ring storage, Width() floats per row
+        const float* Ring() const { return m_ring.data(); }
+
+        // Ring rects written since the last ClearDirty()
+        const std::vector<RingRect>& Dirty() const { return m_dirty; }
+        void ClearDirty() { m_dirty.clear(); }
+
+    private:
+        static int Wrap(int v, int n) { const int m = v % n; return m < 0 ? m + n : m; }
+
+        // Computes the field rect [x0, x0+w) x [y0, y0+h) (must lie inside the window)
+        bool Fill(int x0, int y0, int w, int h, const std::function<bool()>& cancelled);
+
+    private:
+        NoiseChunkCache& m_cache;
+        ThreadPool& m_pool;
+
+        NoiseParams m_params{};
+        int m_w = 0;
+        int m_h = 0;
+        int m_lod = 0;
+        int m_originX = 0;
+        int m_originY = 0;
+
+        bool m_valid = false;
+        std::vector<float> m_ring;
+        std::vector<RingRect> m_dirty;
+    };
+}
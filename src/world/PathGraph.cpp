@@ -0,0 +1,605 @@
+#include "world/PathGraph.h"
+#include "world/TileVolume.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+namespace
+{
+    // Open runs along a border at least this long get a transition at each
+    // end instead of one in the middle
+    constexpr int LONG_ENTRANCE = 6;
+
+    const int STEP_DX[4] = { 1, -1, 0, 0 };
+    const int STEP_DY[4] = { 0, 0, 1, -1 };
+
+    int Manhattan(world::TilePoint a, world::TilePoint b)
+    {
+        return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+    }
+
+    // Index into STEP_DX/STEP_DY of the step between cluster-local indices
+    uint8_t StepCode(int delta, int clusterSize)
+    {
+        return (delta == 1) ? 0 : (delta == -1) ? 1 : (delta == clusterSize) ? 2 : 3;
+    }
+
+    // Open-list order: lowest f, then highest g. Preferring the deeper of
+    // equal-f nodes keeps A* from fanning out across equally good detours.
+    int64_t HeapKey(int f, int g)
+    {
+        return (static_cast<int64_t>(f) << 32) - g;
+    }
+
+    bool SameTile(world::TilePoint a, world::TilePoint b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+}
+
+namespace world
+{
+    bool Walkable(TileType type)
+    {
+        return type == TileType::Floor || type == TileType::Core || type == TileType::Spawner;
+    }
+
+    PathGraph::PathGraph(int width, int height, int clusterSize)
+        : m_width(std::max(width, 1)), m_height(std::max(height, 1)), m_clusterSize(std::max(clusterSize, 2))
+    {
+        m_clustersX = (m_width + m_clusterSize - 1) / m_clusterSize;
+        m_clustersY = (m_height + m_clusterSize - 1) / m_clusterSize;
+        m_walk.assign(static_cast<size_t>(m_width) * m_height, 0);
+        m_borders.resize(static_cast<size_t>(BorderCount()));
+        m_clusterNodes.resize(static_cast<size_t>(m_clustersX) * m_clustersY);
+        m_clusterPaths.resize(m_clusterNodes.size());
+        m_isDirty.assign(m_clusterNodes.size(), 0);
+    }
+
+    void PathGraph::LoadLevel(const TileVolume& volume, int z, ThreadPool& pool)
+    {
+        const int w = std::min(m_width, volume.Width());
+        const int h = std::min(m_height, volume.Height());
+        pool.ParallelFor(h, [&](int y)
+        {
+            uint8_t* row = m_walk.data() + static_cast<size_t>(y) * m_width;
+            for (int x = 0; x < w; ++x)
+                row[x] = Walkable(volume.Get(x, y, z)) ? 1 : 0;
+        });
+        Rebuild(pool);
+    }
+
+    // ---------------------------------------------------------------------
+    // Graph construction
+    // ---------------------------------------------------------------------
+
+    void PathGraph::Transitions(int c, int dir, std::vector<TilePoint>& out) const
+    {
+        out.clear();
+        const int cx = c % m_clustersX;
+        const int cy = c / m_clustersX;
+        if ((dir == 0 && cx + 1 >= m_clustersX) || (dir == 1 && cy + 1 >= m_clustersY))
+            return;
+
+        // Walk along the border: `along` is the coordinate that varies
+        const int x0 = cx * m_clusterSize;
+        const int y0 = cy * m_clusterSize;
+        const int length = (dir == 0) ? std::min(m_clusterSize, m_height - y0) : std::min(m_clusterSize, m_width - x0);
+        const auto tile = [&](int along)
+        {
+            return (dir == 0) ? TilePoint{ x0 + m_clusterSize - 1, y0 + along } : TilePoint{ x0 + along, y0 + m_clusterSize - 1 };
+        };
+        const auto open = [&](int along)
+        {
+            const TilePoint a = tile(along);
+            const TilePoint b = (dir == 0) ? TilePoint{ a.x + 1, a.y } : TilePoint{ a.x, a.y + 1 };
+            return IsWalkable(a.x, a.y) && IsWalkable(b.x, b.y);
+        };
+
+        int run = -1;
+        for (int i = 0; i <= length; ++i)
+        {
+            const bool isOpen = i < length && open(i);
+            if (isOpen && run < 0)
+                run = i;
+            if (isOpen || run < 0)
+                continue;
+
+            const int runLength = i - run;
+            if (runLength < LONG_ENTRANCE)
+                out.push_back(tile(run + runLength / 2));
+            else
+            {
+                out.push_back(tile(run));
+                out.push_back(tile(i - 1));
+            }
+            run = -1;
+        }
+    }
+
+    int PathGraph::NewNode(TilePoint tile, int cluster)
+    {
+        int id;
+        if (!m_freeNodes.empty())
+        {
+            id = m_freeNodes.back();
+            m_freeNodes.pop_back();
+        }
+        else
+        {
+            id = static_cast<int>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        Node& n = m_nodes[static_cast<size_t>(id)];
+        n.tile = tile;
+        n.cluster = cluster;
+        n.partner = -1;
+        n.edges.clear();
+        return id;
+    }
+
+    void PathGraph::ClearBorder(int border)
+    {
+        for (const int id : m_borders[static_cast<size_t>(border)])
+        {
+            Node& n = m_nodes[static_cast<size_t>(id)];
+            n.cluster = -1;
+            n.partner = -1;
+            n.edges.clear();
+            m_freeNodes.push_back(id);
+        }
+        m_borders[static_cast<size_t>(border)].clear();
+    }
+
+    bool PathGraph::RefreshBorder(int c, int dir)
+    {
+        std::vector<TilePoint> tiles;
+        Transitions(c, dir, tiles);
+
+        const int border = c * 2 + dir;
+        const std::vector<int>& old = m_borders[static_cast<size_t>(border)];
+        bool same = old.size() == tiles.size() * 2;
+        for (size_t i = 0; same && i < tiles.size(); ++i)
+            same = SameTile(m_nodes[static_cast<size_t>(old[i * 2])].tile, tiles[i]);
+        if (same)
+            return false;
+
+        ClearBorder(border);
+        const int other = (dir == 0) ? c + 1 : c + m_clustersX;
+        for (const TilePoint& t : tiles)
+        {
+            const TilePoint across = (dir == 0) ? TilePoint{ t.x + 1, t.y } : TilePoint{ t.x, t.y + 1 };
+            const int a = NewNode(t, c);
+            const int b = NewNode(across, other);
+            m_nodes[static_cast<size_t>(a)].partner = b;
+            m_nodes[static_cast<size_t>(b)].partner = a;
+            m_borders[static_cast<size_t>(border)].push_back(a);
+            m_borders[static_cast<size_t>(border)].push_back(b);
+        }
+        return true;
+    }
+
+    void PathGraph::ClusterBfs(TilePoint from, std::vector<int>& dist, std::vector<int>& queue, std::vector<int>* parent,
+        const TilePoint* stop) const
+    {
+        const int C = m_clusterSize;
+        const int x0 = (from.x / C) * C;
+        const int y0 = (from.y / C) * C;
+        const int x1 = std::min(x0 + C, m_width);
+        const int y1 = std::min(y0 + C, m_height);
+
+        dist.assign(static_cast<size_t>(C) * C, -1);
+        if (parent)
+            parent->resize(static_cast<size_t>(C) * C);
+        queue.clear();
+        if (!IsWalkable(from.x, from.y))
+            return;
+
+        const int start = (from.y - y0) * C + (from.x - x0);
+        const int target = stop ? (stop->y - y0) * C + (stop->x - x0) : -1;
+        dist[static_cast<size_t>(start)] = 0;
+        queue.push_back(start);
+
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const int cur = queue[head];
+            if (cur == target)
+                return;
+
+            const int lx = cur % C;
+            const int ly = cur / C;
+            for (int k = 0; k < 4; ++k)
+            {
+                const int x = x0 + lx + STEP_DX[k];
+                const int y = y0 + ly + STEP_DY[k];
+                if (x < x0 || y < y0 || x >= x1 || y >= y1 || !IsWalkable(x, y))
+                    continue;
+
+                const int next = (y - y0) * C + (x - x0);
+                if (dist[static_cast<size_t>(next)] >= 0)
+                    continue;
+                dist[static_cast<size_t>(next)] = dist[static_cast<size_t>(cur)] + 1;
+                if (parent)
+                    (*parent)[static_cast<size_t>(next)] = cur;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    void PathGraph::RebuildCluster(int c, PathScratch& s)
+    {
+        // A cluster's nodes sit on its own east/south borders (first of each
+        // pair) and on its west/north neighbours' (second of each pair)
+        std::vector<int>& nodes = m_clusterNodes[static_cast<size_t>(c)];
+        nodes.clear();
+        const int cx = c % m_clustersX;
+        const int cy = c / m_clustersX;
+        const auto collect = [&](int border, size_t side)
+        {
+            const std::vector<int>& pairs = m_borders[static_cast<size_t>(border)];
+            for (size_t i = side; i < pairs.size(); i += 2)
+                nodes.push_back(pairs[i]);
+        };
+        collect(c * 2 + 0, 0);
+        collect(c * 2 + 1, 0);
+        if (cx > 0)
+            collect((c - 1) * 2 + 0, 1);
+        if (cy > 0)
+            collect((c - m_clustersX) * 2 + 1, 1);
+
+        // Each edge keeps its tile path as step codes, so refining an
+        // abstract path never searches between two nodes
+        std::vector<uint8_t>& paths = m_clusterPaths[static_cast<size_t>(c)];
+        paths.clear();
+
+        const int C = m_clusterSize;
+        const int x0 = cx * C;
+        const int y0 = cy * C;
+        for (const int id : nodes)
+        {
+            Node& n = m_nodes[static_cast<size_t>(id)];
+            n.edges.clear();
+            ClusterBfs(n.tile, s.local, s.queue, &s.localParent, nullptr);
+            const int start = (n.tile.y - y0) * C + (n.tile.x - x0);
+
+            for (const int other : nodes)
+            {
+                if (other == id)
+                    continue;
+                const TilePoint t = m_nodes[static_cast<size_t>(other)].tile;
+                const int end = (t.y - y0) * C + (t.x - x0);
+                const int d = s.local[static_cast<size_t>(end)];
+                if (d < 0)
+                    continue;
+
+                const uint32_t offset = static_cast<uint32_t>(paths.size());
+                paths.resize(paths.size() + static_cast<size_t>(d));
+                size_t at = paths.size();
+                for (int cur = end; cur != start; cur = s.localParent[static_cast<size_t>(cur)])
+                    paths[--at] = StepCode(cur - s.localParent[static_cast<size_t>(cur)], C);
+                n.edges.push_back({ other, d, offset });
+            }
+        }
+    }
+
+    void PathGraph::Rebuild(ThreadPool& pool)
+    {
+        m_nodes.clear();
+        m_freeNodes.clear();
+        for (std::vector<int>& b : m_borders)
+            b.clear();
+
+        const int clusters = m_clustersX * m_clustersY;
+        for (int c = 0; c < clusters; ++c)
+        {
+            RefreshBorder(c, 0);
+            RefreshBorder(c, 1);
+        }
+
+        // Each cluster only writes its own nodes' edges
+        pool.ParallelFor(clusters, [&](int c)
+        {
+            PathScratch s;
+            RebuildCluster(c, s);
+        });
+
+        for (const int c : m_dirty)
+            m_isDirty[static_cast<size_t>(c)] = 0;
+        m_dirty.clear();
+    }
+
+    void PathGraph::SetWalkable(int x, int y, bool walkable)
+    {
+        uint8_t& w = m_walk[static_cast<size_t>(y) * m_width + x];
+        if ((w != 0) == walkable)
+            return;
+        w = walkable ? 1 : 0;
+
+        const int c = ClusterOf(x, y);
+        if (!m_isDirty[static_cast<size_t>(c)])
+        {
+            m_isDirty[static_cast<size_t>(c)] = 1;
+            m_dirty.push_back(c);
+        }
+    }
+
+    size_t PathGraph::Repair()
+    {
+        if (m_dirty.empty())
+            return 0;
+
+        // Every border of a dirty cluster gets its transitions recomputed; a
+        // neighbour only needs its edges redone if the shared ones moved
+        std::vector<int> rebuild;
+        std::vector<uint8_t> queued(m_clusterNodes.size(), 0);
+        std::vector<uint8_t> refreshed(static_cast<size_t>(BorderCount()), 0);
+        const auto enqueue = [&](int c)
+        {
+            if (!queued[static_cast<size_t>(c)])
+            {
+                queued[static_cast<size_t>(c)] = 1;
+                rebuild.push_back(c);
+            }
+        };
+        const auto refresh = [&](int owner, int dir, int other)
+        {
+            const int border = owner * 2 + dir;
+            if (refreshed[static_cast<size_t>(border)])
+                return;
+            refreshed[static_cast<size_t>(border)] = 1;
+            if (RefreshBorder(owner, dir))
+            {
+                enqueue(owner);
+                enqueue(other);
+            }
+        };
+
+        for (const int c : m_dirty)
+        {
+            enqueue(c);
+            const int cx = c % m_clustersX;
+            const int cy = c / m_clustersX;
+            if (cx + 1 < m_clustersX)
+                refresh(c, 0, c + 1);
+            if (cy + 1 < m_clustersY)
+                refresh(c, 1, c + m_clustersX);
+            if (cx > 0)
+                refresh(c - 1, 0, c);
+            if (cy > 0)
+                refresh(c - m_clustersX, 1, c);
+        }
+
+        PathScratch s;
+        for (const int c : rebuild)
+            RebuildCluster(c, s);
+
+        for (const int c : m_dirty)
+            m_isDirty[static_cast<size_t>(c)] = 0;
+        m_dirty.clear();
+        return rebuild.size();
+    }
+
+    size_t PathGraph::EdgeCount() const
+    {
+        size_t edges = 0;
+        for (const Node& n : m_nodes)
+        {
+            if (n.cluster >= 0)
+                edges += n.edges.size() + 1;  // + the hop to its partner
+        }
+        return edges;
+    }
+
+    // ---------------------------------------------------------------------
+    // Queries
+    // ---------------------------------------------------------------------
+
+    int PathGraph::FindAbstractPath(TilePoint from, TilePoint to, PathScratch& s, std::vector<TilePoint>& waypoints) const
+    {
+        waypoints.clear();
+        const auto inside = [&](TilePoint p) { return p.x >= 0 && p.y >= 0 && p.x < m_width && p.y < m_height; };
+        if (!inside(from) || !inside(to) || !IsWalkable(from.x, from.y) || !IsWalkable(to.x, to.y))
+            return -1;
+        if (SameTile(from, to))
+        {
+            waypoints.push_back(from);
+            return 0;
+        }
+
+        // Abstract nodes, then the start and the goal
+        const int START = static_cast<int>(m_nodes.size());
+        const int GOAL = START + 1;
+        const size_t count = m_nodes.size() + 2;
+        if (s.g.size() < count)
+        {
+            s.g.resize(count);
+            s.parent.resize(count);
+            s.seen.resize(count, 0);
+            s.closed.resize(count, 0);
+            s.toGoal.resize(count, 0);
+            s.goalCost.resize(count);
+        }
+        if (++s.stamp == 0)
+        {
+            std::fill(s.seen.begin(), s.seen.end(), 0);
+            std::fill(s.closed.begin(), s.closed.end(), 0);
+            std::fill(s.toGoal.begin(), s.toGoal.end(), 0);
+            s.stamp = 1;
+        }
+        const uint32_t stamp = s.stamp;
+
+        const int C = m_clusterSize;
+        const auto localIndex = [&](TilePoint t, TilePoint origin)
+        {
+            return static_cast<size_t>((t.y - (origin.y / C) * C) * C + (t.x - (origin.x / C) * C));
+        };
+
+        // Wire the start into its cluster
+        const int startCluster = ClusterOf(from.x, from.y);
+        const int goalCluster = ClusterOf(to.x, to.y);
+        ClusterBfs(from, s.local, s.queue, nullptr, nullptr);
+        s.startEdges.clear();
+        for (const int id : m_clusterNodes[static_cast<size_t>(startCluster)])
+        {
+            const int d = s.local[localIndex(m_nodes[static_cast<size_t>(id)].tile, from)];
+            if (d >= 0)
+                s.startEdges.push_back({ id, d });
+        }
+        if (startCluster == goalCluster)
+        {
+            const int d = s.local[localIndex(to, from)];
+            if (d >= 0)
+                s.startEdges.push_back({ GOAL, d });
+        }
+
+        // ...and the goal into its own (distances are symmetric)
+        ClusterBfs(to, s.local, s.queue, nullptr, nullptr);
+        for (const int id : m_clusterNodes[static_cast<size_t>(goalCluster)])
+        {
+            const int d = s.local[localIndex(m_nodes[static_cast<size_t>(id)].tile, to)];
+            if (d >= 0)
+            {
+                s.toGoal[static_cast<size_t>(id)] = stamp;
+                s.goalCost[static_cast<size_t>(id)] = d;
+            }
+        }
+
+        const auto tileOf = [&](int n)
+        {
+            return (n == START) ? from : (n == GOAL) ? to : m_nodes[static_cast<size_t>(n)].tile;
+        };
+
+        s.heap.clear();
+        const auto relax = [&](int n, int m, int cost)
+        {
+            const int g = s.g[static_cast<size_t>(n)] + cost;
+            if (s.seen[static_cast<size_t>(m)] == stamp && s.g[static_cast<size_t>(m)] <= g)
+                return;
+            s.seen[static_cast<size_t>(m)] = stamp;
+            s.g[static_cast<size_t>(m)] = g;
+            s.parent[static_cast<size_t>(m)] = n;
+            s.heap.push_back({ HeapKey(g + Manhattan(tileOf(m), to), g), m });
+            std::push_heap(s.heap.begin(), s.heap.end(), std::greater<>());
+        };
+
+        s.seen[static_cast<size_t>(START)] = stamp;
+        s.g[static_cast<size_t>(START)] = 0;
+        s.parent[static_cast<size_t>(START)] = -1;
+        s.heap.push_back({ HeapKey(Manhattan(from, to), 0), START });
+
+        bool found = false;
+        while (!s.heap.empty())
+        {
+            std::pop_heap(s.heap.begin(), s.heap.end(), std::greater<>());
+            const int n = s.heap.back().second;
+            s.heap.pop_back();
+            if (s.closed[static_cast<size_t>(n)] == stamp)
+                continue;
+            s.closed[static_cast<size_t>(n)] = stamp;
+            if (n == GOAL)
+            {
+                found = true;
+                break;
+            }
+
+            if (n == START)
+            {
+                for (const auto& [m, cost] : s.startEdges)
+                    relax(n, m, cost);
+                continue;
+            }
+
+            const Node& node = m_nodes[static_cast<size_t>(n)];
+            for (const Edge& e : node.edges)
+                relax(n, e.to, e.cost);
+            relax(n, node.partner, 1);
+            if (s.toGoal[static_cast<size_t>(n)] == stamp)
+                relax(n, GOAL, s.goalCost[static_cast<size_t>(n)]);
+        }
+
+        if (!found)
+            return -1;
+
+        for (int n = GOAL; n >= 0; n = s.parent[static_cast<size_t>(n)])
+        {
+            const TilePoint t = tileOf(n);
+            if (waypoints.empty() || !SameTile(waypoints.back(), t))
+                waypoints.push_back(t);
+        }
+        std::reverse(waypoints.begin(), waypoints.end());
+        return s.g[static_cast<size_t>(GOAL)];
+    }
+
+    void PathGraph::Refine(const std::vector<TilePoint>& waypoints, PathScratch& s, std::vector<TilePoint>& path) const
+    {
+        path.clear();
+        if (waypoints.empty())
+            return;
+        path.push_back(waypoints.front());
+
+        // Consecutive waypoints are either a step apart (a border crossing)
+        // or in one cluster, joined by a path inside it
+        const int C = m_clusterSize;
+        for (size_t i = 1; i < waypoints.size(); ++i)
+        {
+            const TilePoint a = waypoints[i - 1];
+            const TilePoint b = waypoints[i];
+            if (Manhattan(a, b) <= 1)
+            {
+                path.push_back(b);
+                continue;
+            }
+
+            // Between two nodes: replay the shortest cached edge
+            const Edge* best = nullptr;
+            for (const int id : m_clusterNodes[static_cast<size_t>(ClusterOf(a.x, a.y))])
+            {
+                const Node& node = m_nodes[static_cast<size_t>(id)];
+                if (!SameTile(node.tile, a))
+                    continue;
+                for (const Edge& e : node.edges)
+                {
+                    if (SameTile(m_nodes[static_cast<size_t>(e.to)].tile, b) && (!best || e.cost < best->cost))
+                        best = &e;
+                }
+            }
+            if (best)
+            {
+                const uint8_t* steps = m_clusterPaths[static_cast<size_t>(ClusterOf(a.x, a.y))].data() + best->path;
+                TilePoint t = a;
+                for (int k = 0; k < best->cost; ++k)
+                {
+                    t.x += STEP_DX[steps[k]];
+                    t.y += STEP_DY[steps[k]];
+                    path.push_back(t);
+                }
+                continue;
+            }
+
+            // From the start or to the goal: search the cluster
+            ClusterBfs(a, s.local, s.queue, &s.localParent, &b);
+            const int x0 = (a.x / C) * C;
+            const int y0 = (a.y / C) * C;
+            const int start = (a.y - y0) * C + (a.x - x0);
+            const size_t first = path.size();
+            for (int cur = (b.y - y0) * C + (b.x - x0); cur != start; cur = s.localParent[static_cast<size_t>(cur)])
+                path.push_back({ x0 + cur % C, y0 + cur / C });
+            std::reverse(path.begin() + static_cast<std::ptrdiff_t>(first), path.end());
+        }
+    }
+
+    int PathGraph::FindPath(TilePoint from, TilePoint to, PathScratch& s, std::vector<TilePoint>& path) const
+    {
+        const int cost = FindAbstractPath(from, to, s, s.waypoints);
+        if (cost < 0)
+        {
+            path.clear();
+            return -1;
+        }
+        Refine(s.waypoints, s, path);
+        return cost;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include "world/Tiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    class TileVolume;
+
+    struct TilePoint
+    {
+        int x = 0;
+        int y = 0;
+    };
+
+    // Tiles invaders can stand on: Floor, Core and Spawner
+    bool Walkable(TileType type);
+
+    // Per-thread search buffers for PathGraph queries; reuse one per thread
+    struct PathScratch
+    {
+        std::vector<int> g;
+        std::vector<int> parent;
+        std::vector<uint32_t> seen;      // stamp: g/parent valid
+        std::vector<uint32_t> closed;    // stamp: expanded
+        std::vector<uint32_t> toGoal;    // stamp: goalCost valid
+        std::vector<int> goalCost;
+        std::vector<std::pair<int64_t, int>> heap;  // (f, -g) key, node
+        std::vector<std::pair<int, int>> startEdges; // (node, cost)
+        std::vector<int> local;          // cluster-sized BFS distances
+        std::vector<int> localParent;
+        std::vector<int> queue;
+        std::vector<TilePoint> waypoints;  // FindPath's abstract path
+        uint32_t stamp = 0;
+    };
+
+    // Hierarchical pathfinding (HPA*) over one dungeon level, 4-connected,
+    // unit step cost.
+    //
+    // The level is cut into square clusters. Where two neighbouring clusters
+    // have a run of open tiles on both sides of their border, the run gets
+    // one transition (two at its ends when it is 6 or more tiles long): a
+    // pair of abstract nodes, one per side, a step apart. Each cluster links
+    // its nodes with their in-cluster distances. Queries run A* over that
+    // cached graph, with the start and goal wired into their clusters by a
+    // breadth-first search of the cluster alone, then refine each abstract
+    // step into tiles inside one cluster: node-to-node steps replay the
+    // tile path cached with the edge, only the start and goal legs search.
+    //
+    // SetWalkable only marks the tile's cluster dirty. Repair() recomputes
+    // the transitions on the dirty clusters' borders and the in-cluster
+    // edges of the dirty clusters, plus those of neighbours whose shared
+    // transitions moved. The graph it leaves is the one Rebuild() would
+    // build. SetWalkable, Repair and Rebuild are not thread-safe; queries
+    // are, each thread with its own PathScratch, while nothing is dirty.
+    class PathGraph
+    {
+    public:
+        PathGraph(int width, int height, int clusterSize = 32);
+
+        // Copies the walkability of level `z` and rebuilds the graph
+        void LoadLevel(const TileVolume& volume, int z, ThreadPool& pool);
+        void Rebuild(ThreadPool& pool);
+
+        void SetWalkable(int x, int y, bool walkable);
+        bool IsWalkable(int x, int y) const { return m_walk[static_cast<size_t>(y) * m_width + x] != 0; }
+
+        // Brings the graph up to date; returns the clusters whose edges were rebuilt
+        size_t Repair();
+        bool Dirty() const { return !m_dirty.empty(); }
+
+        // Abstract path: start, transition tiles, goal. Returns its length in
+        // steps, or -1 if the goal is unreachable.
+        int FindAbstractPath(TilePoint from, TilePoint to, PathScratch& s, std::vector<TilePoint>& waypoints) const;
+
+        // Expands waypoints into every tile along the way, start included
+        void Refine(const std::vector<TilePoint>& waypoints, PathScratch& s, std::vector<TilePoint>& path) const;
+
+        // FindAbstractPath followed by Refine
+        int FindPath(TilePoint from, TilePoint to, PathScratch& s, std::vector<TilePoint>& path) const;
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+        int ClusterSize() const { return m_clusterSize; }
+        size_t NodeCount() const { return m_nodes.size() - m_freeNodes.size(); }
+        size_t EdgeCount() const;
+
+    private:
+        struct Edge
+        {
+            int to;
+            int cost;
+            uint32_t path;  // first of `cost` step codes in the cluster's path buffer
+        };
+
+        struct Node
+        {
+            TilePoint tile;
+            int cluster = -1;  // -1 while on the free list
+            int partner = -1;  // the node across the border
+            std::vector<Edge> edges;
+        };
+
+        int ClusterOf(int x, int y) const { return (y / m_clusterSize) * m_clustersX + x / m_clusterSize; }
+        int BorderCount() const { return m_clustersX * m_clustersY * 2; }
+
+        // Open tiles on cluster c's side of its east (dir 0) or south (dir 1)
+        // border where a transition goes
+        void Transitions(int c, int dir, std::vector<TilePoint>& out) const;
+
+        // Replaces the border's nodes if its transitions moved; returns
+        // whether they did
+        bool RefreshBorder(int c, int dir);
+        void ClearBorder(int border);
+        int NewNode(TilePoint tile, int cluster);
+
+        void RebuildCluster(int c, PathScratch& s);
+
+        // BFS restricted to the cluster holding `from`; distances land in
+        // `dist` (cluster-local, -1 where unreached). Stops early once `stop`
+        // (if given) is reached.
+        void ClusterBfs(TilePoint from, std::vector<int>& dist, std::vector<int>& queue, std::vector<int>* parent,
+            const TilePoint* stop) const;
+
+        int m_width;
+        int m_height;
+        int m_clusterSize;
+        int m_clustersX;
+        int m_clustersY;
+
+        std::vector<uint8_t> m_walk;
+        std::vector<Node> m_nodes;
+        std::vector<int> m_freeNodes;
+        std::vector<std::vector<int>> m_borders;       // per (cluster, dir): node pairs, this side first
+        std::vector<std::vector<int>> m_clusterNodes;  // per cluster
+        std::vector<std::vector<uint8_t>> m_clusterPaths;  // per cluster: edge paths, one step code per tile
+        std::vector<int> m_dirty;                      // clusters, unordered
+        std::vector<uint8_t> m_isDirty;
+    };
+}
@@ -0,0 +1,292 @@
+#include "world/SitePlacement.h"
+#include "core/Random.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Minimum spacing per siteDensity setting, in map pixels; the spacing on
+    // poor ground is RADIUS_SPREAD times that
+    const float DENSITY_TO_MIN_RADIUS[5] = { 24.0f, 18.0f, 13.0f, 9.0f, 6.0f };
+    constexpr float RADIUS_SPREAD = 2.5f;
+    constexpr float MAX_RADIUS_RATIO = 4.0f;
+
+    // Tiles are at least this wide (and at least maxRadius), so there are
+    // few enough of them for the per-tile setup not to matter
+    constexpr float MIN_TILE_PX = 64.0f;
+
+    // Initial darts per tile, as a multiple of attempts
+    constexpr int DART_FACTOR = 2;
+
+    // Suitability shaping
+    constexpr float HEIGHT_PENALTY = 0.8f;   // per unit of (height above sea) / (mountain - sea)
+    constexpr float SLOPE_PENALTY = 20.0f;   // per unit of gradient / (mountain - sea)
+    constexpr float MIN_LAND_SUITABILITY = 0.05f;
+
+    // Kinds by suitability at the site
+    constexpr float CITY_SUITABILITY = 0.6f;
+    constexpr float DUNGEON_SUITABILITY = 0.25f;
+
+    struct Rng
+    {
+        uint64_t state;
+
+        float Uniform()
+        {
+            state = SplitMix64(state);
+            return static_cast<float>(state >> 40) * (1.0f / 16777216.0f);
+        }
+    };
+
+    // Background grid, one site per cell at most (cell diagonal = minRadius)
+    struct SiteGrid
+    {
+        int w = 0;
+        int h = 0;
+        float cell = 1.0f;
+        int reach = 1;  // cells to search around a candidate: ceil(maxRadius / cell)
+        std::vector<float> x;  // NaN where empty
+        std::vector<float> y;
+        std::vector<float> r;
+
+        bool Fits(float px, float py, float pr) const
+        {
+            const int cx = static_cast<int>(px / cell);
+            const int cy = static_cast<int>(py / cell);
+
+            // A taken cell is always too close (its diagonal is minRadius);
+            // most rejected candidates stop here
+            if (!std::isnan(x[static_cast<size_t>(cy) * w + cx]))
+                return false;
+
+            const int x0 = std::max(cx - reach, 0), x1 = std::min(cx + reach, w - 1);
+            const int y0 = std::max(cy - reach, 0), y1 = std::min(cy + reach, h - 1);
+
+            for (int gy = y0; gy <= y1; ++gy)
+            {
+                const size_t row = static_cast<size_t>(gy) * w;
+                for (int gx = x0; gx <= x1; ++gx)
+                {
+                    const size_t i = row + gx;
+                    if (std::isnan(x[i]))
+                        continue;
+
+                    const float dx = x[i] - px;
+                    const float dy = y[i] - py;
+                    const float need = std::max(pr, r[i]);
+                    if (dx * dx + dy * dy < need * need)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        void Put(float px, float py, float pr)
+        {
+            const size_t i = static_cast<size_t>(static_cast<int>(py / cell)) * w + static_cast<int>(px / cell);
+            x[i] = px;
+            y[i] = py;
+            r[i] = pr;
+        }
+    };
+
+    struct Tile
+    {
+        float x0, y0, x1, y1;  // pixel bounds, [x0, x1) x [y0, y1)
+        uint64_t key;
+        std::vector<world::SitePoint> sites;
+    };
+
+    void FillTile(Tile& tile, SiteGrid& grid, const float* suitability, int w, int h,
+        const world::SitePlacementParams& p)
+    {
+        Rng rng{ tile.key };
+        const float span = p.maxRadius - p.minRadius;
+
+        const auto suit = [&](float x, float y)
+        {
+            const int ix = std::min(static_cast<int>(x), w - 1);
+            const int iy = std::min(static_cast<int>(y), h - 1);
+            return suitability[static_cast<size_t>(iy) * w + ix];
+        };
+
+        // Sites stay inside the tile; the grid cells they land in may lie one
+        // cell over the edge, which the tile size leaves room for
+        const auto inside = [&](float x, float y) { return x >= tile.x0 && x < tile.x1 && y >= tile.y0 && y < tile.y1; };
+
+        std::vector<uint32_t> active;
+        const auto tryAdd = [&](float x, float y)
+        {
+            if (!inside(x, y))
+                return false;
+
+            const float s = suit(x, y);
+            if (s <= 0.0f)
+                return false;
+
+            const float r = p.maxRadius - span * std::min(s, 1.0f);
+            if (!grid.Fits(x, y, r))
+                return false;
+
+            grid.Put(x, y, r);
+            world::SitePoint site;
+            site.x = x;
+            site.y = y;
+            site.radius = r;
+            site.kind = (s >= CITY_SUITABILITY) ? world::SiteKind::City
+                : (s < DUNGEON_SUITABILITY) ? world::SiteKind::Dungeon : world::SiteKind::Lair;
+            active.push_back(static_cast<uint32_t>(tile.sites.size()));
+            tile.sites.push_back(site);
+            return true;
+        };
+
+        const float tw = tile.x1 - tile.x0;
+        const float th = tile.y1 - tile.y0;
+        for (int d = 0; d < DART_FACTOR * p.attempts; ++d)
+            tryAdd(tile.x0 + rng.Uniform() * tw, tile.y0 + rng.Uniform() * th);
+
+        while (!active.empty())
+        {
+            const size_t k = std::min(static_cast<size_t>(rng.Uniform() * active.size()), active.size() - 1);
+            const world::SitePoint from = tile.sites[active[k]];
+
+            bool placed = false;
+            for (int a = 0; a < p.attempts && !placed; ++a)
+            {
+                // Uniform over the annulus [r, 2r) by area
+                const float u = rng.Uniform();
+                const float dist = from.radius * std::sqrt(1.0f + 3.0f * u);
+                const float angle = rng.Uniform() * 6.2831853f;
+                placed = tryAdd(from.x + std::cos(angle) * dist, from.y + std::sin(angle) * dist);
+            }
+
+            if (!placed)
+            {
+                active[k] = active.back();
+                active.pop_back();
+            }
+        }
+    }
+}
+
+namespace world
+{
+    const char* SiteKindName(SiteKind kind)
+    {
+        switch (kind)
+        {
+        case SiteKind::City: return "city";
+        case SiteKind::Lair: return "lair";
+        case SiteKind::Dungeon: return "dungeon";
+        }
+        return "?";
+    }
+
+    SitePlacementParams WorldSiteParams(const WorldGenSettings& settings, uint32_t seed)
+    {
+        SitePlacementParams p;
+        p.minRadius = DENSITY_TO_MIN_RADIUS[std::clamp(settings.siteDensity, 0, 4)];
+        p.maxRadius = p.minRadius * RADIUS_SPREAD;
+        p.seed = seed;
+        return p;
+    }
+
+    void SiteSuitability(const float* elevation, int w, int h, const BiomeClimate& climate, float* out,
+        ThreadPool& pool)
+    {
+        const float relief = std::max(climate.mountainLevel - climate.seaLevel, 1e-6f);
+
+        pool.ParallelFor(h, [&](int y)
+        {
+            const float* row = elevation + static_cast<size_t>(y) * w;
+            const float* up = elevation + static_cast<size_t>(std::max(y - 1, 0)) * w;
+            const float* down = elevation + static_cast<size_t>(std::min(y + 1, h - 1)) * w;
+            float* dst = out + static_cast<size_t>(y) * w;
+
+            for (int x = 0; x < w; ++x)
+            {
+                const float e = row[x];
+                if (e < climate.seaLevel)
+                {
+                    dst[x] = 0.0f;
+                    continue;
+                }
+
+                const float gx = 0.5f * (row[std::min(x + 1, w - 1)] - row[std::max(x - 1, 0)]);
+                const float gy = 0.5f * (down[x] - up[x]);
+                const float slope = std::sqrt(gx * gx + gy * gy) / relief;
+                const float height = (e - climate.seaLevel) / relief;
+
+                dst[x] = std::clamp(1.0f - HEIGHT_PENALTY * height - SLOPE_PENALTY * slope, MIN_LAND_SUITABILITY, 1.0f);
+            }
+        });
+    }
+
+    std::vector<SitePoint> PlaceSites(const float* suitability, int w, int h, const SitePlacementParams& params,
+        ThreadPool& pool)
+    {
+        if (w <= 0 || h <= 0)
+            return {};
+
+        SitePlacementParams p = params;
+        p.minRadius = std::max(p.minRadius, 1.0f);
+        p.maxRadius = std::clamp(p.maxRadius, p.minRadius, p.minRadius * MAX_RADIUS_RATIO);
+        p.attempts = std::max(p.attempts, 1);
+
+        SiteGrid grid;
+        grid.cell = p.minRadius / std::sqrt(2.0f);
+        grid.reach = static_cast<int>(std::ceil(p.maxRadius / grid.cell));
+        grid.w = static_cast<int>(std::ceil(w / grid.cell));
+        grid.h = static_cast<int>(std::ceil(h / grid.cell));
+        const size_t cells = static_cast<size_t>(grid.w) * grid.h;
+        grid.x.assign(cells, std::numeric_limits<float>::quiet_NaN());
+        grid.y.assign(cells, 0.0f);
+        grid.r.assign(cells, 0.0f);
+
+        // A whole number of cells per tile, wider than the search reach plus a
+        // cell of rounding slack, so tiles of one phase (a tile apart) never
+        // read or write each other's cells
+        const int tileCells = std::max(grid.reach + 2, static_cast<int>(std::ceil(MIN_TILE_PX / grid.cell)));
+        const float tilePx = tileCells * grid.cell;
+        const int tilesX = (grid.w + tileCells - 1) / tileCells;
+        const int tilesY = (grid.h + tileCells - 1) / tileCells;
+
+        std::vector<Tile> tiles(static_cast<size_t>(tilesX) * tilesY);
+        std::vector<int> phases[4];
+        for (int ty = 0; ty < tilesY; ++ty)
+        {
+            for (int tx = 0; tx < tilesX; ++tx)
+            {
+                const int t = ty * tilesX + tx;
+                Tile& tile = tiles[static_cast<size_t>(t)];
+                tile.x0 = tx * tilePx;
+                tile.y0 = ty * tilePx;
+                tile.x1 = std::min((tx + 1) * tilePx, static_cast<float>(w));
+                tile.y1 = std::min((ty + 1) * tilePx, static_cast<float>(h));
+                tile.key = SplitMix64((static_cast<uint64_t>(p.seed) << 32) | static_cast<uint32_t>(t));
+                phases[(ty & 1) * 2 + (tx & 1)].push_back(t);
+            }
+        }
+
+        for (const std::vector<int>& phase : phases)
+        {
+            pool.ParallelFor(static_cast<int>(phase.size()), [&](int i)
+            {
+                FillTile(tiles[static_cast<size_t>(phase[static_cast<size_t>(i)])], grid, suitability, w, h, p);
+            });
+        }
+
+        size_t total = 0;
+        for (const Tile& t : tiles)
+            total += t.sites.size();
+
+        std::vector<SitePoint> sites;
+        sites.reserve(total);
+        for (const Tile& t : tiles)
+            sites.insert(sites.end(), t.sites.begin(), t.sites.end());
+        return sites;
+    }
+}
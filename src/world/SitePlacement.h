@@ -0,0 +1,60 @@
+#pragma once
+#include "world/Biome.h"
+#include "world/WorldGenSettings.h"
+
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    enum class SiteKind : uint8_t
+    {
+        City,     // fertile lowland
+        Lair,     // rough or remote ground
+        Dungeon,  // mountains and badlands
+    };
+
+    const char* SiteKindName(SiteKind kind);
+
+    struct SitePoint
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float radius = 0.0f;  // exclusion radius it was placed with
+        SiteKind kind = SiteKind::City;
+    };
+
+    struct SitePlacementParams
+    {
+        float    minRadius = 12.0f;  // spacing on the most suitable ground
+        float    maxRadius = 30.0f;  // spacing on the least suitable (at most 4x minRadius)
+        int      attempts = 30;      // Bridson candidates per active site
+        uint32_t seed = 1337;
+    };
+
+    // WorldGenSettings::siteDensity (0 = Scarce .. 4 = Excessive) sets the radii
+    SitePlacementParams WorldSiteParams(const WorldGenSettings& settings, uint32_t seed);
+
+    // How inviting each cell is for a settlement, 0 (never: sea) .. 1: falls
+    // with height above sea level and with slope. Mountains keep a little
+    // suitability so dungeons can appear there.
+    void SiteSuitability(const float* elevation, int w, int h, const BiomeClimate& climate, float* out,
+        ThreadPool& pool);
+
+    // Bridson Poisson-disk sampling with a radius that varies from maxRadius
+    // (suitability near 0) to minRadius (suitability 1); two sites are at
+    // least the larger of their radii apart. A background grid of
+    // minRadius / sqrt(2) cells, holding at most one site each, answers the
+    // distance checks.
+    //
+    // The map is cut into square tiles at least maxRadius wide and processed
+    // in four checkerboard phases: tiles of one phase are a whole tile apart,
+    // so their sites cannot conflict and the tiles run in parallel, each
+    // reading the sites that earlier phases left around it. Randomness comes
+    // from (seed, tile), and sites are returned in tile order, so the result
+    // is identical for any thread count.
+    std::vector<SitePoint> PlaceSites(const float* suitability, int w, int h, const SitePlacementParams& p,
+        ThreadPool& pool);
+}
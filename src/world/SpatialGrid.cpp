@@ -0,0 +1,142 @@
+#include "world/SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace world
+{
+    SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+        : m_cellSize(std::max(cellSize, 1e-3f)), m_invCell(1.0f / m_cellSize)
+    {
+        m_cellsX = std::max(1, static_cast<int>(std::ceil(width * m_invCell)));
+        m_cellsY = std::max(1, static_cast<int>(std::ceil(height * m_invCell)));
+        m_start.assign(static_cast<size_t>(m_cellsX) * m_cellsY + 1, 0);
+    }
+
+    int SpatialGrid::CellX(float x) const
+    {
+        return std::clamp(static_cast<int>(std::floor(x * m_invCell)), 0, m_cellsX - 1);
+    }
+
+    int SpatialGrid::CellY(float y) const
+    {
+        return std::clamp(static_cast<int>(std::floor(y * m_invCell)), 0, m_cellsY - 1);
+    }
+
+    void SpatialGrid::Build(const float* x, const float* y, size_t count)
+    {
+        const size_t cells = static_cast<size_t>(m_cellsX) * m_cellsY;
+        std::fill(m_start.begin(), m_start.end(), 0);
+        m_cellOf.resize(count);
+        m_ids.resize(count);
+        m_x.resize(count);
+        m_y.resize(count);
+
+        // Count into start[c + 1], then prefix-sum into cell starts
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t c = static_cast<uint32_t>(CellY(y[i]) * m_cellsX + CellX(x[i]));
+            m_cellOf[i] = c;
+            ++m_start[c + 1];
+        }
+        for (size_t c = 0; c < cells; ++c)
+            m_start[c + 1] += m_start[c];
+
+        // Scatter in input order, so each cell keeps its ids ascending; the
+        // starts are walked forward as cursors and shifted back afterwards
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t slot = m_start[m_cellOf[i]]++;
+            m_ids[slot] = static_cast<uint32_t>(i);
+            m_x[slot] = x[i];
+            m_y[slot] = y[i];
+        }
+        for (size_t c = cells; c > 0; --c)
+            m_start[c] = m_start[c - 1];
+        m_start[0] = 0;
+    }
+
+    void SpatialGrid::QueryRadius(float qx, float qy, float radius, std::vector<uint32_t>& out) const
+    {
+        out.clear();
+        ForEachInRadius(qx, qy, radius, [&](uint32_t id, float) { out.push_back(id); });
+    }
+
+    void SpatialGrid::Nearest(float qx, float qy, size_t k, std::vector<uint32_t>& out,
+        std::vector<std::pair<float, uint32_t>>& scratch) const
+    {
+        out.clear();
+        scratch.clear();
+        if (k == 0 || m_ids.empty())
+            return;
+
+        // Max-heap of the best k so far, keyed by squared distance
+        const auto consider = [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const float dx = m_x[i] - qx;
+                const float dy = m_y[i] - qy;
+                const float d2 = dx * dx + dy * dy;
+                if (scratch.size() < k)
+                {
+                    scratch.push_back({ d2, m_ids[i] });
+                    std::push_heap(scratch.begin(), scratch.end());
+                }
+                else if (d2 < scratch.front().first)
+                {
+                    std::pop_heap(scratch.begin(), scratch.end());
+                    scratch.back() = { d2, m_ids[i] };
+                    std::push_heap(scratch.begin(), scratch.end());
+                }
+            }
+        };
+        const auto span = [&](int cy, int xa, int xb)
+        {
+            if (cy < 0 || cy >= m_cellsY)
+                return;
+            xa = std::max(xa, 0);
+            xb = std::min(xb, m_cellsX - 1);
+            if (xa > xb)
+                return;
+            const size_t row = static_cast<size_t>(cy) * m_cellsX;
+            consider(m_start[row + xa], m_start[row + xb + 1]);
+        };
+
+        // Rings of cells around the query's cell, until the next ring is
+        // farther than the k-th best
+        const int cx = CellX(qx);
+        const int cy = CellY(qy);
+        const float margin = std::max(0.0f, std::min(std::min(qx - cx * m_cellSize, (cx + 1) * m_cellSize - qx),
+            std::min(qy - cy * m_cellSize, (cy + 1) * m_cellSize - qy)));
+        const int rings = std::max(std::max(cx, m_cellsX - 1 - cx), std::max(cy, m_cellsY - 1 - cy));
+
+        for (int r = 0; r <= rings; ++r)
+        {
+            if (r == 0)
+                span(cy, cx, cx);
+            else
+            {
+                span(cy - r, cx - r, cx + r);
+                span(cy + r, cx - r, cx + r);
+                for (int y = cy - r + 1; y <= cy + r - 1; ++y)
+                {
+                    span(y, cx - r, cx - r);
+                    span(y, cx + r, cx + r);
+                }
+            }
+
+            if (scratch.size() == k)
+            {
+                const float next = margin + r * m_cellSize;
+                if (next * next >= scratch.front().first)
+                    break;
+            }
+        }
+
+        std::sort_heap(scratch.begin(), scratch.end());
+        out.reserve(scratch.size());
+        for (const auto& [d2, id] : scratch)
+            out.push_back(id);
+    }
+}
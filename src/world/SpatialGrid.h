@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace world
+{
+    // Uniform grid over entity positions for radius and nearest-neighbour
+    // queries (combat, aggro, separation), rebuilt from scratch every tick.
+    //
+    // Build() is a counting sort: one pass counts entities per cell, a prefix
+    // sum turns the counts into cell starts, a second pass scatters ids and
+    // positions into cell order. Entities of a cell, and of consecutive cells
+    // in a row, are then contiguous, so a query walks a few short array
+    // slices. Cells should be about the usual query radius.
+    //
+    // Positions outside [0, width) x [0, height) go to the border cells.
+    // Queries are const and thread-safe.
+    class SpatialGrid
+    {
+    public:
+        SpatialGrid(float width, float height, float cellSize);
+
+        void Build(const float* x, const float* y, size_t count);
+
+        // Calls fn(id, distanceSquared) for every entity within `radius`
+        template <class Fn>
+        void ForEachInRadius(float qx, float qy, float radius, Fn&& fn) const;
+
+        // Ids within `radius`, in cell order
+        void QueryRadius(float qx, float qy, float radius, std::vector<uint32_t>& out) const;
+
+        // The k nearest ids (fewer if there are fewer entities), nearest
+        // first; `scratch` is reused between calls
+        void Nearest(float qx, float qy, size_t k, std::vector<uint32_t>& out,
+            std::vector<std::pair<float, uint32_t>>& scratch) const;
+
+        size_t Count() const { return m_ids.size(); }
+        int CellsX() const { return m_cellsX; }
+        int CellsY() const { return m_cellsY; }
+        float CellSize() const { return m_cellSize; }
+
+        // Cell-ordered data: entity ids and positions, and each cell's range
+        // [CellStart(c), CellStart(c + 1))
+        const std::vector<uint32_t>& Ids() const { return m_ids; }
+        const std::vector<float>& X() const { return m_x; }
+        const std::vector<float>& Y() const { return m_y; }
+        uint32_t CellStart(int cell) const { return m_start[static_cast<size_t>(cell)]; }
+
+    private:
+        int CellX(float x) const;
+        int CellY(float y) const;
+
+        float m_cellSize;
+        float m_invCell;
+        int m_cellsX;
+        int m_cellsY;
+
+        std::vector<uint32_t> m_start;  // cells + 1
+        std::vector<uint32_t> m_ids;
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<uint32_t> m_cellOf;  // Build scratch, per input entity
+    };
+
+    template <class Fn>
+    void SpatialGrid::ForEachInRadius(float qx, float qy, float radius, Fn&& fn) const
+    {
+        const float r2 = radius * radius;
+        const int x0 = CellX(qx - radius);
+        const int x1 = CellX(qx + radius);
+        const int y0 = CellY(qy - radius);
+        const int y1 = CellY(qy + radius);
+        for (int cy = y0; cy <= y1; ++cy)
+        {
+            // A row of cells is one contiguous slice
+            const size_t row = static_cast<size_t>(cy) * m_cellsX;
+            const uint32_t begin = m_start[row + x0];
+            const uint32_t end = m_start[row + x1 + 1];
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const float dx = m_x[i] - qx;
+                const float dy = m_y[i] - qy;
+                const float d2 = dx * dx + dy * dy;
+                if (d2 <= r2)
+                    fn(m_ids[i], d2);
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include "world/TagIndex.h"
+#include "core/Random.h"
+
+namespace world
+{
+    size_t TagIndex::SetHash::operator()(const TagSet& s) const
+    {
+        uint64_t h = 0;
+        for (uint64_t w : s.words)
+            h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+
+    uint32_t TagIndex::Add(const TagId* tags, size_t count)
+    {
+        TagSet set;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (tags[i] < MaxIndexedTags)
+                set.Set(tags[i]);
+        }
+
+        const uint32_t id = static_cast<uint32_t>(m_sets.size());
+        m_sets.push_back(set);
+
+        for (size_t q = 0; q < m_querySets.size(); ++q)
+        {
+            if (static_cast<QueryId>(q) != m_empty && set.Contains(m_querySets[q]))
+                m_lists[q].push_back(id);
+        }
+        return id;
+    }
+
+    TagIndex TagIndex::FromNames(const HistoryData& data)
+    {
+        TagIndex index;
+        index.m_sets.reserve(data.Names().size());
+        for (const HistoryName& n : data.Names())
+            index.Add(data.NameTags().data() + n.firstTag, n.tagCount);
+        return index;
+    }
+
+    TagIndex::QueryId TagIndex::Prepare(const TagSet& all)
+    {
+        if (const auto it = m_queries.find(all); it != m_queries.end())
+            return it->second;
+
+        std::vector<uint32_t> list;
+        for (size_t e = 0; e < m_sets.size(); ++e)
+        {
+            if (m_sets[e].Contains(all))
+                list.push_back(static_cast<uint32_t>(e));
+        }
+
+        const QueryId q = static_cast<QueryId>(m_lists.size());
+        m_lists.push_back(std::move(list));
+        m_querySets.push_back(all);
+        m_queries.emplace(all, q);
+        return q;
+    }
+
+    TagIndex::QueryId TagIndex::Prepare(const TagTable& tags, std::initializer_list<std::string_view> all)
+    {
+        TagSet set;
+        for (std::string_view name : all)
+        {
+            const TagId t = tags.Find(name);
+            if (t == NoTag || t >= MaxIndexedTags)
+            {
+                if (m_empty == NoQuery)
+                {
+                    m_empty = static_cast<QueryId>(m_lists.size());
+                    m_lists.emplace_back();
+                    m_querySets.emplace_back();
+                }
+                return m_empty;
+            }
+            set.Set(t);
+        }
+        return Prepare(set);
+    }
+
+    int64_t TagIndex::Sample(QueryId q, uint64_t key) const
+    {
+        const std::vector<uint32_t>& list = m_lists[static_cast<size_t>(q)];
+        if (list.empty())
+            return -1;
+
+        const uint64_t x = SplitMix64(key);
+
+        // Multiply-shift instead of a modulo
+        return list[static_cast<size_t>(((x >> 32) * list.size()) >> 32)];
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "world/HistoryData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace world
+{
+    // Tag membership of one entry, one bit per TagId
+    constexpr int MaxIndexedTags = 128;
+
+    struct TagSet
+    {
+        uint64_t words[MaxIndexedTags / 64] = {};
+
+        void Set(TagId t) { words[t >> 6] |= uint64_t{ 1 } << (t & 63); }
+        bool Has(TagId t) const { return (words[t >> 6] >> (t & 63)) & 1u; }
+
+        // Every tag of `q` is also in this set
+        bool Contains(const TagSet& q) const
+        {
+            for (int w = 0; w < MaxIndexedTags / 64; ++w)
+            {
+                if ((words[w] & q.words[w]) != q.words[w])
+                    return false;
+            }
+            return true;
+        }
+
+        bool operator==(const TagSet& o) const
+        {
+            for (int w = 0; w < MaxIndexedTags / 64; ++w)
+            {
+                if (words[w] != o.words[w])
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // Entries (e.g. the [NAME] list) with their tags as fixed-width bitsets,
+    // for "a random elf female firstname" style sampling.
+    //
+    // Prepare() resolves a tag conjunction once: a linear pass over the
+    // bitsets collects the matching entry ids into a list, cached per
+    // conjunction. Sampling a prepared query is then one index into that
+    // list. Prepare is not thread-safe; Sample and Matches are, so queries
+    // are prepared up front and sampled from parallel code.
+    class TagIndex
+    {
+    public:
+        using QueryId = int;
+        static constexpr QueryId NoQuery = -1;
+
+        // Entries are added in order; returns the entry id. Tags at or above
+        // MaxIndexedTags are ignored. Prepared queries the entry matches get
+        // it appended, so their ids stay valid.
+        uint32_t Add(const TagId* tags, size_t count);
+
+        // One entry per HistoryData name, with entry id == name index
+        static TagIndex FromNames(const HistoryData& data);
+
+        // Cached query for entries carrying every tag in `all`. Tag names
+        // are looked up case-insensitively; a tag nobody has gives a query
+        // with no matches.
+        QueryId Prepare(const TagSet& all);
+        QueryId Prepare(const TagTable& tags, std::initializer_list<std::string_view> all);
+
+        const std::vector<uint32_t>& Matches(QueryId q) const { return m_lists[static_cast<size_t>(q)]; }
+
+        // A matching entry picked by `key` (same key, same entry), or -1 if
+        // nothing matches
+        int64_t Sample(QueryId q, uint64_t key) const;
+
+        size_t EntryCount() const { return m_sets.size(); }
+        size_t QueryCount() const { return m_lists.size(); }
+        const TagSet& Tags(uint32_t entry) const { return m_sets[entry]; }
+
+    private:
+        struct SetHash
+        {
+            size_t operator()(const TagSet& s) const;
+        };
+
+        std::vector<TagSet> m_sets;
+        std::vector<std::vector<uint32_t>> m_lists;
+        std::vector<TagSet> m_querySets;
+        std::unordered_map<TagSet, QueryId, SetHash> m_queries;
+        QueryId m_empty = NoQuery;  // shared by queries naming unknown tags
+    };
+}
@@ -0,0 +1,270 @@
+#include "world/Territory.h"
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Cell cost shaping, in units of (height above sea) / (mountain - sea)
+    // and gradient / (mountain - sea); the result is clamped to 1..16
+    constexpr float HEIGHT_COST = 6.0f;
+    constexpr float SLOPE_COST = 150.0f;
+    constexpr int MAX_CELL_COST = 16;
+
+    // Step weights: 7 / 5 is within 1% of sqrt(2)
+    constexpr uint32_t STRAIGHT_STEP = 5;
+    constexpr uint32_t DIAGONAL_STEP = 7;
+
+    // Every queued distance lies within one maximal step of the cursor, so
+    // this many circular buckets never alias
+    constexpr uint32_t BUCKETS = DIAGONAL_STEP * MAX_CELL_COST + 1;
+
+    const int NEIGHBOUR_DX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+    const int NEIGHBOUR_DY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+    const uint32_t NEIGHBOUR_STEP[8] = { STRAIGHT_STEP, STRAIGHT_STEP, STRAIGHT_STEP, STRAIGHT_STEP,
+        DIAGONAL_STEP, DIAGONAL_STEP, DIAGONAL_STEP, DIAGONAL_STEP };
+
+    // (dist, site) ordering that makes the labels unique
+    bool Better(uint32_t dist, int32_t site, uint32_t curDist, int32_t curSite)
+    {
+        return dist < curDist || (dist == curDist && static_cast<uint32_t>(site) < static_cast<uint32_t>(curSite));
+    }
+}
+
+namespace world
+{
+    void TerritoryCost(const float* elevation, int w, int h, const BiomeClimate& climate, uint8_t* out,
+        ThreadPool& pool)
+    {
+        const float relief = std::max(climate.mountainLevel - climate.seaLevel, 1e-6f);
+
+        pool.ParallelFor(h, [&](int y)
+        {
+            const float* row = elevation + static_cast<size_t>(y) * w;
+            const float* up = elevation + static_cast<size_t>(std::max(y - 1, 0)) * w;
+            const float* down = elevation + static_cast<size_t>(std::min(y + 1, h - 1)) * w;
+            uint8_t* dst = out + static_cast<size_t>(y) * w;
+
+            for (int x = 0; x < w; ++x)
+            {
+                const float e = row[x];
+                if (e < climate.seaLevel)
+                {
+                    dst[x] = 0;
+                    continue;
+                }
+
+                const float gx = 0.5f * (row[std::min(x + 1, w - 1)] - row[std::max(x - 1, 0)]);
+                const float gy = 0.5f * (down[x] - up[x]);
+                const float slope = std::sqrt(gx * gx + gy * gy) / relief;
+                const float height = (e - climate.seaLevel) / relief;
+
+                const float cost = 1.0f + HEIGHT_COST * height + SLOPE_COST * slope;
+                dst[x] = static_cast<uint8_t>(std::min(cost, static_cast<float>(MAX_CELL_COST)));
+            }
+        });
+    }
+
+    Territory::Territory(const uint8_t* cost, int w, int h, uint32_t maxDistance)
+        : m_cost(cost), m_w(w), m_h(h), m_maxDistance(maxDistance)
+    {
+        const size_t cells = static_cast<size_t>(w) * h;
+        m_site.assign(cells, -1);
+        m_dist.assign(cells, Unreached);
+        m_doneStamp.assign(cells, 0);
+        m_buckets.resize(BUCKETS);
+    }
+
+    void Territory::Compute()
+    {
+        std::fill(m_site.begin(), m_site.end(), -1);
+        std::fill(m_dist.begin(), m_dist.end(), Unreached);
+
+        std::vector<Seed> seeds;
+        for (size_t s = 0; s < m_siteCell.size(); ++s)
+        {
+            if (m_siteCell[s] >= 0)
+                seeds.push_back({ 0, static_cast<int32_t>(s), m_siteCell[s] });
+        }
+        Flood(seeds);
+    }
+
+    int Territory::AddSite(int x, int y)
+    {
+        const int32_t site = static_cast<int32_t>(m_siteCell.size());
+        const int32_t cell = std::clamp(y, 0, m_h - 1) * m_w + std::clamp(x, 0, m_w - 1);
+        m_siteCell.push_back(cell);
+
+        // The new site only takes cells it reaches more cheaply than their
+        // owner; the flood stops by itself at the new border
+        std::vector<Seed> seeds{ { 0, site, cell } };
+        Flood(seeds);
+        return site;
+    }
+
+    void Territory::RemoveSite(int site)
+    {
+        if (site < 0 || site >= static_cast<int>(m_siteCell.size()) || m_siteCell[static_cast<size_t>(site)] < 0)
+            return;
+
+        const int32_t start = m_siteCell[static_cast<size_t>(site)];
+        m_siteCell[static_cast<size_t>(site)] = -1;
+
+        // A site's cells hang off its own cell through its shortest-path tree,
+        // so they form one 8-connected region; clear it breadth-first
+        std::vector<int32_t> region;
+        if (m_site[static_cast<size_t>(start)] == site)
+        {
+            m_site[static_cast<size_t>(start)] = -1;
+            m_dist[static_cast<size_t>(start)] = Unreached;
+            region.push_back(start);
+        }
+
+        for (size_t i = 0; i < region.size(); ++i)
+        {
+            const int cx = region[i] % m_w;
+            const int cy = region[i] / m_w;
+            for (int k = 0; k < 8; ++k)
+            {
+                const int nx = cx + NEIGHBOUR_DX[k];
+                const int ny = cy + NEIGHBOUR_DY[k];
+                if (nx < 0 || ny < 0 || nx >= m_w || ny >= m_h)
+                    continue;
+
+                const size_t n = static_cast<size_t>(ny) * m_w + nx;
+                if (m_site[n] != site)
+                    continue;
+                m_site[n] = -1;
+                m_dist[n] = Unreached;
+                region.push_back(static_cast<int32_t>(n));
+            }
+        }
+
+        // Neighbouring territories flow back in from the region's border.
+        // Their labels are final, so they seed the flood as they are.
+        std::vector<Seed> seeds;
+        for (const int32_t c : region)
+        {
+            const int cx = c % m_w;
+            const int cy = c / m_w;
+            for (int k = 0; k < 8; ++k)
+            {
+                const int nx = cx + NEIGHBOUR_DX[k];
+                const int ny = cy + NEIGHBOUR_DY[k];
+                if (nx < 0 || ny < 0 || nx >= m_w || ny >= m_h)
+                    continue;
+
+                const size_t n = static_cast<size_t>(ny) * m_w + nx;
+                if (m_site[n] >= 0)
+                    seeds.push_back({ m_dist[n], m_site[n], static_cast<int32_t>(n) });
+            }
+        }
+
+        // Sites sharing a cell with the removed one lost it to the lower id;
+        // they start over from scratch
+        if (!region.empty())
+        {
+            for (size_t s = 0; s < m_siteCell.size(); ++s)
+            {
+                const int32_t c = m_siteCell[s];
+                if (c >= 0 && m_site[static_cast<size_t>(c)] < 0)
+                    seeds.push_back({ 0, static_cast<int32_t>(s), c });
+            }
+        }
+
+        Flood(seeds);
+    }
+
+    void Territory::Flood(std::vector<Seed>& seeds)
+    {
+        m_settled = 0;
+        if (seeds.empty())
+            return;
+
+        std::sort(seeds.begin(), seeds.end(), [](const Seed& a, const Seed& b)
+        {
+            return a.dist != b.dist ? a.dist < b.dist : a.site < b.site;
+        });
+
+        // A fresh stamp marks the cells settled by this flood; on wrap-around
+        // the stale stamps have to go
+        if (++m_stamp == 0)
+        {
+            std::fill(m_doneStamp.begin(), m_doneStamp.end(), 0);
+            m_stamp = 1;
+        }
+
+        // Dial's algorithm: buckets by distance modulo BUCKETS. Seeds join
+        // when the cursor reaches their distance; when the queue drains, the
+        // cursor jumps straight to the next seed.
+        size_t nextSeed = 0;
+        size_t queued = 0;
+        uint32_t cursor = seeds.front().dist;
+        for (;;)
+        {
+            std::vector<int32_t>& bucket = m_buckets[cursor % BUCKETS];
+
+            for (; nextSeed < seeds.size() && seeds[nextSeed].dist == cursor; ++nextSeed)
+            {
+                const Seed& s = seeds[nextSeed];
+                const size_t c = static_cast<size_t>(s.cell);
+                if (Better(s.dist, s.site, m_dist[c], m_site[c]))
+                {
+                    m_dist[c] = s.dist;
+                    m_site[c] = s.site;
+                }
+                if (m_dist[c] == s.dist && m_site[c] == s.site)
+                {
+                    bucket.push_back(s.cell);
+                    ++queued;
+                }
+            }
+
+            // Steps cost at least STRAIGHT_STEP, so nothing lands in this
+            // bucket while it is drained
+            for (const int32_t c : bucket)
+            {
+                const size_t cell = static_cast<size_t>(c);
+                if (m_dist[cell] != cursor || m_doneStamp[cell] == m_stamp)
+                    continue;  // superseded or already settled
+                m_doneStamp[cell] = m_stamp;
+                ++m_settled;
+
+                const int32_t site = m_site[cell];
+                const int cx = c % m_w;
+                const int cy = c / m_w;
+                for (int k = 0; k < 8; ++k)
+                {
+                    const int nx = cx + NEIGHBOUR_DX[k];
+                    const int ny = cy + NEIGHBOUR_DY[k];
+                    if (nx < 0 || ny < 0 || nx >= m_w || ny >= m_h)
+                        continue;
+
+                    const size_t n = static_cast<size_t>(ny) * m_w + nx;
+                    if (m_cost[n] == 0)
+                        continue;
+
+                    const uint32_t dist = cursor + NEIGHBOUR_STEP[k] * m_cost[n];
+                    if (dist > m_maxDistance || !Better(dist, site, m_dist[n], m_site[n]))
+                        continue;
+
+                    m_dist[n] = dist;
+                    m_site[n] = site;
+                    m_buckets[dist % BUCKETS].push_back(static_cast<int32_t>(n));
+                    ++queued;
+                }
+            }
+
+            queued -= bucket.size();
+            bucket.clear();
+
+            if (queued > 0)
+                ++cursor;
+            else if (nextSeed < seeds.size())
+                cursor = seeds[nextSeed].dist;
+            else
+                break;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "world/Biome.h"
+
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // Cost of crossing each cell for territory growth, 1 (open lowland) ..
+    // 16 (steep mountains); 0 marks the sea, which territory never crosses
+    void TerritoryCost(const float* elevation, int w, int h, const BiomeClimate& climate, uint8_t* out,
+        ThreadPool& pool);
+
+    // Per-cell ownership: every reachable cell belongs to the site with the
+    // cheapest path to it (8-neighbour steps of 5 * cost straight, 7 * cost
+    // diagonal), ties going to the lower site id. The owning civilization is
+    // then a lookup in the site table, so conquests need no recompute here.
+    //
+    // The labels are unique, so incremental updates give exactly what a full
+    // recompute would:
+    //  - AddSite floods out from the new site only as far as it wins cells;
+    //  - RemoveSite clears the removed site's cells (one connected region)
+    //    and lets the neighbouring territories flow back into it.
+    // Both run multi-source Dijkstra on a bucket queue (Dial's algorithm):
+    // integer step costs make it O(cells touched + max step).
+    class Territory
+    {
+    public:
+        static constexpr uint32_t Unreached = 0xFFFFFFFFu;
+
+        // `cost` must outlive the territory. Cells farther than maxDistance
+        // from every site stay unclaimed.
+        Territory(const uint8_t* cost, int w, int h, uint32_t maxDistance = Unreached);
+
+        // Full recompute over every site added so far and not removed
+        void Compute();
+
+        // Incremental updates; AddSite returns the new site's id
+        int AddSite(int x, int y);
+        void RemoveSite(int site);
+
+        int Width() const { return m_w; }
+        int Height() const { return m_h; }
+        int32_t Site(int x, int y) const { return m_site[static_cast<size_t>(y) * m_w + x]; }  // -1: unclaimed
+        uint32_t Distance(int x, int y) const { return m_dist[static_cast<size_t>(y) * m_w + x]; }
+        const std::vector<int32_t>& Sites() const { return m_site; }
+        const std::vector<uint32_t>& Distances() const { return m_dist; }
+
+        // Cells settled by the last Compute / AddSite / RemoveSite
+        size_t LastSettled() const { return m_settled; }
+
+    private:
+        struct Seed
+        {
+            uint32_t dist;
+            int32_t site;
+            int32_t cell;
+        };
+
+        // Dijkstra from `seeds` (any order), only improving on current labels
+        void Flood(std::vector<Seed>& seeds);
+
+        const uint8_t* m_cost;
+        int m_w;
+        int m_h;
+        uint32_t m_maxDistance;
+
+        std::vector<int32_t> m_siteCell;  // per site; -1 once removed
+        std::vector<int32_t> m_site;      // per cell
+        std::vector<uint32_t> m_dist;     // per cell
+
+        // Scratch kept between updates
+        std::vector<std::vector<int32_t>> m_buckets;
+        std::vector<uint32_t> m_doneStamp;
+        uint32_t m_stamp = 0;
+        size_t m_settled = 0;
+    };
+}
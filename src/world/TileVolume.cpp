@@ -0,0 +1,188 @@
+#include "world/TileVolume.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Narrowest index width for a palette; widths are 0, 1, 2, 4 or 8 so an
+    // index never straddles a word
+    uint8_t BitsFor(size_t paletteSize)
+    {
+        if (paletteSize <= 1)
+            return 0;
+        if (paletteSize <= 2)
+            return 1;
+        if (paletteSize <= 4)
+            return 2;
+        if (paletteSize <= 16)
+            return 4;
+        return 8;
+    }
+}
+
+namespace world
+{
+    TileVolume::TileVolume(int width, int height, int depth)
+        : m_width(std::max(width, 0)), m_height(std::max(height, 0)), m_depth(std::max(depth, 0))
+    {
+        m_chunksX = (m_width + ChunkEdge - 1) >> ChunkShift;
+        m_chunksY = (m_height + ChunkEdge - 1) >> ChunkShift;
+        m_chunksZ = (m_depth + ChunkEdge - 1) >> ChunkShift;
+        m_directory.assign(static_cast<size_t>(m_chunksX) * m_chunksY * m_chunksZ, NoChunk);
+    }
+
+    uint32_t TileVolume::ReadIndex(const Chunk& c, uint32_t tile)
+    {
+        if (c.bits == 0)
+            return 0;
+        const uint32_t bit = tile * c.bits;
+        return static_cast<uint32_t>(c.words[bit >> 6] >> (bit & 63)) & ((1u << c.bits) - 1);
+    }
+
+    void TileVolume::WriteIndex(Chunk& c, uint32_t tile, uint32_t index)
+    {
+        if (c.bits == 0)
+            return;
+        const uint32_t bit = tile * c.bits;
+        const uint64_t mask = ((uint64_t{ 1 } << c.bits) - 1) << (bit & 63);
+        uint64_t& word = c.words[bit >> 6];
+        word = (word & ~mask) | ((static_cast<uint64_t>(index) << (bit & 63)) & mask);
+    }
+
+    void TileVolume::Repack(Chunk& c, uint8_t bits, const uint8_t* remap)
+    {
+        // The new words start zeroed, so each index is OR-ed straight in;
+        // going from 0 bits every index is already 0
+        std::vector<uint64_t> words(static_cast<size_t>(ChunkTiles) * bits / 64, 0);
+        if (c.bits != 0 && bits != 0)
+        {
+            const uint64_t mask = (uint64_t{ 1 } << c.bits) - 1;
+            uint32_t to = 0;
+            for (uint64_t word : c.words)
+            {
+                for (int k = 0; k < 64; k += c.bits, word >>= c.bits, to += bits)
+                {
+                    const uint64_t index = remap ? remap[word & mask] : (word & mask);
+                    words[to >> 6] |= index << (to & 63);
+                }
+            }
+        }
+
+        c.words.swap(words);
+        c.bits = bits;
+    }
+
+    uint32_t TileVolume::Allocate()
+    {
+        uint32_t slot;
+        if (!m_free.empty())
+        {
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(m_chunks.size());
+            m_chunks.emplace_back();
+        }
+
+        Chunk& c = m_chunks[slot];
+        c.palette.assign(1, TileType::Rock);
+        c.uses.assign(1, static_cast<uint16_t>(ChunkTiles));
+        c.bits = 0;
+        c.nonRock = 0;
+        return slot;
+    }
+
+    void TileVolume::Release(size_t dirIndex)
+    {
+        const uint32_t slot = m_directory[dirIndex];
+        m_directory[dirIndex] = NoChunk;
+
+        // Give the memory back now; a freed slot is only a header
+        Chunk& c = m_chunks[slot];
+        std::vector<TileType>().swap(c.palette);
+        std::vector<uint16_t>().swap(c.uses);
+        std::vector<uint64_t>().swap(c.words);
+        m_free.push_back(slot);
+    }
+
+    void TileVolume::Set(int x, int y, int z, TileType type)
+    {
+        const size_t d = DirectoryIndex(x, y, z);
+        if (m_directory[d] == NoChunk)
+        {
+            if (type == TileType::Rock)
+                return;
+            m_directory[d] = Allocate();
+        }
+
+        Chunk& c = m_chunks[m_directory[d]];
+        const uint32_t tile = TileIndex(x, y, z);
+        const uint32_t oldIndex = ReadIndex(c, tile);
+        const TileType old = c.palette[oldIndex];
+        if (old == type)
+            return;
+
+        // Known type, else an entry nothing uses any more, else a new entry
+        uint32_t index = static_cast<uint32_t>(std::find(c.palette.begin(), c.palette.end(), type) - c.palette.begin());
+        if (index == c.palette.size())
+            index = static_cast<uint32_t>(std::find(c.uses.begin(), c.uses.end(), 0) - c.uses.begin());
+        if (index == c.palette.size())
+        {
+            if (c.palette.size() == (size_t{ 1 } << c.bits))
+                Repack(c, BitsFor(c.palette.size() + 1), nullptr);
+            c.palette.push_back(type);
+            c.uses.push_back(0);
+        }
+        c.palette[index] = type;
+        WriteIndex(c, tile, index);
+        --c.uses[oldIndex];
+        ++c.uses[index];
+
+        c.nonRock = static_cast<uint16_t>(c.nonRock + (type != TileType::Rock) - (old != TileType::Rock));
+        if (c.nonRock == 0)
+            Release(d);
+    }
+
+    void TileVolume::Compact()
+    {
+        for (size_t d = 0; d < m_directory.size(); ++d)
+        {
+            if (m_directory[d] == NoChunk)
+                continue;
+
+            Chunk& c = m_chunks[m_directory[d]];
+            uint8_t remap[256] = {};
+            std::vector<TileType> palette;
+            std::vector<uint16_t> uses;
+            for (size_t p = 0; p < c.palette.size(); ++p)
+            {
+                if (c.uses[p] == 0)
+                    continue;
+                remap[p] = static_cast<uint8_t>(palette.size());
+                palette.push_back(c.palette[p]);
+                uses.push_back(c.uses[p]);
+            }
+
+            if (palette.size() == c.palette.size() && BitsFor(palette.size()) == c.bits)
+                continue;  // nothing unused, already as narrow as it gets
+
+            palette.shrink_to_fit();
+            uses.shrink_to_fit();
+            c.palette.swap(palette);
+            c.uses.swap(uses);
+            Repack(c, BitsFor(c.palette.size()), remap);
+        }
+    }
+
+    size_t TileVolume::MemoryBytes() const
+    {
+        size_t bytes = m_directory.capacity() * sizeof(uint32_t) + m_chunks.capacity() * sizeof(Chunk)
+            + m_free.capacity() * sizeof(uint32_t);
+        for (const Chunk& c : m_chunks)
+            bytes += c.palette.capacity() * sizeof(TileType) + c.uses.capacity() * sizeof(uint16_t)
+                + c.words.capacity() * sizeof(uint64_t);
+        return bytes;
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "world/Tiles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace world
+{
+    // Dungeon tiles over many z-levels, in 16x16x16 chunks.
+    //
+    // Solid rock is the default: a chunk holding nothing else has no storage
+    // at all, just an empty slot in the chunk directory. An allocated chunk
+    // keeps a palette of the tile types it holds and a bit-packed index per
+    // tile, 0 bits (one type throughout), 1, 2, 4 or 8; indices never
+    // straddle a 64-bit word. A lookup is a directory read, one word read and
+    // a palette read.
+    //
+    // Set() widens a chunk's indices when its palette outgrows them, recycles
+    // palette entries whose last tile was overwritten and frees the chunk when
+    // its last non-rock tile is filled in. Indices never narrow by themselves;
+    // Compact() drops unused entries and narrows them.
+    class TileVolume
+    {
+    public:
+        static constexpr int ChunkShift = 4;
+        static constexpr int ChunkEdge = 1 << ChunkShift;
+        static constexpr int ChunkTiles = ChunkEdge * ChunkEdge * ChunkEdge;
+
+        TileVolume() = default;
+        TileVolume(int width, int height, int depth);
+
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+        int Depth() const { return m_depth; }
+
+        // Coordinates must be inside the volume
+        TileType Get(int x, int y, int z) const
+        {
+            const uint32_t slot = m_directory[DirectoryIndex(x, y, z)];
+            if (slot == NoChunk)
+                return TileType::Rock;
+
+            const Chunk& c = m_chunks[slot];
+            if (c.bits == 0)
+                return c.palette[0];
+
+            const uint32_t bit = TileIndex(x, y, z) * c.bits;
+            const uint32_t index = static_cast<uint32_t>(c.words[bit >> 6] >> (bit & 63)) & ((1u << c.bits) - 1);
+            return c.palette[index];
+        }
+
+        void Set(int x, int y, int z, TileType type);
+
+        // Drops unused palette entries and narrows indices to fit
+        void Compact();
+
+        size_t AllocatedChunks() const { return m_chunks.size() - m_free.size(); }
+        size_t ChunkSlots() const { return m_directory.size(); }
+
+        // Heap bytes held: directory, chunk headers, palettes and indices
+        size_t MemoryBytes() const;
+
+    private:
+        static constexpr uint32_t NoChunk = 0xFFFFFFFFu;
+
+        struct Chunk
+        {
+            std::vector<TileType> palette;
+            std::vector<uint16_t> uses;     // tiles per palette entry
+            std::vector<uint64_t> words;    // ChunkTiles * bits / 64
+            uint16_t nonRock = 0;
+            uint8_t bits = 0;
+        };
+
+        size_t DirectoryIndex(int x, int y, int z) const
+        {
+            return (static_cast<size_t>(z >> ChunkShift) * m_chunksY + static_cast<size_t>(y >> ChunkShift)) * m_chunksX
+                + static_cast<size_t>(x >> ChunkShift);
+        }
+
+        static uint32_t TileIndex(int x, int y, int z)
+        {
+            constexpr int mask = ChunkEdge - 1;
+            return (static_cast<uint32_t>(z & mask) << (2 * ChunkShift)) | (static_cast<uint32_t>(y & mask) << ChunkShift)
+                | static_cast<uint32_t>(x & mask);
+        }
+
+        static uint32_t ReadIndex(const Chunk& c, uint32_t tile);
+        static void WriteIndex(Chunk& c, uint32_t tile, uint32_t index);
+        // Re-encodes the indices at `bits` wide, passed through `remap` if given
+        static void Repack(Chunk& c, uint8_t bits, const uint8_t* remap);
+
+        uint32_t Allocate();
+        void Release(size_t dirIndex);
+
+        int m_width = 0;
+        int m_height = 0;
+        int m_depth = 0;
+        int m_chunksX = 0;
+        int m_chunksY = 0;
+        int m_chunksZ = 0;
+
+        std::vector<uint32_t> m_directory;  // chunk slot per chunk position, NoChunk where all rock
+        std::vector<Chunk> m_chunks;
+        std::vector<uint32_t> m_free;       // released chunk slots, reused first
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+enum class TileType : uint8_t
+{
+    Rock,
+    Floor,
+    Wall,
+    Core,
+    Spawner,
+};
+
+struct Tile
+{
+    TileType type = TileType::Rock;
+};
@@ -0,0 +1,541 @@
+#include "world/WorldFile.h"
+#include "core/Checksum.h"
+#include "core/Config.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    static_assert(std::endian::native == std::endian::little, "world files are read in place: little-endian only");
+
+    constexpr char MAGIC[8] = { 'D', 'D', 'W', 'O', 'R', 'L', 'D', '\0' };
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304u;
+    constexpr uint64_t SECTION_ALIGN = 4096;
+    constexpr uint32_t SAMPLE_F32 = 1;
+    constexpr uint32_t SAMPLE_U8 = 2;
+
+    struct FileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t byteOrder;
+        uint32_t sectionCount;
+        uint64_t tableOffset;
+        uint64_t fileSize;
+        uint32_t sectionAlign;
+        uint32_t tableCrc;      // CRC-32 of the section table
+        uint8_t  reserved[16];
+    };
+    static_assert(sizeof(FileHeader) == 64);
+
+    struct SectionEntry
+    {
+        uint32_t tag;
+        uint32_t flags;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t crc;           // CRC-32 of the `size` bytes at `offset`
+        uint32_t reserved;
+    };
+    static_assert(sizeof(SectionEntry) == 32);
+
+    // INFO section
+    struct InfoRecord
+    {
+        int32_t  worldSize;
+        int32_t  historyLength;
+        int32_t  civilizationSaturation;
+        int32_t  siteDensity;
+        int32_t  worldVolatility;
+        int32_t  resourceAbundance;
+        int32_t  monstrousPopulation;
+        uint32_t seed;
+        int32_t  width;
+        int32_t  height;
+        uint8_t  reserved[24];
+    };
+    static_assert(sizeof(InfoRecord) == 64);
+
+    // Start of every grid section, followed by a chunk index of
+    // chunksX * chunksY offsets (from the section start), then the chunks
+    struct GridHeader
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t chunkPx;
+        uint32_t chunksX;
+        uint32_t chunksY;
+        uint32_t sampleFormat;
+        uint64_t chunkBytes;
+        uint8_t  reserved[32];
+    };
+    static_assert(sizeof(GridHeader) == 64);
+
+    uint64_t AlignUp(uint64_t v, uint64_t a)
+    {
+        return (v + a - 1) / a * a;
+    }
+
+    // Appends to the output file while tracking the running section CRC
+    class SectionSink
+    {
+    public:
+        explicit SectionSink(std::ofstream& out) : m_out(out) {}
+
+        void Write(const void* data, size_t size)
+        {
+            m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            m_crc = Crc32(data, size, m_crc);
+            m_size += size;
+        }
+
+        void PadTo(uint64_t align)
+        {
+            static const uint8_t zeros[SECTION_ALIGN] = {};
+            uint64_t pad = AlignUp(m_size, align) - m_size;
+            while (pad > 0)
+            {
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(pad, sizeof(zeros)));
+                Write(zeros, n);
+                pad -= n;
+            }
+        }
+
+        uint32_t Crc() const { return m_crc; }
+        uint64_t Size() const { return m_size; }
+
+    private:
+        std::ofstream& m_out;
+        uint32_t m_crc = 0;
+        uint64_t m_size = 0;
+    };
+
+    void WriteInfo(SectionSink& sink, const world::WorldMap& map)
+    {
+        InfoRecord info{};
+        info.worldSize = map.settings.worldSize;
+        info.historyLength = map.settings.historyLength;
+        info.civilizationSaturation = map.settings.civilizationSaturation;
+        info.siteDensity = map.settings.siteDensity;
+        info.worldVolatility = map.settings.worldVolatility;
+        info.resourceAbundance = map.settings.resourceAbundance;
+        info.monstrousPopulation = map.settings.monstrousPopulation;
+        info.seed = map.seed;
+        info.width = map.width;
+        info.height = map.height;
+        sink.Write(&info, sizeof(info));
+    }
+
+    template <class T>
+    void WriteGrid(SectionSink& sink, const T* src, int w, int h, uint32_t sampleFormat)
+    {
+        constexpr int CHUNK = cfg::WorldFileChunkPx;
+
+        GridHeader gh{};
+        gh.width = static_cast<uint32_t>(w);
+        gh.height = static_cast<uint32_t>(h);
+        gh.chunkPx = CHUNK;
+        gh.chunksX = static_cast<uint32_t>((w + CHUNK - 1) / CHUNK);
+        gh.chunksY = static_cast<uint32_t>((h + CHUNK - 1) / CHUNK);
+        gh.sampleFormat = sampleFormat;
+        gh.chunkBytes = sizeof(T) * static_cast<uint64_t>(CHUNK) * CHUNK;
+
+        const size_t chunkCount = static_cast<size_t>(gh.chunksX) * gh.chunksY;
+        const uint64_t dataStart = AlignUp(sizeof(GridHeader) + sizeof(uint64_t) * chunkCount, SECTION_ALIGN);
+
+        std::vector<uint64_t> index(chunkCount);
+        for (size_t i = 0; i < chunkCount; ++i)
+            index[i] = dataStart + i * AlignUp(gh.chunkBytes, SECTION_ALIGN);
+
+        sink.Write(&gh, sizeof(gh));
+        sink.Write(index.data(), sizeof(uint64_t) * chunkCount);
+        sink.PadTo(SECTION_ALIGN);
+
+        std::vector<T> chunk(static_cast<size_t>(CHUNK) * CHUNK);
+        for (uint32_t cy = 0; cy < gh.chunksY; ++cy)
+        {
+            for (uint32_t cx = 0; cx < gh.chunksX; ++cx)
+            {
+                const int x0 = static_cast<int>(cx) * CHUNK;
+                const int y0 = static_cast<int>(cy) * CHUNK;
+                const int cw = std::min(CHUNK, w - x0);
+                const int ch = std::min(CHUNK, h - y0);
+
+                std::fill(chunk.begin(), chunk.end(), T{});
+                for (int y = 0; y < ch; ++y)
+                {
+                    std::memcpy(chunk.data() + static_cast<size_t>(y) * CHUNK,
+                        src + static_cast<size_t>(y0 + y) * w + x0, sizeof(T) * static_cast<size_t>(cw));
+                }
+
+                sink.Write(chunk.data(), gh.chunkBytes);
+                sink.PadTo(SECTION_ALIGN);
+            }
+        }
+    }
+}
+
+namespace world
+{
+    template <class T>
+    const T* GridViewOf<T>::Chunk(int cx, int cy) const
+    {
+        return reinterpret_cast<const T*>(m_section + m_index[static_cast<size_t>(cy) * m_chunksX + cx]);
+    }
+
+    template <class T>
+    T GridViewOf<T>::At(int x, int y) const
+    {
+        const T* c = Chunk(x / m_chunkPx, y / m_chunkPx);
+        return c[static_cast<size_t>(y % m_chunkPx) * m_chunkPx + (x % m_chunkPx)];
+    }
+
+    template <class T>
+    void GridViewOf<T>::CopyTo(T* dst) const
+    {
+        for (int cy = 0; cy < m_chunksY; ++cy)
+        {
+            for (int cx = 0; cx < m_chunksX; ++cx)
+            {
+                const T* c = Chunk(cx, cy);
+                const int x0 = cx * m_chunkPx;
+                const int y0 = cy * m_chunkPx;
+                const int cw = std::min(m_chunkPx, m_w - x0);
+                const int ch = std::min(m_chunkPx, m_h - y0);
+
+                for (int y = 0; y < ch; ++y)
+                {
+                    std::memcpy(dst + static_cast<size_t>(y0 + y) * m_w + x0,
+                        c + static_cast<size_t>(y) * m_chunkPx, sizeof(T) * static_cast<size_t>(cw));
+                }
+            }
+        }
+    }
+
+    template class GridViewOf<float>;
+    template class GridViewOf<uint8_t>;
+
+    bool WorldFile::Open(const std::string& path, std::string& error)
+    {
+        Close();
+
+        if (!m_file.Open(path, error))
+            return false;
+
+        const auto fail = [&](const std::string& why)
+        {
+            error = path + ": " + why;
+            Close();
+            return false;
+        };
+
+        const uint8_t* base = m_file.Data();
+        const uint64_t size = m_file.Size();
+
+        if (size < sizeof(FileHeader))
+            return fail("too small to be a world file");
+
+        FileHeader header;
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+            return fail("not a world file");
+        if (header.byteOrder != BYTE_ORDER_MARK)
+            return fail("unsupported byte order");
+        if (header.version == 0 || header.version > WorldFileVersion)
+            return fail("unsupported version " + std::to_string(header.version));
+        if (header.headerSize < sizeof(FileHeader) || header.fileSize != size)
+            return fail("truncated or corrupt header");
+
+        const uint64_t tableBytes = sizeof(SectionEntry) * static_cast<uint64_t>(header.sectionCount);
+        if (header.tableOffset > size || tableBytes > size - header.tableOffset)
+            return fail("section table out of range");
+        if (Crc32(base + header.tableOffset, static_cast<size_t>(tableBytes)) != header.tableCrc)
+            return fail("section table checksum mismatch");
+
+        m_sections.reserve(header.sectionCount);
+        for (uint32_t i = 0; i < header.sectionCount; ++i)
+        {
+            SectionEntry e;
+            std::memcpy(&e, base + header.tableOffset + i * sizeof(SectionEntry), sizeof(e));
+
+            if (e.offset > size || e.size > size - e.offset || e.offset % SECTION_ALIGN != 0)
+                return fail("section out of range");
+
+            m_sections.push_back(Section{ e.tag, e.offset, e.size, e.crc });
+        }
+
+        // INFO is tiny and needed for anything else, so it is always verified
+        const Section* info = FindSection(section::Info);
+        if (!info || info->size < sizeof(InfoRecord))
+            return fail("missing INFO section");
+        if (!VerifySection(section::Info))
+            return fail("INFO checksum mismatch");
+
+        InfoRecord rec;
+        std::memcpy(&rec, base + info->offset, sizeof(rec));
+
+        if (rec.width <= 0 || rec.height <= 0)
+            return fail("bad world dimensions");
+
+        m_version = header.version;
+        m_settings.worldSize = rec.worldSize;
+        m_settings.historyLength = rec.historyLength;
+        m_settings.civilizationSaturation = rec.civilizationSaturation;
+        m_settings.siteDensity = rec.siteDensity;
+        m_settings.worldVolatility = rec.worldVolatility;
+        m_settings.resourceAbundance = rec.resourceAbundance;
+        m_settings.monstrousPopulation = rec.monstrousPopulation;
+        m_seed = rec.seed;
+        m_width = rec.width;
+        m_height = rec.height;
+        return true;
+    }
+
+    void WorldFile::Close()
+    {
+        m_file.Close();
+        m_sections.clear();
+        m_version = 0;
+        m_settings = WorldGenSettings{};
+        m_seed = 0;
+        m_width = 0;
+        m_height = 0;
+    }
+
+    const WorldFile::Section* WorldFile::FindSection(uint32_t tag) const
+    {
+        for (const Section& s : m_sections)
+        {
+            if (s.tag == tag)
+                return &s;
+        }
+        return nullptr;
+    }
+
+    bool WorldFile::VerifySection(uint32_t tag) const
+    {
+        const Section* s = FindSection(tag);
+        return s && Crc32(m_file.Data() + s->offset, static_cast<size_t>(s->size)) == s->crc;
+    }
+
+    bool WorldFile::VerifyAll(std::string& error) const
+    {
+        for (const Section& s : m_sections)
+        {
+            if (Crc32(m_file.Data() + s.offset, static_cast<size_t>(s.size)) != s.crc)
+            {
+                const char name[5] = {
+                    static_cast<char>(s.tag & 0xFF), static_cast<char>((s.tag >> 8) & 0xFF),
+                    static_cast<char>((s.tag >> 16) & 0xFF), static_cast<char>(s.tag >> 24), '\0' };
+                error = std::string("checksum mismatch in section ") + name;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    GridView WorldFile::Grid(uint32_t tag) const
+    {
+        return GridOf<float>(tag, SAMPLE_F32);
+    }
+
+    ByteGridView WorldFile::ByteGrid(uint32_t tag) const
+    {
+        return GridOf<uint8_t>(tag, SAMPLE_U8);
+    }
+
+    template <class T>
+    GridViewOf<T> WorldFile::GridOf(uint32_t tag, uint32_t sampleFormat) const
+    {
+        GridViewOf<T> view;
+
+        const Section* s = FindSection(tag);
+        if (!s || s->size < sizeof(GridHeader))
+            return view;
+
+        const uint8_t* section = m_file.Data() + s->offset;
+
+        GridHeader gh;
+        std::memcpy(&gh, section, sizeof(gh));
+
+        if (gh.sampleFormat != sampleFormat || gh.chunkPx == 0 || gh.width == 0 || gh.height == 0
+            || gh.chunkBytes != sizeof(T) * static_cast<uint64_t>(gh.chunkPx) * gh.chunkPx
+            || gh.chunksX != (gh.width + gh.chunkPx - 1) / gh.chunkPx
+            || gh.chunksY != (gh.height + gh.chunkPx - 1) / gh.chunkPx)
+        {
+            return view;
+        }
+
+        const uint64_t chunkCount = static_cast<uint64_t>(gh.chunksX) * gh.chunksY;
+        if (sizeof(uint64_t) * chunkCount > s->size - sizeof(GridHeader))
+            return view;
+
+        // Sections are page-aligned in a page-aligned mapping, so the index
+        // (right after the 64-byte header) is 8-byte aligned
+        const auto* index = reinterpret_cast<const uint64_t*>(section + sizeof(GridHeader));
+        for (uint64_t i = 0; i < chunkCount; ++i)
+        {
+            if (index[i] % alignof(T) != 0 || index[i] > s->size || gh.chunkBytes > s->size - index[i])
+                return view;
+        }
+
+        view.m_section = section;
+        view.m_index = index;
+        view.m_w = static_cast<int>(gh.width);
+        view.m_h = static_cast<int>(gh.height);
+        view.m_chunkPx = static_cast<int>(gh.chunkPx);
+        view.m_chunksX = static_cast<int>(gh.chunksX);
+        view.m_chunksY = static_cast<int>(gh.chunksY);
+        return view;
+    }
+
+    bool WorldFile::Load(WorldMap& out, std::string& error) const
+    {
+        if (!IsOpen())
+        {
+            error = "no world file open";
+            return false;
+        }
+
+        const GridView elevation = Grid(section::Elevation);
+        if (!elevation.Valid() || elevation.Width() != m_width || elevation.Height() != m_height)
+        {
+            error = "missing or malformed elevation layer";
+            return false;
+        }
+
+        out.settings = m_settings;
+        out.seed = m_seed;
+        out.width = m_width;
+        out.height = m_height;
+        out.elevation.resize(static_cast<size_t>(m_width) * m_height);
+        elevation.CopyTo(out.elevation.data());
+
+        const auto loadOptional = [&](const auto& view, auto& layer)
+        {
+            layer.clear();
+            if (view.Valid() && view.Width() == m_width && view.Height() == m_height)
+            {
+                layer.resize(static_cast<size_t>(m_width) * m_height);
+                view.CopyTo(layer.data());
+            }
+        };
+
+        loadOptional(Grid(section::Temperature), out.temperature);
+        loadOptional(Grid(section::Moisture), out.moisture);
+        loadOptional(Grid(section::Volatility), out.volatility);
+        loadOptional(ByteGrid(section::Biome), out.biome);
+        loadOptional(Grid(section::Flow), out.flow);
+        return true;
+    }
+
+    bool SaveWorldFile(const std::string& path, const WorldMap& map, std::string& error)
+    {
+        if (map.width <= 0 || map.height <= 0
+            || map.elevation.size() != static_cast<size_t>(map.width) * map.height)
+        {
+            error = "world has no elevation data to save";
+            return false;
+        }
+
+        const std::string tmpPath = path + ".tmp";
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            error = "cannot create " + tmpPath;
+            return false;
+        }
+
+        // Placeholder header; rewritten once the table is known
+        FileHeader header{};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<SectionEntry> table;
+        uint64_t offset = sizeof(FileHeader);
+
+        const auto addSection = [&](uint32_t tag, auto&& writeBody)
+        {
+            const uint64_t start = AlignUp(offset, SECTION_ALIGN);
+            static const char zeros[SECTION_ALIGN] = {};
+            out.write(zeros, static_cast<std::streamsize>(start - offset));
+
+            SectionSink sink(out);
+            writeBody(sink);
+
+            SectionEntry e{};
+            e.tag = tag;
+            e.offset = start;
+            e.size = sink.Size();
+            e.crc = sink.Crc();
+            table.push_back(e);
+
+            offset = start + sink.Size();
+        };
+
+        addSection(section::Info, [&](SectionSink& s) { WriteInfo(s, map); });
+        addSection(section::Elevation, [&](SectionSink& s)
+        {
+            WriteGrid(s, map.elevation.data(), map.width, map.height, SAMPLE_F32);
+        });
+
+        // Optional layers, saved when present
+        const size_t cells = static_cast<size_t>(map.width) * map.height;
+        const auto addLayer = [&](uint32_t tag, const auto& layer, uint32_t sampleFormat)
+        {
+            if (layer.size() == cells)
+                addSection(tag, [&](SectionSink& s) { WriteGrid(s, layer.data(), map.width, map.height, sampleFormat); });
+        };
+
+        addLayer(section::Temperature, map.temperature, SAMPLE_F32);
+        addLayer(section::Moisture, map.moisture, SAMPLE_F32);
+        addLayer(section::Volatility, map.volatility, SAMPLE_F32);
+        addLayer(section::Biome, map.biome, SAMPLE_U8);
+        addLayer(section::Flow, map.flow, SAMPLE_F32);
+
+        const uint64_t tableOffset = AlignUp(offset, 8);
+        static const char zeros[8] = {};
+        out.write(zeros, static_cast<std::streamsize>(tableOffset - offset));
+
+        const size_t tableBytes = sizeof(SectionEntry) * table.size();
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(tableBytes));
+
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = WorldFileVersion;
+        header.headerSize = sizeof(FileHeader);
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.sectionCount = static_cast<uint32_t>(table.size());
+        header.tableOffset = tableOffset;
+        header.fileSize = tableOffset + tableBytes;
+        header.sectionAlign = static_cast<uint32_t>(SECTION_ALIGN);
+        header.tableCrc = Crc32(table.data(), tableBytes);
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+
+        if (!out)
+        {
+            error = "write to " + tmpPath + " failed";
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+        {
+            error = "cannot replace " + path + ": " + ec.message();
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+}
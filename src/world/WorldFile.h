@@ -0,0 +1,139 @@
+#pragma once
+#include "core/MappedFile.h"
+#include "world/WorldMap.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace world
+{
+    // World file layout (little-endian):
+    //
+    //   file header        64 bytes at offset 0: magic, version, section table location
+    //   sections           each starting on a 4 KB boundary
+    //   section table      one entry per section: tag, offset, size, CRC-32
+    //
+    // The header carries a CRC of the section table and every table entry a
+    // CRC of its section. Grid layers are stored as square chunks behind a
+    // chunk index, each chunk contiguous and page-aligned, so reading part of
+    // a mapped world only pages in the chunks it touches.
+    //
+    // Readers skip sections they don't know, so new layers can be added
+    // without a version bump; the version changes when existing sections do.
+    constexpr uint32_t WorldFileVersion = 1;
+
+    constexpr uint32_t SectionTag(const char (&name)[5])
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(name[0]))
+            | (static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(name[2])) << 16)
+            | (static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24);
+    }
+
+    namespace section
+    {
+        constexpr uint32_t Info = SectionTag("INFO");        // settings, seed, dimensions
+        constexpr uint32_t Elevation = SectionTag("ELEV");   // float grid
+        constexpr uint32_t Temperature = SectionTag("TEMP"); // float grid
+        constexpr uint32_t Moisture = SectionTag("MOIS");    // float grid
+        constexpr uint32_t Volatility = SectionTag("VOLA");  // float grid
+        constexpr uint32_t Biome = SectionTag("BIOM");       // byte grid of world::Biome values
+        constexpr uint32_t Flow = SectionTag("FLOW");        // float grid, upstream catchment in cells
+    }
+
+    // Zero-copy view of a chunked layer inside a mapped world file.
+    // Only valid while the WorldFile it came from stays open.
+    template <class T>
+    class GridViewOf
+    {
+    public:
+        bool Valid() const { return m_section != nullptr; }
+        int Width() const { return m_w; }
+        int Height() const { return m_h; }
+        int ChunkPx() const { return m_chunkPx; }
+        int ChunksX() const { return m_chunksX; }
+        int ChunksY() const { return m_chunksY; }
+
+        // ChunkPx() * ChunkPx() samples, row-major; edge chunks are zero-padded
+        const T* Chunk(int cx, int cy) const;
+
+        T At(int x, int y) const;
+
+        // Copies the layer into a Width() * Height() row-major buffer
+        void CopyTo(T* dst) const;
+
+    private:
+        friend class WorldFile;
+
+        const uint8_t* m_section = nullptr;
+        const uint64_t* m_index = nullptr; // chunk offsets from the section start
+        int m_w = 0;
+        int m_h = 0;
+        int m_chunkPx = 0;
+        int m_chunksX = 0;
+        int m_chunksY = 0;
+    };
+
+    using GridView = GridViewOf<float>;
+    using ByteGridView = GridViewOf<uint8_t>;
+
+    // A world file opened through mmap. Open() validates the header, the
+    // section table and the small INFO section; layer payloads are not read
+    // until used, so a large world opens in about the same time as a small one.
+    class WorldFile
+    {
+    public:
+        bool Open(const std::string& path, std::string& error);
+        void Close();
+        bool IsOpen() const { return m_file.IsOpen(); }
+
+        uint32_t Version() const { return m_version; }
+        const WorldGenSettings& Settings() const { return m_settings; }
+        uint32_t Seed() const { return m_seed; }
+        int Width() const { return m_width; }
+        int Height() const { return m_height; }
+
+        bool HasSection(uint32_t tag) const { return FindSection(tag) != nullptr; }
+
+        // Recomputes section CRCs; this touches every page of what it checks
+        bool VerifySection(uint32_t tag) const;
+        bool VerifyAll(std::string& error) const;
+
+        // Invalid view if the section is missing, malformed or of another sample type
+        GridView Grid(uint32_t tag) const;
+        ByteGridView ByteGrid(uint32_t tag) const;
+
+        // Copies every known layer into memory. Elevation is required; layers
+        // the file doesn't have (older worlds) are left empty.
+        bool Load(WorldMap& out, std::string& error) const;
+
+    private:
+        struct Section
+        {
+            uint32_t tag = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+            uint32_t crc = 0;
+        };
+
+        const Section* FindSection(uint32_t tag) const;
+
+        template <class T>
+        GridViewOf<T> GridOf(uint32_t tag, uint32_t sampleFormat) const;
+
+    private:
+        MappedFile m_file;
+        std::vector<Section> m_sections;
+
+        uint32_t m_version = 0;
+        WorldGenSettings m_settings{};
+        uint32_t m_seed = 0;
+        int m_width = 0;
+        int m_height = 0;
+    };
+
+    // Writes `map` to `path`. The file is written under a temporary name and
+    // renamed over `path` at the end, so a failed save never leaves a torn file.
+    bool SaveWorldFile(const std::string& path, const WorldMap& map, std::string& error);
+}
@@ -0,0 +1,131 @@
+#include "world/WorldForgeWorker.h"
+#include "world/WorldFile.h"
+#include "world/WorldGen.h"
+
+#include <chrono>
+#include <filesystem>
+#include <utility>
+
+namespace
+{
+    // Share of a forge spent generating; the rest is writing the file
+    constexpr float GENERATE_SHARE = 0.95f;
+}
+
+namespace world
+{
+    WorldForgeWorker::WorldForgeWorker(ThreadPool& pool)
+        : m_pool(pool)
+    {
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    WorldForgeWorker::~WorldForgeWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop.store(true);
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    bool WorldForgeWorker::Start(const WorldGenSettings& settings, uint32_t seed, const std::string& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pending || m_running || m_hasResult)
+                return false;
+
+            m_settings = settings;
+            m_seed = seed;
+            m_path = path;
+            m_pending = true;
+            m_progress = ForgeProgress{ "Starting", 0.0f };
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    bool WorldForgeWorker::Busy() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending || m_running;
+    }
+
+    ForgeProgress WorldForgeWorker::Progress() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_progress;
+    }
+
+    bool WorldForgeWorker::TakeResult(ForgeResult& out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasResult)
+            return false;
+
+        out = std::move(m_result);
+        m_hasResult = false;
+        return true;
+    }
+
+    void WorldForgeWorker::Run()
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return m_stop.load() || m_pending; });
+                if (m_stop.load())
+                    return;
+
+                m_pending = false;
+                m_running = true;
+            }
+
+            Forge();
+        }
+    }
+
+    void WorldForgeWorker::Forge()
+    {
+        WorldGenSettings settings;
+        ForgeResult result;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            settings = m_settings;
+            result.seed = m_seed;
+            result.path = m_path;
+        }
+
+        const auto setProgress = [this](const char* stage, float done)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_progress.stage = stage;
+            m_progress.done = done;
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        const WorldMap map = GenerateWorld(settings, result.seed, m_pool, [&](const char* stage, float done)
+        {
+            setProgress(stage, done * GENERATE_SHARE);
+        });
+        result.generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.width = map.width;
+        result.height = map.height;
+
+        setProgress("Saving", GENERATE_SHARE);
+        const std::filesystem::path path(result.path);
+        std::error_code ec;
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path(), ec);
+        result.saved = SaveWorldFile(result.path, map, result.error);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_progress = ForgeProgress{ "Done", 1.0f };
+        m_result = std::move(result);
+        m_hasResult = true;
+        m_running = false;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "world/WorldGenSettings.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class ThreadPool;
+
+namespace world
+{
+    // Outcome of one forge: the world was generated and saved, or why not
+    struct ForgeResult
+    {
+        bool saved = false;
+        std::string path;
+        std::string error;
+        int width = 0;
+        int height = 0;
+        uint32_t seed = 0;
+        double generateMs = 0.0;
+    };
+
+    struct ForgeProgress
+    {
+        std::string stage;
+        float done = 0.0f;  // 0..1
+    };
+
+    // Generates a world and writes it to a world file on a background thread,
+    // so the render loop keeps pumping events while erosion runs for seconds.
+    // The heavy stages still spread across the shared ThreadPool.
+    //
+    // One forge at a time. There is no cancellation: destroying the worker
+    // waits for the forge in flight.
+    class WorldForgeWorker
+    {
+    public:
+        explicit WorldForgeWorker(ThreadPool& pool);
+        ~WorldForgeWorker();
+
+        WorldForgeWorker(const WorldForgeWorker&) = delete;
+        WorldForgeWorker& operator=(const WorldForgeWorker&) = delete;
+
+        // False if a forge is already running or its result was not taken yet
+        bool Start(const WorldGenSettings& settings, uint32_t seed, const std::string& path);
+
+        // True from Start() until the forge has finished
+        bool Busy() const;
+        ForgeProgress Progress() const;
+
+        // Hands the finished forge to the caller. False if there is none.
+        bool TakeResult(ForgeResult& out);
+
+    private:
+        void Run();
+        void Forge();
+
+    private:
+        ThreadPool& m_pool;
+
+        // Shared, guarded by m_mutex
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        WorldGenSettings m_settings{};
+        uint32_t m_seed = 0;
+        std::string m_path;
+        bool m_pending = false;    // started, not picked up by the worker yet
+        bool m_running = false;
+        bool m_hasResult = false;
+        ForgeResult m_result;
+        ForgeProgress m_progress;
+
+        std::atomic<bool> m_stop{ false };
+
+        std::thread m_thread; // last: starts once everything above exists
+    };
+}
@@ -0,0 +1,140 @@
+#include "world/WorldGen.h"
+#include "core/ThreadPool.h"
+#include "world/Hydrology.h"
+
+#include <algorithm>
+
+namespace
+{
+    const int WORLD_SIZE_TO_RESOLUTION[5] = { 256, 384, 512, 640, 768 };
+
+    // Erosion droplets per map pixel for each volatility setting
+    const float VOLATILITY_TO_DROPLETS_PER_PX[5] = { 0.1f, 0.4f, 0.9f, 1.7f, 2.6f };
+
+    // Share of the map below each biome threshold
+    constexpr float SHELF_QUANTILE = 0.35f;
+    constexpr float SEA_QUANTILE = 0.55f;
+    constexpr float MOUNTAIN_QUANTILE = 0.93f;
+
+    // Share of GenerateWorld done when each stage starts, for progress reports
+    constexpr float PROGRESS_EROSION_START = 0.1f;
+    constexpr float PROGRESS_EROSION_END = 0.85f;
+    constexpr float PROGRESS_RIVERS = 0.9f;
+
+    world::NoiseParams LayerParams(uint32_t seed, float scale, int octaves)
+    {
+        world::NoiseParams p;
+        p.scale = scale;
+        p.octaves = octaves;
+        p.persistence = 0.5f;
+        p.lacunarity = 2.0f;
+        p.seed = seed;
+        return p;
+    }
+
+    float Quantile(std::vector<float>& v, float q)
+    {
+        const size_t k = std::min(v.size() - 1, static_cast<size_t>(q * static_cast<float>(v.size())));
+        std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+        return v[k];
+    }
+}
+
+namespace world
+{
+    int WorldResolution(int worldSize)
+    {
+        return WORLD_SIZE_TO_RESOLUTION[std::clamp(worldSize, 0, 4)];
+    }
+
+    NoiseParams ElevationParams(uint32_t seed)
+    {
+        return LayerParams(seed, 128.0f, 5);
+    }
+
+    // Each layer gets its own permutation stream
+    NoiseParams TemperatureParams(uint32_t seed)
+    {
+        return LayerParams(seed ^ 0x7E3B0001u, 512.0f, 3);
+    }
+
+    NoiseParams MoistureParams(uint32_t seed)
+    {
+        return LayerParams(seed ^ 0x3015E002u, 256.0f, 4);
+    }
+
+    NoiseParams VolatilityParams(uint32_t seed)
+    {
+        return LayerParams(seed ^ 0x7011A003u, 256.0f, 3);
+    }
+
+    BiomeClimate WorldClimate(const std::vector<float>& elevation)
+    {
+        BiomeClimate c;
+        if (elevation.empty())
+            return c;
+
+        std::vector<float> sorted = elevation;
+        c.shelfLevel = Quantile(sorted, SHELF_QUANTILE);
+        c.seaLevel = Quantile(sorted, SEA_QUANTILE);
+        c.mountainLevel = Quantile(sorted, MOUNTAIN_QUANTILE);
+        return c;
+    }
+
+    ErosionParams WorldErosionParams(const WorldGenSettings& settings, uint32_t seed, int w, int h)
+    {
+        const float perPx = VOLATILITY_TO_DROPLETS_PER_PX[std::clamp(settings.worldVolatility, 0, 4)];
+
+        ErosionParams p;
+        p.droplets = static_cast<int>(perPx * static_cast<float>(w) * static_cast<float>(h));
+        p.seed = seed ^ 0x5EED0E20u; // its own stream, independent of the noise permutation
+        return p;
+    }
+
+    WorldMap GenerateWorld(const WorldGenSettings& settings, uint32_t seed, ThreadPool& pool,
+        const WorldGenProgress& progress)
+    {
+        const auto report = [&](const char* stage, float done)
+        {
+            if (progress)
+                progress(stage, done);
+        };
+
+        WorldMap map;
+        map.settings = settings;
+        map.seed = seed;
+        map.width = WorldResolution(settings.worldSize);
+        map.height = map.width;
+
+        const size_t cells = static_cast<size_t>(map.width) * map.height;
+        map.elevation.resize(cells);
+        map.temperature.resize(cells);
+        map.moisture.resize(cells);
+        map.volatility.resize(cells);
+
+        const NoiseParams params[] = {
+            ElevationParams(seed), TemperatureParams(seed), MoistureParams(seed), VolatilityParams(seed) };
+        float* const fields[] = {
+            map.elevation.data(), map.temperature.data(), map.moisture.data(), map.volatility.data() };
+        report("Raising the land", 0.0f);
+        PerlinFbm2DMulti(fields, params, 4, map.width, map.height, pool);
+
+        report("Eroding", PROGRESS_EROSION_START);
+        ErodeHydraulic(map.elevation.data(), map.width, map.height,
+            WorldErosionParams(settings, seed, map.width, map.height), pool, [&](float done)
+        {
+            report("Eroding", PROGRESS_EROSION_START + done * (PROGRESS_EROSION_END - PROGRESS_EROSION_START));
+        });
+
+        report("Settling climates", PROGRESS_EROSION_END);
+        const BiomeClimate climate = WorldClimate(map.elevation);
+        map.biome.resize(cells);
+        ClassifyBiomes(map.elevation.data(), map.temperature.data(), map.moisture.data(), cells,
+            climate, map.biome.data(), pool);
+
+        report("Tracing rivers", PROGRESS_RIVERS);
+        map.flow = ComputeHydrology(map.elevation.data(), map.width, map.height, climate.seaLevel, pool).flow;
+        report("Done", 1.0f);
+        return map;
+    }
+}
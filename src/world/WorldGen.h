@@ -0,0 +1,43 @@
+#pragma once
+#include "world/Biome.h"
+#include "world/Erosion.h"
+#include "world/Noise.h"
+#include "world/WorldMap.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class ThreadPool;
+
+namespace world
+{
+    // Edge length in samples for WorldGenSettings::worldSize (0 = Tiny .. 4 = Vast)
+    int WorldResolution(int worldSize);
+
+    // Base elevation field of a world; the map preview samples the same field
+    NoiseParams ElevationParams(uint32_t seed);
+
+    // Climate and unrest layers. Their scales are power-of-two multiples of the
+    // elevation scale, so GenerateWorld's single PerlinFbm2DMulti pass shares
+    // most octave lattices between all four fields.
+    NoiseParams TemperatureParams(uint32_t seed);
+    NoiseParams MoistureParams(uint32_t seed);
+    NoiseParams VolatilityParams(uint32_t seed);
+
+    // Biome thresholds placed at fixed elevation quantiles, so every world has
+    // about the same share of ocean and mountains whatever its noise range
+    BiomeClimate WorldClimate(const std::vector<float>& elevation);
+
+    // Hydraulic erosion for a w x h world; the droplet budget grows with
+    // WorldGenSettings::worldVolatility (0 = Stable .. 4 = Chaotic)
+    ErosionParams WorldErosionParams(const WorldGenSettings& settings, uint32_t seed, int w, int h);
+
+    // Called with the stage being run and the share of the whole generation
+    // done (0..1), on the thread running GenerateWorld
+    using WorldGenProgress = std::function<void(const char* stage, float done)>;
+
+    // Runs every generation stage for a new world
+    WorldMap GenerateWorld(const WorldGenSettings& settings, uint32_t seed, ThreadPool& pool,
+        const WorldGenProgress& progress = {});
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "world/WorldGenSettings.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace world
+{
+    // Everything world generation produces, as kept in memory and in the
+    // world file (see WorldFile.h). Grid layers are width * height, row-major.
+    struct WorldMap
+    {
+        WorldGenSettings settings{};
+        uint32_t seed = 0;
+        int width = 0;
+        int height = 0;
+
+        std::vector<float> elevation;
+        std::vector<float> temperature;
+        std::vector<float> moisture;
+        std::vector<float> volatility;  // geological unrest
+        std::vector<uint8_t> biome;     // world::Biome values (see Biome.h)
+        std::vector<float> flow;        // upstream catchment in cells; rivers from cfg::RiverMinCatchment
+    };
+}